@@ -0,0 +1,114 @@
+//! Command lookup benchmark
+//!
+//! Registers 4096 commands (as many plugins would) and looks up console
+//! names, including mixed-case ones and engine commands that aren't ours,
+//! and chat words. Reports heap allocations per lookup through a counting
+//! global allocator.
+//!
+//! Run with: `cargo bench -p cs2rust-core --bench command_lookup`
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::hint::black_box;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+use criterion::{criterion_group, criterion_main, Criterion};
+
+use cs2rust_core::commands::{commands, register_command, CommandResult};
+
+/// Global allocator that counts allocations
+struct CountingAllocator;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAllocator = CountingAllocator;
+
+/// Registered commands
+const COMMAND_COUNT: usize = 4096;
+
+/// Console names looked up per round
+const CONSOLE_NAMES: &[&str] = &[
+    "csr_plugin2_cmd130",
+    "CSS_Plugin7_Cmd4071",
+    "csr_plugin0_cmd0",
+    "sv_cheats",
+    "status",
+    "mp_restartgame",
+    "changelevel",
+    "csr_missing",
+];
+
+/// Chat words looked up per round
+const CHAT_WORDS: &[&str] = &["plugin2_cmd130", "Plugin7_Cmd4071", "gg", "plugin0_cmd1"];
+
+fn register_commands() {
+    for i in 0..COMMAND_COUNT {
+        let prefix = if i % 2 == 0 { "csr" } else { "css" };
+        let name = format!("{}_plugin{}_cmd{}", prefix, i % 16, i);
+        register_command(&name, "Benchmark command", |_, _| CommandResult::Handled);
+    }
+}
+
+fn lookup_console() -> usize {
+    let manager = commands();
+    CONSOLE_NAMES
+        .iter()
+        .filter(|name| manager.find_by_name(black_box(name)).is_some())
+        .count()
+}
+
+fn lookup_chat() -> usize {
+    let manager = commands();
+    CHAT_WORDS
+        .iter()
+        .filter(|word| manager.find_chat_command(black_box(word)).is_some())
+        .count()
+}
+
+/// Count allocations made by one round, per lookup
+fn allocations_per_lookup(lookups: usize, f: impl Fn() -> usize) -> f64 {
+    f();
+    let before = ALLOCATIONS.load(Ordering::Relaxed);
+    black_box(f());
+    let after = ALLOCATIONS.load(Ordering::Relaxed);
+    (after - before) as f64 / lookups as f64
+}
+
+fn bench_command_lookup(c: &mut Criterion) {
+    register_commands();
+    assert_eq!(lookup_console(), 3);
+    assert_eq!(lookup_chat(), 2);
+
+    println!(
+        "command_lookup: allocations per console lookup: {:.3}",
+        allocations_per_lookup(CONSOLE_NAMES.len(), lookup_console)
+    );
+    println!(
+        "command_lookup: allocations per chat lookup: {:.3}",
+        allocations_per_lookup(CHAT_WORDS.len(), lookup_chat)
+    );
+
+    let mut group = c.benchmark_group("command_lookup");
+    group.bench_function("console_4096", |b| b.iter(lookup_console));
+    group.bench_function("chat_4096", |b| b.iter(lookup_chat));
+    group.finish();
+}
+
+criterion_group!(benches, bench_command_lookup);
+criterion_main!(benches);
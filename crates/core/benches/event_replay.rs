@@ -0,0 +1,157 @@
+//! Event replay benchmark
+//!
+//! Replays an event log through `EVENTS` with a typical set of handlers
+//! (a pre hook, a copying post hook, a snapshot hook, a lazy typed view and
+//! a batched subscriber) and reports dispatch throughput.
+//!
+//! Record a log on a server with `csr_event_record [file]` /
+//! `csr_event_record stop` and point `CS2RUST_EVENT_LOG` at it to measure
+//! real match traffic; otherwise a synthetic round of traffic is used.
+//!
+//! Run with: `cargo bench -p cs2rust-core --bench event_replay`
+
+use std::hint::black_box;
+use std::path::Path;
+
+use criterion::{criterion_group, criterion_main, Criterion};
+
+use cs2rust_core::events::record::{
+    load_event_log, read_event_log, EventLogWriter, RecordedEvent, RecordedValue,
+};
+use cs2rust_core::events::{
+    register_event, register_event_batched, register_event_snapshot, register_typed_event_view,
+    EventField, EventPlayerDeath, EventReplay, HookResult, EVENTS,
+};
+
+/// Events in the synthetic log
+const SYNTHETIC_EVENTS: u64 = 20_000;
+
+/// Replays per manual measurement
+const RUNS: u32 = 20;
+
+/// Synthetic traffic: mostly weapon_fire and player_hurt, some deaths
+fn synthetic_log() -> Vec<u8> {
+    let mut writer = EventLogWriter::new(Vec::new()).unwrap();
+    for i in 0..SYNTHETIC_EVENTS {
+        let userid = (i % 10) as i32;
+        let attacker = ((i + 3) % 10) as i32;
+        let (name, fields) = match i % 8 {
+            0..=3 => (
+                "weapon_fire",
+                vec![
+                    ("userid".to_string(), RecordedValue::Int(userid)),
+                    (
+                        "weapon".to_string(),
+                        RecordedValue::String("ak47".to_string()),
+                    ),
+                    ("silenced".to_string(), RecordedValue::Bool(false)),
+                ],
+            ),
+            4..=6 => (
+                "player_hurt",
+                vec![
+                    ("userid".to_string(), RecordedValue::Int(userid)),
+                    ("attacker".to_string(), RecordedValue::Int(attacker)),
+                    ("dmg_health".to_string(), RecordedValue::Int(27)),
+                    ("hitgroup".to_string(), RecordedValue::Int(2)),
+                    (
+                        "weapon".to_string(),
+                        RecordedValue::String("ak47".to_string()),
+                    ),
+                ],
+            ),
+            _ => (
+                "player_death",
+                vec![
+                    ("userid".to_string(), RecordedValue::Int(userid)),
+                    ("attacker".to_string(), RecordedValue::Int(attacker)),
+                    ("headshot".to_string(), RecordedValue::Bool(i % 3 == 0)),
+                    (
+                        "weapon".to_string(),
+                        RecordedValue::String("ak47".to_string()),
+                    ),
+                    ("distance".to_string(), RecordedValue::Float(12.5)),
+                ],
+            ),
+        };
+        let event = RecordedEvent {
+            tick: i / 4,
+            id: -1,
+            dont_broadcast: false,
+            name: name.to_string(),
+            fields,
+        };
+        writer.write_event(&event).unwrap();
+    }
+    writer.finish().unwrap()
+}
+
+fn register_handlers() {
+    register_event("weapon_fire", false, |event, _| {
+        black_box(event.get_int("userid", -1));
+        HookResult::Continue
+    });
+    register_event("player_death", true, |event, _| {
+        black_box(event.get_string("weapon", ""));
+        HookResult::Continue
+    });
+    register_event_snapshot(
+        "player_hurt",
+        &[EventField::int("attacker"), EventField::int("dmg_health")],
+        |event, _| {
+            black_box(event.get_int("dmg_health", 0));
+            HookResult::Continue
+        },
+    );
+    register_typed_event_view::<EventPlayerDeath, _>(false, |event, _| {
+        black_box(event.attacker());
+        HookResult::Continue
+    });
+    register_event_batched("weapon_fire", &[EventField::int("userid")], |batch| {
+        black_box(batch.iter().map(|e| e.get_int("userid", -1)).sum::<i32>());
+    });
+}
+
+fn bench_event_replay(c: &mut Criterion) {
+    let events = match std::env::var_os("CS2RUST_EVENT_LOG") {
+        Some(path) => load_event_log(Path::new(&path)).expect("failed to read CS2RUST_EVENT_LOG"),
+        None => {
+            let log = synthetic_log();
+            println!(
+                "event_replay: synthetic log, {:.1} bytes/event",
+                log.len() as f64 / SYNTHETIC_EVENTS as f64
+            );
+            read_event_log(log.as_slice()).unwrap()
+        }
+    };
+
+    register_handlers();
+    let mut replay = EventReplay::new(&events);
+
+    // Warm up the id cache and snapshot pool
+    replay.run(&EVENTS);
+
+    let mut total = std::time::Duration::ZERO;
+    let mut stats = replay.run(&EVENTS);
+    for _ in 0..RUNS {
+        stats = replay.run(&EVENTS);
+        total += stats.elapsed;
+    }
+    let ns_per_event = total.as_nanos() as f64 / (RUNS as f64 * stats.events.max(1) as f64);
+    println!(
+        "event_replay: {} events over {} ticks, {} blocked",
+        stats.events, stats.ticks, stats.blocked
+    );
+    println!(
+        "event_replay: {:.1} ns/event ({:.0} events/s)",
+        ns_per_event,
+        1e9 / ns_per_event
+    );
+
+    let mut group = c.benchmark_group("event_replay");
+    group.bench_function("replay", |b| b.iter(|| replay.run(&EVENTS)));
+    group.finish();
+}
+
+criterion_group!(benches, bench_event_replay);
+criterion_main!(benches);
@@ -0,0 +1,110 @@
+//! GameFrame overhead benchmark
+//!
+//! Measures one `rust_on_game_frame` body (`hooks::on_game_frame` plus
+//! `listeners::fire_tick`) with no callbacks registered, under each tracing
+//! setting:
+//!
+//! - `no_subscriber` - nobody listening
+//! - `subscriber` - a subscriber that enables every callsite
+//! - `subscriber_span` - the same, plus the per-tick span that
+//!   `#[instrument]` used to create
+//! - `profiler_off` - no subscriber, profiler recording disabled at runtime
+//!
+//! Compile-time ceilings are measured by rebuilding with a feature:
+//!
+//! ```text
+//! cargo bench -p cs2rust-core --bench game_frame
+//! cargo bench -p cs2rust-core --bench game_frame --features max_level_off
+//! cargo bench -p cs2rust-core --bench game_frame --no-default-features
+//! ```
+
+use std::hint::black_box;
+use std::time::Instant;
+
+use criterion::{criterion_group, criterion_main, Criterion};
+use tracing::span::{Attributes, Id, Record};
+use tracing::{Event, Metadata, Subscriber};
+
+use cs2rust_core::{hooks, listeners, profiler};
+
+/// Frames per manual measurement
+const FRAMES: u32 = 1_000_000;
+
+/// Subscriber that enables everything and discards it
+struct AlwaysOn;
+
+impl Subscriber for AlwaysOn {
+    fn enabled(&self, _: &Metadata<'_>) -> bool {
+        true
+    }
+    fn new_span(&self, _: &Attributes<'_>) -> Id {
+        Id::from_u64(1)
+    }
+    fn record(&self, _: &Id, _: &Record<'_>) {}
+    fn record_follows_from(&self, _: &Id, _: &Id) {}
+    fn event(&self, event: &Event<'_>) {
+        black_box(event);
+    }
+    fn enter(&self, _: &Id) {}
+    fn exit(&self, _: &Id) {}
+}
+
+/// One `rust_on_game_frame` body
+fn frame() {
+    hooks::on_game_frame(true, true, true);
+    listeners::fire_tick();
+}
+
+/// `rust_on_game_frame` as it was with `#[instrument(skip_all)]`
+fn frame_with_span() {
+    let _span = tracing::info_span!("rust_on_game_frame").entered();
+    frame();
+}
+
+/// Average nanoseconds per call of `f`
+fn ns_per_frame(f: fn()) -> f64 {
+    let start = Instant::now();
+    for _ in 0..FRAMES {
+        f();
+    }
+    start.elapsed().as_nanos() as f64 / FRAMES as f64
+}
+
+fn bench_game_frame(c: &mut Criterion) {
+    let dispatch = tracing::Dispatch::new(AlwaysOn);
+
+    // Warm up lazy statics
+    ns_per_frame(frame);
+
+    println!(
+        "game_frame: {:.1} ns/frame (no_subscriber)",
+        ns_per_frame(frame)
+    );
+    tracing::dispatcher::with_default(&dispatch, || {
+        println!("game_frame: {:.1} ns/frame (subscriber)", ns_per_frame(frame));
+        println!(
+            "game_frame: {:.1} ns/frame (subscriber_span)",
+            ns_per_frame(frame_with_span)
+        );
+    });
+    profiler::set_enabled(false);
+    println!(
+        "game_frame: {:.1} ns/frame (profiler_off)",
+        ns_per_frame(frame)
+    );
+    profiler::set_enabled(true);
+
+    let mut group = c.benchmark_group("game_frame");
+    group.bench_function("no_subscriber", |b| b.iter(frame));
+    tracing::dispatcher::with_default(&dispatch, || {
+        group.bench_function("subscriber", |b| b.iter(frame));
+        group.bench_function("subscriber_span", |b| b.iter(frame_with_span));
+    });
+    profiler::set_enabled(false);
+    group.bench_function("profiler_off", |b| b.iter(frame));
+    profiler::set_enabled(true);
+    group.finish();
+}
+
+criterion_group!(benches, bench_game_frame);
+criterion_main!(benches);
@@ -0,0 +1,111 @@
+//! Message template benchmark
+//!
+//! Renders and prints a colored per-player message to 64 recipients, once
+//! with `format!` + `CString::new` per recipient and once through a
+//! compiled [`MessageTemplate`], and reports heap allocations per message
+//! through a counting global allocator.
+//!
+//! `ClientPrint` isn't resolved outside the game, so the print itself is
+//! the fallback path; the numbers cover everything up to the engine call.
+//!
+//! Run with: `cargo bench -p cs2rust-core --bench message_template`
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::ffi::{c_void, CString};
+use std::hint::black_box;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+use criterion::{criterion_group, criterion_main, Criterion};
+
+use cs2rust_core::commands::print::{client_print_c, HudDestination};
+use cs2rust_core::commands::{intern_template, MessageTemplate};
+
+/// Global allocator that counts allocations
+struct CountingAllocator;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAllocator = CountingAllocator;
+
+/// Recipients per round (a full server)
+const RECIPIENTS: usize = 64;
+
+/// Stand-in controller pointer (never dereferenced)
+const PLAYER: *mut c_void = 0x1000 as *mut c_void;
+
+const TEMPLATE: &str = "{green}[Server]{default} Welcome back, {blue}{name}{default}! \
+                        You have {kills} kills this map.";
+
+fn names() -> Vec<String> {
+    (0..RECIPIENTS).map(|i| format!("player_{i:02}")).collect()
+}
+
+/// `format!` + `CString::new` per recipient
+fn print_formatted(names: &[String]) {
+    for (kills, name) in names.iter().enumerate() {
+        let message = format!(
+            "\x04[Server]\x01 Welcome back, \x0B{}\x01! You have {} kills this map.",
+            name, kills
+        );
+        let c_msg = CString::new(message).unwrap();
+        unsafe { client_print_c(PLAYER, HudDestination::Talk, black_box(&c_msg)) };
+    }
+}
+
+/// Compiled template rendered into the thread-local buffer
+fn print_template(template: &MessageTemplate, names: &[String]) {
+    for (kills, name) in names.iter().enumerate() {
+        unsafe { template.print_to(PLAYER, HudDestination::Talk, &[name, &kills]) };
+    }
+}
+
+/// Count allocations made by one round, per message
+fn allocations_per_message(f: impl Fn()) -> f64 {
+    // Warm up buffers and lazy statics so one-time setup is not counted
+    f();
+    let before = ALLOCATIONS.load(Ordering::Relaxed);
+    f();
+    let after = ALLOCATIONS.load(Ordering::Relaxed);
+    (after - before) as f64 / RECIPIENTS as f64
+}
+
+fn bench_message_template(c: &mut Criterion) {
+    let names = names();
+    let template = intern_template(TEMPLATE, &["name", "kills"]).unwrap();
+
+    println!(
+        "message_template: allocations per message (format! + CString): {:.3}",
+        allocations_per_message(|| print_formatted(&names))
+    );
+    println!(
+        "message_template: allocations per message (template): {:.3}",
+        allocations_per_message(|| print_template(&template, &names))
+    );
+
+    let mut group = c.benchmark_group("message_template");
+    group.bench_function("format_cstring_64", |b| b.iter(|| print_formatted(&names)));
+    group.bench_function("template_64", |b| {
+        b.iter(|| print_template(&template, &names))
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_message_template);
+criterion_main!(benches);
@@ -0,0 +1,33 @@
+//! Profiler overhead benchmark
+//!
+//! Measures the cost of timing one callback through a `ProfileScope`,
+//! compared with calling it directly.
+//!
+//! Run with: `cargo bench -p cs2rust-core --bench profiler`
+
+use std::hint::black_box;
+
+use criterion::{criterion_group, criterion_main, Criterion};
+
+use cs2rust_core::profiler::{ProfileHandle, ProfileKind};
+
+fn callback(value: u64) -> u64 {
+    black_box(value.wrapping_mul(31))
+}
+
+fn bench_profiler(c: &mut Criterion) {
+    let handle = ProfileHandle::new(ProfileKind::GameFrame, "bench_callback");
+
+    let mut group = c.benchmark_group("profiler");
+    group.bench_function("callback_unprofiled", |b| b.iter(|| callback(black_box(7))));
+    group.bench_function("callback_profiled", |b| {
+        b.iter(|| {
+            let _scope = handle.scope();
+            callback(black_box(7))
+        })
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_profiler);
+criterion_main!(benches);
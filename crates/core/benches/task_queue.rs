@@ -0,0 +1,95 @@
+//! Task queue round-trip benchmark
+//!
+//! Measures `queue_task` + `process_queued_tasks` round trips and reports
+//! heap allocations per task through a counting global allocator.
+//!
+//! Run with: `cargo bench -p cs2rust-core --bench task_queue`
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::hint::black_box;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+
+use criterion::{criterion_group, criterion_main, Criterion};
+
+use cs2rust_core::tasks::{process_queued_tasks, queue_task};
+
+/// Global allocator that counts allocations
+struct CountingAllocator;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAllocator = CountingAllocator;
+
+/// Number of round trips per measured iteration
+const ROUND_TRIPS: usize = 1_000_000;
+
+static SINK: AtomicU64 = AtomicU64::new(0);
+
+/// Queue and drain ROUND_TRIPS small tasks (24-byte capture, stored inline)
+fn round_trips_small() {
+    for i in 0..ROUND_TRIPS as u64 {
+        let (a, b, c) = (i, i ^ 0x55, i.wrapping_mul(3));
+        let _ = queue_task(move || {
+            SINK.fetch_add(a ^ b ^ c, Ordering::Relaxed);
+        });
+        black_box(process_queued_tasks());
+    }
+}
+
+/// Queue and drain ROUND_TRIPS large tasks (128-byte capture, boxed fallback)
+fn round_trips_large() {
+    for i in 0..ROUND_TRIPS as u64 {
+        let payload = [i; 16];
+        let _ = queue_task(move || {
+            SINK.fetch_add(payload[0] ^ payload[15], Ordering::Relaxed);
+        });
+        black_box(process_queued_tasks());
+    }
+}
+
+/// Count allocations made by one run of `f`, per task
+fn allocations_per_task(f: fn()) -> f64 {
+    // Warm up lazy statics so one-time setup is not counted
+    f();
+    let before = ALLOCATIONS.load(Ordering::Relaxed);
+    f();
+    let after = ALLOCATIONS.load(Ordering::Relaxed);
+    (after - before) as f64 / ROUND_TRIPS as f64
+}
+
+fn bench_task_queue(c: &mut Criterion) {
+    println!(
+        "task_queue: allocations per task (inline, 24-byte capture): {:.3}",
+        allocations_per_task(round_trips_small)
+    );
+    println!(
+        "task_queue: allocations per task (boxed, 128-byte capture): {:.3}",
+        allocations_per_task(round_trips_large)
+    );
+
+    let mut group = c.benchmark_group("task_queue");
+    group.sample_size(10);
+    group.bench_function("1m_round_trips_inline", |b| b.iter(round_trips_small));
+    group.bench_function("1m_round_trips_boxed", |b| b.iter(round_trips_large));
+    group.finish();
+}
+
+criterion_group!(benches, bench_task_queue);
+criterion_main!(benches);
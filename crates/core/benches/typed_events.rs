@@ -0,0 +1,190 @@
+//! Typed event decoding benchmark
+//!
+//! Decodes `player_death` from a mock `IGameEvent` three ways:
+//!
+//! - `string_keys` - the `&str` getters, one `CString` per key (how
+//!   `from_raw` used to be written by hand)
+//! - `derived` - `#[derive(GameEvent)]`, keys built at compile time
+//! - `view_one_field` - the generated lazy view, reading only `attacker`
+//!
+//! Run with: `cargo bench -p cs2rust-core --bench typed_events`
+
+use std::ffi::{c_char, c_void, CStr};
+use std::hint::black_box;
+use std::time::Instant;
+
+use criterion::{criterion_group, criterion_main, Criterion};
+
+use cs2rust_core::events::{EventPlayerDeath, GameEvent, GameEventRef, LazyGameEvent};
+use cs2rust_sdk::IGameEvent;
+
+/// Decodes per manual measurement
+const ITERATIONS: u32 = 1_000_000;
+
+/// Values stored on the mock event
+enum Value {
+    Bool(bool),
+    Int(i32),
+    Float(f32),
+    String(&'static CStr),
+}
+
+/// Fake `player_death` event laid out like an engine `IGameEvent`
+#[repr(C)]
+struct MockEvent {
+    vtable: *const *const c_void,
+    fields: &'static [(&'static CStr, Value)],
+}
+
+static FIELDS: [(&CStr, Value); 12] = [
+    (c"userid", Value::Int(4)),
+    (c"attacker", Value::Int(7)),
+    (c"assister", Value::Int(-1)),
+    (c"headshot", Value::Bool(true)),
+    (c"weapon", Value::String(c"ak47")),
+    (c"attackerblind", Value::Bool(false)),
+    (c"distance", Value::Float(18.5)),
+    (c"noscope", Value::Bool(false)),
+    (c"thrusmoke", Value::Bool(false)),
+    (c"penetrated", Value::Int(1)),
+    (c"dominated", Value::Int(0)),
+    (c"revenge", Value::Int(0)),
+];
+
+fn lookup(this: *mut MockEvent, key: *const c_char) -> Option<&'static Value> {
+    let key = unsafe { CStr::from_ptr(key) };
+    unsafe { (*this).fields }
+        .iter()
+        .find(|(k, _)| *k == key)
+        .map(|(_, v)| v)
+}
+
+extern "C" fn unsupported() {
+    panic!("mock IGameEvent method not implemented");
+}
+
+extern "C" fn get_name(_: *mut MockEvent) -> *const c_char {
+    c"player_death".as_ptr()
+}
+
+extern "C" fn get_id(_: *mut MockEvent) -> i32 {
+    1
+}
+
+extern "C" fn get_bool(this: *mut MockEvent, key: *const c_char, default: bool) -> bool {
+    match lookup(this, key) {
+        Some(Value::Bool(v)) => *v,
+        _ => default,
+    }
+}
+
+extern "C" fn get_int(this: *mut MockEvent, key: *const c_char, default: i32) -> i32 {
+    match lookup(this, key) {
+        Some(Value::Int(v)) => *v,
+        _ => default,
+    }
+}
+
+extern "C" fn get_uint64(_: *mut MockEvent, _: *const c_char, default: u64) -> u64 {
+    default
+}
+
+extern "C" fn get_float(this: *mut MockEvent, key: *const c_char, default: f32) -> f32 {
+    match lookup(this, key) {
+        Some(Value::Float(v)) => *v,
+        _ => default,
+    }
+}
+
+extern "C" fn get_string(
+    this: *mut MockEvent,
+    key: *const c_char,
+    default: *const c_char,
+) -> *const c_char {
+    match lookup(this, key) {
+        Some(Value::String(v)) => v.as_ptr(),
+        _ => default,
+    }
+}
+
+fn vtable() -> [*const c_void; 32] {
+    let mut slots = [unsupported as *const c_void; 32];
+    slots[1] = get_name as *const c_void;
+    slots[2] = get_id as *const c_void;
+    slots[6] = get_bool as *const c_void;
+    slots[7] = get_int as *const c_void;
+    slots[8] = get_uint64 as *const c_void;
+    slots[9] = get_float as *const c_void;
+    slots[10] = get_string as *const c_void;
+    slots
+}
+
+/// `player_death` decoded through the `&str` getters
+fn decode_string_keys(event: &GameEventRef) -> EventPlayerDeath {
+    EventPlayerDeath {
+        userid: event.get_int("userid", -1),
+        attacker: event.get_int("attacker", -1),
+        assister: event.get_int("assister", -1),
+        headshot: event.get_bool("headshot", false),
+        weapon: event.get_string("weapon", ""),
+        attackerblind: event.get_bool("attackerblind", false),
+        distance: event.get_float("distance", 0.0),
+        noscope: event.get_bool("noscope", false),
+        thrusmoke: event.get_bool("thrusmoke", false),
+        penetrated: event.get_int("penetrated", 0),
+        dominated: event.get_int("dominated", 0),
+        revenge: event.get_int("revenge", 0),
+    }
+}
+
+/// What a kill tracker reads: the attacker only
+fn view_attacker(event: &GameEventRef) -> i32 {
+    EventPlayerDeath::view(event).attacker()
+}
+
+/// Average nanoseconds per call of `f`
+fn ns_per_decode<T>(event: &GameEventRef, f: fn(&GameEventRef) -> T) -> f64 {
+    let start = Instant::now();
+    for _ in 0..ITERATIONS {
+        black_box(f(black_box(event)));
+    }
+    start.elapsed().as_nanos() as f64 / ITERATIONS as f64
+}
+
+fn bench_typed_events(c: &mut Criterion) {
+    let vtable = vtable();
+    let mut mock = MockEvent {
+        vtable: vtable.as_ptr(),
+        fields: &FIELDS,
+    };
+    let event =
+        unsafe { GameEventRef::from_ptr(&mut mock as *mut MockEvent as *mut IGameEvent) }.unwrap();
+
+    assert_eq!(
+        format!("{:?}", decode_string_keys(&event)),
+        format!("{:?}", EventPlayerDeath::from_raw(&event))
+    );
+
+    ns_per_decode(&event, decode_string_keys);
+    println!(
+        "typed_events: {:.1} ns/decode (string_keys)",
+        ns_per_decode(&event, decode_string_keys)
+    );
+    println!(
+        "typed_events: {:.1} ns/decode (derived)",
+        ns_per_decode(&event, EventPlayerDeath::from_raw)
+    );
+    println!(
+        "typed_events: {:.1} ns/decode (view_one_field)",
+        ns_per_decode(&event, view_attacker)
+    );
+
+    let mut group = c.benchmark_group("typed_events");
+    group.bench_function("string_keys", |b| b.iter(|| decode_string_keys(&event)));
+    group.bench_function("derived", |b| b.iter(|| EventPlayerDeath::from_raw(&event)));
+    group.bench_function("view_one_field", |b| b.iter(|| view_attacker(&event)));
+    group.finish();
+}
+
+criterion_group!(benches, bench_typed_events);
+criterion_main!(benches);
@@ -0,0 +1,267 @@
+//! Async command handlers
+//!
+//! A handler registered with [`register_async_command`] returns a future
+//! instead of a [`CommandResult`]. The dispatcher copies the invocation into
+//! an [`AsyncCommandInfo`] and spawns the future on the frame executor
+//! ([`tasks::spawn`](crate::tasks::spawn)), so slow work (reading a file,
+//! loading a ban list, scanning entities over several ticks) never holds up
+//! the engine's dispatch.
+//!
+//! Replies are queued as main thread tasks and only delivered if the caller
+//! is still in their slot, so replying late, or from a background thread,
+//! is safe. An invocation made under [`capture_replies`] (such as
+//! `csr_capture`) keeps the capture stream, and every later reply of its
+//! task is written there.
+//!
+//! [`capture_replies`]: super::capture_replies
+//!
+//! ```ignore
+//! use cs2rust_core::commands::register_async_command;
+//! use cs2rust_core::tasks::run_blocking;
+//!
+//! register_async_command("csr_reloadbans", "Reload the ban list", |info| async move {
+//!     match run_blocking(|| std::fs::read_to_string("bans.txt")).await {
+//!         Ok(Ok(text)) => info.reply(&format!("Loaded {} bans", text.lines().count())),
+//!         Ok(Err(e)) => info.reply(&format!("Could not read bans: {e}")),
+//!         Err(e) => info.reply(&format!("Ban reload failed: {e}")),
+//!     }
+//! });
+//! ```
+
+use std::future::Future;
+
+use super::info::{send_reply, CommandContext, CommandInfo, CommandResult};
+use super::manager::{register_command, register_command_ex, register_server_command, CommandKey};
+use super::stream::{captured, ReplyStream};
+use crate::entities::{cached_player_controller, PlayerController};
+use crate::tasks;
+
+/// An owned copy of a command invocation, for async handlers
+///
+/// Unlike [`CommandInfo`] it doesn't borrow the engine's command buffer and
+/// can be sent to other threads.
+#[derive(Debug, Clone)]
+pub struct AsyncCommandInfo {
+    /// Arguments (index 0 is the command name)
+    args: Box<[Box<str>]>,
+    /// Full command string including command name
+    raw_string: Box<str>,
+    context: CommandContext,
+    /// Player slot (-1 for server console)
+    player_slot: i32,
+    /// Caller's SteamID64, to tell them apart from a later occupant of the slot
+    steam_id: u64,
+    /// Capture active when the command was dispatched (kept open until the
+    /// last copy of this info is dropped)
+    capture: Option<ReplyStream>,
+}
+
+impl AsyncCommandInfo {
+    pub(crate) fn new(info: &CommandInfo) -> Self {
+        Self {
+            args: info.args().map(Box::from).collect(),
+            raw_string: info.get_command_string().into(),
+            context: info.context(),
+            player_slot: info.player_slot(),
+            steam_id: info.player().map_or(0, |p| p.steam_id()),
+            capture: captured(),
+        }
+    }
+
+    /// Get the number of arguments (including command name at index 0)
+    pub fn arg_count(&self) -> usize {
+        self.args.len()
+    }
+
+    /// Get argument by index (0 = command name)
+    pub fn arg(&self, index: usize) -> &str {
+        self.args.get(index).map_or("", |arg| arg)
+    }
+
+    /// Get the command name
+    pub fn command_name(&self) -> &str {
+        self.arg(0)
+    }
+
+    /// Get all arguments after the command name as a single string
+    pub fn arg_string(&self) -> String {
+        self.args.get(1..).unwrap_or_default().join(" ")
+    }
+
+    /// Iterate over the arguments (including the command name)
+    pub fn args(&self) -> impl ExactSizeIterator<Item = &str> {
+        self.args.iter().map(|arg| &**arg)
+    }
+
+    /// Get the full command string
+    pub fn get_command_string(&self) -> &str {
+        &self.raw_string
+    }
+
+    /// Get the calling context
+    pub fn context(&self) -> CommandContext {
+        self.context
+    }
+
+    /// Get player slot (-1 for server console)
+    pub fn player_slot(&self) -> i32 {
+        self.player_slot
+    }
+
+    /// Get the calling player, if they're still connected
+    ///
+    /// Main thread only. Returns `None` for the server console, or once the
+    /// caller has left (even if someone else took the slot).
+    pub fn player(&self) -> Option<PlayerController> {
+        caller(self.player_slot, self.steam_id)
+    }
+
+    /// Reply to the command (auto-routes to console or chat based on context)
+    ///
+    /// Queued for the main thread, so this can be called from any thread.
+    /// Dropped if the caller has left by then. Written straight to the
+    /// capture stream if the invocation was captured.
+    pub fn reply(&self, message: &str) {
+        if let Some(capture) = &self.capture {
+            capture.line(message);
+            return;
+        }
+        let (context, slot, steam_id) = (self.context, self.player_slot, self.steam_id);
+        let message: Box<str> = message.into();
+        let _ = tasks::queue_task(move || {
+            let player = caller(slot, steam_id);
+            if player.is_none() && context != CommandContext::ServerConsole {
+                tracing::trace!("Dropping reply to slot {} (player left)", slot);
+                return;
+            }
+            send_reply(context, player.as_ref(), &message);
+        });
+    }
+
+    /// Reply with formatted message
+    pub fn reply_fmt(&self, args: std::fmt::Arguments<'_>) {
+        self.reply(&args.to_string());
+    }
+
+    /// Open a stream for a long reply (see [`CommandInfo::reply_stream`])
+    pub fn reply_stream(&self) -> ReplyStream {
+        if let Some(capture) = &self.capture {
+            return capture.clone();
+        }
+        ReplyStream::caller(self.context, self.player_slot, self.steam_id)
+    }
+}
+
+/// The slot's controller, if it still belongs to `steam_id`
+pub(super) fn caller(slot: i32, steam_id: u64) -> Option<PlayerController> {
+    cached_player_controller(slot).filter(|p| p.is_connected() && p.steam_id() == steam_id)
+}
+
+/// Register a command whose handler runs as an async task
+///
+/// The handler is called during dispatch only to create its future, which
+/// is then polled from the GameFrame hook (first on the next frame). The
+/// command counts as handled as soon as the task is spawned. Rate limits
+/// and the `csr_`/`css_` chat prefixes work as for [`register_command`].
+///
+/// # Arguments
+/// * `name` - Command name (should include prefix, e.g., "csr_reloadbans")
+/// * `description` - Help text for the command
+/// * `handler` - Creates the task for an invocation
+pub fn register_async_command<F, Fut>(
+    name: &str,
+    description: &str,
+    handler: F,
+) -> Option<CommandKey>
+where
+    F: Fn(AsyncCommandInfo) -> Fut + Send + Sync + 'static,
+    Fut: Future<Output = ()> + Send + 'static,
+{
+    register_command(name, description, spawn_handler(handler))
+}
+
+/// Register an async command with extended options
+///
+/// Like [`register_async_command`], with an optional required permission
+/// checked before the task is spawned (see
+/// [`register_command_ex`](super::register_command_ex)).
+///
+/// # Example
+/// ```ignore
+/// register_async_command_ex("css_banlist", "Show the ban list", Some("@css/ban"), |info| async move {
+///     info.reply("...");
+/// });
+/// ```
+pub fn register_async_command_ex<F, Fut>(
+    name: &str,
+    description: &str,
+    permission: Option<&str>,
+    handler: F,
+) -> Option<CommandKey>
+where
+    F: Fn(AsyncCommandInfo) -> Fut + Send + Sync + 'static,
+    Fut: Future<Output = ()> + Send + 'static,
+{
+    register_command_ex(name, description, permission, spawn_handler(handler))
+}
+
+/// Register an async command that only the server console can run
+///
+/// See [`register_server_command`](super::register_server_command).
+pub fn register_async_server_command<F, Fut>(
+    name: &str,
+    description: &str,
+    handler: F,
+) -> Option<CommandKey>
+where
+    F: Fn(AsyncCommandInfo) -> Fut + Send + Sync + 'static,
+    Fut: Future<Output = ()> + Send + 'static,
+{
+    register_server_command(name, description, spawn_handler(handler))
+}
+
+/// Command callback that spawns `handler`'s task for each invocation
+fn spawn_handler<F, Fut>(
+    handler: F,
+) -> impl Fn(Option<&PlayerController>, &CommandInfo) -> CommandResult + Send + Sync + 'static
+where
+    F: Fn(AsyncCommandInfo) -> Fut + Send + Sync + 'static,
+    Fut: Future<Output = ()> + Send + 'static,
+{
+    move |_, info| {
+        tasks::spawn(handler(AsyncCommandInfo::new(info)));
+        CommandResult::Handled
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_async_command_info() {
+        let args = ["csr_kick", "bob", "afk"];
+        let info = CommandInfo::new(
+            &args,
+            "csr_kick bob afk",
+            None,
+            CommandContext::ServerConsole,
+            -1,
+        );
+
+        let owned = AsyncCommandInfo::new(&info);
+        assert_eq!(owned.arg_count(), 3);
+        assert_eq!(owned.command_name(), "csr_kick");
+        assert_eq!(owned.arg(2), "afk");
+        assert_eq!(owned.arg(3), "");
+        assert_eq!(owned.arg_string(), "bob afk");
+        assert_eq!(owned.args().collect::<Vec<_>>(), args);
+        assert_eq!(owned.get_command_string(), "csr_kick bob afk");
+        assert_eq!(owned.context(), CommandContext::ServerConsole);
+        assert!(owned.player().is_none());
+
+        // Outlives the borrowed arguments and can cross threads
+        let moved = std::thread::spawn(move || owned.arg(1).to_string());
+        assert_eq!(moved.join().unwrap(), "bob");
+    }
+}
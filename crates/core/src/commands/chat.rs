@@ -9,10 +9,9 @@ use std::sync::OnceLock;
 use parking_lot::RwLock;
 
 use super::manager::{dispatch_chat_command, COMMANDS};
-use crate::entities::PlayerController;
+use crate::entities::resolve_player_controller;
 use crate::gamedata::find_signature;
 use crate::hooks::{inline, HookError, InlineHookKey};
-use crate::schema::SchemaObject;
 
 /// Default public chat trigger
 pub const DEFAULT_PUBLIC_TRIGGER: char = '!';
@@ -107,12 +106,9 @@ fn check_chat_trigger(message: &str) -> Option<(bool, &str)> {
     }
 }
 
-/// Parse a chat command into name and arguments
-fn parse_chat_command(text: &str) -> (String, Vec<String>) {
-    let parts: Vec<&str> = text.split_whitespace().collect();
-    let command_name = parts.first().map(|s| s.to_lowercase()).unwrap_or_default();
-    let args: Vec<String> = parts.iter().map(|s| s.to_string()).collect();
-    (command_name, args)
+/// Split a chat command into its words (index 0 is the command name)
+fn parse_chat_command(text: &str) -> Vec<&str> {
+    text.split_whitespace().collect()
 }
 
 /// Our detour for Host_Say
@@ -143,60 +139,38 @@ unsafe extern "C" fn host_say_detour(
         }
     };
 
-    // Parse command
-    let (command_name, command_args) = parse_chat_command(command_text);
+    // Look the command up on the borrowed message, nothing is allocated
+    // until it's known to be a command
+    let command_key = command_text
+        .split_whitespace()
+        .next()
+        .and_then(|word| COMMANDS.read().find_chat_command(word));
 
-    if command_name.is_empty() {
-        // Just a trigger character with no command
+    let Some(command_key) = command_key else {
+        // Not a registered command (or just a trigger character)
         original(controller, args, team_only, unk1, unk2);
         return;
-    }
-
-    // Check if command exists
-    let command_exists = {
-        let manager = COMMANDS.read();
-        manager.find_by_short_name(&command_name).is_some()
-            || manager
-                .find_by_name(&format!("csr_{}", command_name))
-                .is_some()
-            || manager
-                .find_by_name(&format!("css_{}", command_name))
-                .is_some()
     };
 
-    if !command_exists {
-        // Not a registered command, let the message through
-        original(controller, args, team_only, unk1, unk2);
-        return;
-    }
+    let command_args = parse_chat_command(command_text);
 
     // If not silent, call original first to show message in chat
     if !is_silent {
         original(controller, args, team_only, unk1, unk2);
     }
 
-    // Get player controller from entity
-    let player = if !controller.is_null() {
-        PlayerController::from_ptr(controller)
-    } else {
-        None
-    };
-
-    // Get player slot (TODO: implement proper slot lookup)
-    let player_slot = 0; // Placeholder
-
-    // Dispatch the command
-    if let Some(player) = player {
+    // Resolve the controller and its slot once, through the slot table
+    if let Some((player, player_slot)) = resolve_player_controller(controller) {
         let result = dispatch_chat_command(
-            &command_name,
-            command_args,
-            command_text.to_string(),
+            command_key,
+            &command_args,
+            command_text,
             player,
             player_slot,
             is_silent,
         );
 
-        tracing::trace!("Chat command '{}' result: {:?}", command_name, result);
+        tracing::trace!("Chat command '{}' result: {:?}", command_args[0], result);
     }
 }
 
@@ -279,12 +253,10 @@ mod tests {
 
     #[test]
     fn test_parse_chat_command() {
-        let (name, args) = parse_chat_command("ping");
-        assert_eq!(name, "ping");
-        assert_eq!(args, vec!["ping"]);
-
-        let (name, args) = parse_chat_command("slap player1 100");
-        assert_eq!(name, "slap");
-        assert_eq!(args, vec!["slap", "player1", "100"]);
+        assert_eq!(parse_chat_command("ping"), vec!["ping"]);
+        assert_eq!(
+            parse_chat_command("slap  player1 100 "),
+            vec!["slap", "player1", "100"]
+        );
     }
 }
@@ -0,0 +1,190 @@
+//! Lock-free command name filter
+//!
+//! Every console command the engine dispatches goes through our
+//! `DispatchConCommand` hook, and almost none of them are ours. The filter
+//! holds the [`name_hash`](super::table::name_hash) of every registered
+//! command name in an open-addressed table of atomics, so the hook can
+//! reject foreign commands from `arg(0)` alone, without taking the command
+//! manager's lock. A hit (ours, or a rare 64-bit hash collision) goes on to
+//! the exact lookup in the manager, which reuses the hash.
+
+use std::sync::atomic::{fence, AtomicBool, AtomicU64, AtomicUsize, Ordering};
+
+/// Table size (64 KiB)
+const SLOTS: usize = 8192;
+const MASK: usize = SLOTS - 1;
+
+/// Used slots (names and removed names) before the table is rebuilt
+const MAX_USED: usize = SLOTS / 2;
+
+const EMPTY: u64 = 0;
+const REMOVED: u64 = 1;
+
+/// Stored form of a hash (0 and 1 mark free slots)
+fn stored(hash: u64) -> u64 {
+    hash.max(2)
+}
+
+/// Set of command name hashes
+///
+/// Readers only load atomics. Writers ([`insert`], [`remove`],
+/// [`rebuild`]) must not run concurrently with each other; they're called
+/// with the command manager's write lock held. A removed hash leaves a
+/// marker so later probes still pass it. A rebuild bumps the generation
+/// to an odd number while it runs, and readers that overlap it pass the
+/// name, so a registered name is never rejected.
+///
+/// With more than [`MAX_USED`] names every name passes.
+///
+/// [`insert`]: Self::insert
+/// [`remove`]: Self::remove
+/// [`rebuild`]: Self::rebuild
+pub(crate) struct NameFilter {
+    slots: [AtomicU64; SLOTS],
+    /// Odd while a rebuild runs
+    generation: AtomicU64,
+    /// Slots not empty (writers only)
+    used: AtomicUsize,
+    /// Too many names to hold: everything passes
+    overflowed: AtomicBool,
+}
+
+impl NameFilter {
+    pub(crate) const fn new() -> Self {
+        Self {
+            slots: [const { AtomicU64::new(EMPTY) }; SLOTS],
+            generation: AtomicU64::new(0),
+            used: AtomicUsize::new(0),
+            overflowed: AtomicBool::new(false),
+        }
+    }
+
+    /// Add a hash (false if the table is full and needs a rebuild)
+    pub(crate) fn insert(&self, hash: u64) -> bool {
+        let value = stored(hash);
+        let mut reuse = None;
+        for i in 0..SLOTS {
+            let index = (hash as usize + i) & MASK;
+            match self.slots[index].load(Ordering::Relaxed) {
+                v if v == value => return true,
+                REMOVED => {
+                    reuse.get_or_insert(index);
+                }
+                EMPTY => {
+                    let index = match reuse {
+                        Some(index) => index,
+                        None => {
+                            let used = self.used.load(Ordering::Relaxed);
+                            if used >= MAX_USED {
+                                return false;
+                            }
+                            self.used.store(used + 1, Ordering::Relaxed);
+                            index
+                        }
+                    };
+                    self.slots[index].store(value, Ordering::Release);
+                    return true;
+                }
+                _ => {}
+            }
+        }
+        false
+    }
+
+    /// Remove a hash
+    pub(crate) fn remove(&self, hash: u64) {
+        let value = stored(hash);
+        for i in 0..SLOTS {
+            let slot = &self.slots[(hash as usize + i) & MASK];
+            match slot.load(Ordering::Relaxed) {
+                v if v == value => return slot.store(REMOVED, Ordering::Release),
+                EMPTY => return,
+                _ => {}
+            }
+        }
+    }
+
+    /// Replace the contents with exactly `hashes`
+    pub(crate) fn rebuild(&self, hashes: impl IntoIterator<Item = u64>) {
+        let generation = self.generation.load(Ordering::Relaxed);
+        self.generation.store(generation + 1, Ordering::Relaxed);
+        fence(Ordering::Release);
+
+        for slot in &self.slots {
+            slot.store(EMPTY, Ordering::Relaxed);
+        }
+        self.used.store(0, Ordering::Relaxed);
+        let overflowed = !hashes.into_iter().all(|hash| self.insert(hash));
+        self.overflowed.store(overflowed, Ordering::Release);
+
+        self.generation.store(generation + 2, Ordering::Release);
+        if overflowed {
+            tracing::debug!("Command filter full, passing every command to the manager");
+        }
+    }
+
+    /// Check if a hash may have been added (`false` means it definitely wasn't)
+    pub(crate) fn might_contain(&self, hash: u64) -> bool {
+        let generation = self.generation.load(Ordering::Acquire);
+        if generation % 2 == 1 || self.overflowed.load(Ordering::Acquire) {
+            return true;
+        }
+
+        let value = stored(hash);
+        for i in 0..SLOTS {
+            match self.slots[(hash as usize + i) & MASK].load(Ordering::Acquire) {
+                v if v == value => return true,
+                EMPTY => break,
+                _ => {}
+            }
+        }
+
+        // A miss only counts if no rebuild ran meanwhile
+        fence(Ordering::Acquire);
+        self.generation.load(Ordering::Relaxed) != generation
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::super::table::name_hash;
+    use super::*;
+
+    #[test]
+    fn test_name_filter() {
+        let filter = NameFilter::new();
+        let hash = |name: &str| name_hash(name.as_bytes());
+        assert!(!filter.might_contain(hash("csr_ping")));
+
+        assert!(filter.insert(hash("csr_ping")));
+        assert!(filter.insert(hash("css_slap")));
+        assert!(filter.might_contain(hash("csr_ping")));
+        assert!(filter.might_contain(hash("CSR_Ping")));
+        assert!(filter.might_contain(hash("css_slap")));
+
+        let foreign = [
+            "status",
+            "say",
+            "sv_cheats",
+            "mp_restartgame",
+            "changelevel",
+        ];
+        assert!(!foreign.iter().any(|name| filter.might_contain(hash(name))));
+
+        // Removed names leave a marker the other names probe past
+        filter.remove(hash("csr_ping"));
+        assert!(!filter.might_contain(hash("csr_ping")));
+        assert!(filter.might_contain(hash("css_slap")));
+
+        filter.rebuild([hash("csr_ping")]);
+        assert!(filter.might_contain(hash("csr_ping")));
+        assert!(!filter.might_contain(hash("css_slap")));
+
+        // Past capacity every name passes
+        filter.rebuild([]);
+        assert!((0..MAX_USED as u64).all(|i| filter.insert(hash(&format!("csr_{i}")))));
+        assert!(!filter.insert(hash("csr_extra")));
+        filter.rebuild((0..=MAX_USED as u64).map(|i| hash(&format!("csr_{i}"))));
+        assert!(filter.might_contain(hash("status")));
+    }
+}
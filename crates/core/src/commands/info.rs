@@ -1,5 +1,8 @@
 //! Command information types
 
+use std::ffi::{c_char, CStr};
+
+use super::stream::ReplyStream;
 use crate::entities::PlayerController;
 
 /// Context from which a command was called
@@ -50,13 +53,88 @@ impl Default for CommandResult {
     }
 }
 
+/// Where a command's arguments live
+///
+/// Both variants borrow from the caller, so building a [`CommandInfo`]
+/// copies nothing.
+#[derive(Clone, Copy)]
+pub(crate) enum CommandArgs<'a> {
+    /// argv pointers of an engine `CCommand` (NUL-terminated strings)
+    Argv(&'a [*const c_char]),
+    /// Tokens already split by the caller (chat messages, tests)
+    Words(&'a [&'a str]),
+}
+
+impl<'a> CommandArgs<'a> {
+    /// Borrow the argv pointers of an engine command, up to the first null
+    ///
+    /// # Safety
+    /// The pointers must be valid NUL-terminated strings for `'a`.
+    pub(crate) unsafe fn argv(argv: &'a [*const c_char]) -> Self {
+        let count = argv.iter().position(|p| p.is_null()).unwrap_or(argv.len());
+        Self::Argv(&argv[..count])
+    }
+
+    fn len(&self) -> usize {
+        match self {
+            Self::Argv(argv) => argv.len(),
+            Self::Words(words) => words.len(),
+        }
+    }
+
+    fn get(&self, index: usize) -> Option<&'a str> {
+        match *self {
+            // SAFETY: checked non-null by `argv`, valid for 'a
+            Self::Argv(argv) => argv
+                .get(index)
+                .map(|&ptr| unsafe { CStr::from_ptr(ptr) }.to_str().unwrap_or("")),
+            Self::Words(words) => words.get(index).copied(),
+        }
+    }
+}
+
+/// Iterator over a command's arguments (see [`CommandInfo::args`])
+#[derive(Clone)]
+pub struct Args<'a> {
+    args: CommandArgs<'a>,
+    index: usize,
+}
+
+impl<'a> Iterator for Args<'a> {
+    type Item = &'a str;
+
+    fn next(&mut self) -> Option<&'a str> {
+        let arg = self.args.get(self.index)?;
+        self.index += 1;
+        Some(arg)
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        let remaining = self.args.len().saturating_sub(self.index);
+        (remaining, Some(remaining))
+    }
+}
+
+impl ExactSizeIterator for Args<'_> {}
+
+impl std::fmt::Debug for Args<'_> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_list().entries(self.clone()).finish()
+    }
+}
+
 /// Information about a command invocation
-pub struct CommandInfo {
+///
+/// Arguments and the command string are borrowed from the caller (the
+/// engine's `CCommand` or the chat message) for the duration of the
+/// callback. Use [`to_owned_args`](Self::to_owned_args) or `to_string` to
+/// keep them longer.
+pub struct CommandInfo<'a> {
     /// Raw command arguments (index 0 is the command name)
-    args: Vec<String>,
+    args: CommandArgs<'a>,
 
     /// Full command string including command name
-    raw_string: String,
+    raw_string: &'a str,
 
     /// Player who executed command (None if server console)
     player: Option<PlayerController>,
@@ -68,11 +146,27 @@ pub struct CommandInfo {
     player_slot: i32,
 }
 
-impl CommandInfo {
+impl<'a> CommandInfo<'a> {
     /// Create new CommandInfo
     pub fn new(
-        args: Vec<String>,
-        raw_string: String,
+        args: &'a [&'a str],
+        raw_string: &'a str,
+        player: Option<PlayerController>,
+        context: CommandContext,
+        player_slot: i32,
+    ) -> Self {
+        Self::from_args(
+            CommandArgs::Words(args),
+            raw_string,
+            player,
+            context,
+            player_slot,
+        )
+    }
+
+    pub(crate) fn from_args(
+        args: CommandArgs<'a>,
+        raw_string: &'a str,
         player: Option<PlayerController>,
         context: CommandContext,
         player_slot: i32,
@@ -94,35 +188,41 @@ impl CommandInfo {
     /// Get argument by index (0 = command name)
     ///
     /// Returns empty string if index is out of bounds.
-    pub fn arg(&self, index: usize) -> &str {
-        self.args.get(index).map(|s| s.as_str()).unwrap_or("")
+    pub fn arg(&self, index: usize) -> &'a str {
+        self.args.get(index).unwrap_or("")
     }
 
     /// Get the command name (alias for arg(0))
-    pub fn command_name(&self) -> &str {
+    pub fn command_name(&self) -> &'a str {
         self.arg(0)
     }
 
     /// Get all arguments after command name as a single string
     pub fn arg_string(&self) -> String {
-        if self.args.len() > 1 {
-            self.args[1..].join(" ")
-        } else {
-            String::new()
+        self.args().skip(1).collect::<Vec<_>>().join(" ")
+    }
+
+    /// Iterate over all arguments (including the command name)
+    pub fn args(&self) -> Args<'a> {
+        Args {
+            args: self.args,
+            index: 0,
         }
     }
 
-    /// Get all arguments as a slice
-    pub fn args(&self) -> &[String] {
-        &self.args
+    /// Copy all arguments (including the command name)
+    pub fn to_owned_args(&self) -> Vec<String> {
+        self.args().map(str::to_string).collect()
     }
 
     /// Get the full raw command string
-    pub fn get_command_string(&self) -> &str {
-        &self.raw_string
+    pub fn get_command_string(&self) -> &'a str {
+        self.raw_string
     }
 
     /// Get the player who executed the command (None for server console)
+    ///
+    /// Resolved and validated once by the dispatcher, no lookup needed.
     pub fn player(&self) -> Option<&PlayerController> {
         self.player.as_ref()
     }
@@ -141,40 +241,52 @@ impl CommandInfo {
     ///
     /// Uses ClientPrint when available, falls back to logging otherwise.
     pub fn reply(&self, message: &str) {
-        use super::print::{self, HudDestination};
-
-        match self.context {
-            CommandContext::ServerConsole => {
-                // Print to server console
-                tracing::info!("[Server] {}", message);
-            }
-            CommandContext::ClientConsole => {
-                if let Some(ref player) = self.player {
-                    // Send to player's console
-                    unsafe {
-                        print::client_print(player.as_ptr(), HudDestination::Console, message);
-                    }
-                } else {
-                    tracing::info!("[Reply] {}", message);
-                }
-            }
-            CommandContext::ChatPublic | CommandContext::ChatSilent => {
-                if let Some(ref player) = self.player {
-                    // Send to player's chat
-                    unsafe {
-                        print::client_print(player.as_ptr(), HudDestination::Talk, message);
-                    }
-                } else {
-                    tracing::info!("[Reply] {}", message);
-                }
-            }
-        }
+        send_reply(self.context, self.player.as_ref(), message);
     }
 
     /// Reply with formatted message
     pub fn reply_fmt(&self, args: std::fmt::Arguments<'_>) {
         self.reply(&args.to_string());
     }
+
+    /// Open a stream for a long reply
+    ///
+    /// Lines written to the stream reach the caller a few per frame (see
+    /// [`ReplyStream`]), so a large dump doesn't stall the tick. Inside
+    /// [`capture_replies`](super::capture_replies) this is the capture stream.
+    pub fn reply_stream(&self) -> ReplyStream {
+        let steam_id = self.player.as_ref().map_or(0, |p| p.steam_id());
+        ReplyStream::caller(self.context, self.player_slot, steam_id)
+    }
+}
+
+/// Route a reply by context: server log, the player's console or chat
+pub(crate) fn send_reply(
+    context: CommandContext,
+    player: Option<&PlayerController>,
+    message: &str,
+) {
+    use super::print::{self, HudDestination};
+
+    if super::stream::capture_reply(message) {
+        return;
+    }
+
+    let dest = match context {
+        CommandContext::ServerConsole => {
+            // Print to server console
+            tracing::info!("[Server] {}", message);
+            return;
+        }
+        CommandContext::ClientConsole => HudDestination::Console,
+        CommandContext::ChatPublic | CommandContext::ChatSilent => HudDestination::Talk,
+    };
+
+    match player {
+        // Send to player's console or chat
+        Some(player) => unsafe { print::client_print(player.as_ptr(), dest, message) },
+        None => tracing::info!("[Reply] {}", message),
+    }
 }
 
 /// Type alias for command callback functions
@@ -202,12 +314,8 @@ mod tests {
     #[test]
     fn test_command_info() {
         let info = CommandInfo::new(
-            vec![
-                "csr_test".to_string(),
-                "arg1".to_string(),
-                "arg2".to_string(),
-            ],
-            "csr_test arg1 arg2".to_string(),
+            &["csr_test", "arg1", "arg2"],
+            "csr_test arg1 arg2",
             None,
             CommandContext::ServerConsole,
             -1,
@@ -222,5 +330,31 @@ mod tests {
         assert_eq!(info.arg_string(), "arg1 arg2");
         assert_eq!(info.player_slot(), -1);
         assert!(info.player().is_none());
+        assert_eq!(info.args().len(), 3);
+        assert_eq!(info.to_owned_args(), vec!["csr_test", "arg1", "arg2"]);
+    }
+
+    #[test]
+    fn test_command_info_argv() {
+        let argv = [
+            c"css_kick".as_ptr(),
+            c"bot".as_ptr(),
+            std::ptr::null(),
+            c"stale".as_ptr(),
+        ];
+        let args = unsafe { CommandArgs::argv(&argv) };
+        let info = CommandInfo::from_args(
+            args,
+            "css_kick bot",
+            None,
+            CommandContext::ServerConsole,
+            -1,
+        );
+
+        assert_eq!(info.arg_count(), 2);
+        assert_eq!(info.command_name(), "css_kick");
+        assert_eq!(info.arg(1), "bot");
+        assert_eq!(info.arg(2), "");
+        assert_eq!(format!("{:?}", info.args()), r#"["css_kick", "bot"]"#);
     }
 }
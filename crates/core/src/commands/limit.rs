@@ -0,0 +1,278 @@
+//! Per-player command rate limiting
+//!
+//! Each player slot gets a token bucket: a command invocation takes one
+//! token, and tokens refill at a steady rate up to a burst size. Buckets
+//! live in a fixed array indexed by slot, so checking one costs no hashing
+//! or allocation. There is one global limiter, checked for every command a
+//! player runs, and each command can add its own (see
+//! [`register_command_with_rate_limit`](super::register_command_with_rate_limit)).
+//!
+//! A command's buckets are all checked before a token is taken from any of
+//! them, so an invocation rejected by the command's own limit doesn't use
+//! up the global one. The first rejection in a slot is answered with a
+//! message kept ready; further rejections stay silent until that bucket
+//! has a token again, so a flood costs one bucket check per message and
+//! at most one print per refill. The server console is never limited.
+
+use std::sync::{Arc, LazyLock};
+use std::time::{Duration, Instant};
+
+use parking_lot::{Mutex, RwLock};
+
+use crate::entities::MAX_PLAYERS;
+
+/// Default reply to rate-limited invocations
+pub const DEFAULT_RATE_LIMIT_MESSAGE: &str = "You're sending commands too quickly, slow down.";
+
+/// Token bucket parameters
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct RateLimit {
+    /// Invocations allowed back to back
+    pub burst: u32,
+    /// Tokens regained per second
+    pub per_second: f32,
+}
+
+impl RateLimit {
+    /// Allow `burst` invocations at once, refilling `per_second`
+    pub const fn new(burst: u32, per_second: f32) -> Self {
+        Self { burst, per_second }
+    }
+
+    /// One invocation per `cooldown`
+    pub fn cooldown(cooldown: Duration) -> Self {
+        Self {
+            burst: 1,
+            per_second: 1.0 / cooldown.as_secs_f32().max(f32::EPSILON),
+        }
+    }
+}
+
+/// Global limit applied until [`set_command_rate_limit`] changes it
+pub const DEFAULT_RATE_LIMIT: RateLimit = RateLimit::new(8, 2.0);
+
+/// One slot's bucket
+#[derive(Debug, Clone, Copy)]
+struct Bucket {
+    tokens: f32,
+    /// Last refill (`None` = full, never used)
+    refilled: Option<Instant>,
+    /// The player was told about a rejection since the last token
+    notified: bool,
+}
+
+impl Bucket {
+    const FULL: Self = Self {
+        tokens: 0.0,
+        refilled: None,
+        notified: false,
+    };
+
+    /// Add the tokens regained since the last refill
+    fn refill(&mut self, limit: RateLimit, now: Instant) {
+        let burst = limit.burst as f32;
+        self.tokens = match self.refilled {
+            Some(last) => {
+                let regained = now.saturating_duration_since(last).as_secs_f32() * limit.per_second;
+                (self.tokens + regained).min(burst)
+            }
+            None => burst,
+        };
+        self.refilled = Some(now);
+        if self.tokens >= 1.0 {
+            self.notified = false;
+        }
+    }
+
+    /// Record a rejection, returning whether the player should be told
+    fn reject(&mut self) -> bool {
+        !std::mem::replace(&mut self.notified, true)
+    }
+}
+
+/// Outcome of [`acquire`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) enum RateCheck {
+    /// A token was taken from every bucket
+    Allowed,
+    /// No token was taken; `notify` is set for the first rejection since
+    /// the rejecting bucket last had a token
+    Rejected { notify: bool },
+}
+
+/// Token buckets for every player slot
+#[derive(Debug)]
+pub(crate) struct SlotLimiter {
+    limit: RateLimit,
+    buckets: Mutex<[Bucket; MAX_PLAYERS]>,
+}
+
+impl SlotLimiter {
+    pub(crate) fn new(limit: RateLimit) -> Self {
+        Self {
+            limit,
+            buckets: Mutex::new([Bucket::FULL; MAX_PLAYERS]),
+        }
+    }
+
+    /// Forget a slot's history (its player left)
+    pub(crate) fn reset(&self, slot: i32) {
+        if let Some(bucket) = self.buckets.lock().get_mut(slot as usize) {
+            *bucket = Bucket::FULL;
+        }
+    }
+}
+
+/// Take a token for `slot` from both limiters, or from neither
+///
+/// Slots outside the player range always pass. Locks `first` before
+/// `second`, so callers pass the global limiter first.
+pub(crate) fn acquire(
+    first: Option<&SlotLimiter>,
+    second: Option<&SlotLimiter>,
+    slot: i32,
+    now: Instant,
+) -> RateCheck {
+    if slot < 0 || slot as usize >= MAX_PLAYERS {
+        return RateCheck::Allowed;
+    }
+    let slot = slot as usize;
+    let mut first = first.map(|limiter| (limiter.limit, limiter.buckets.lock()));
+    let mut second = second.map(|limiter| (limiter.limit, limiter.buckets.lock()));
+    let mut buckets = [first.as_mut(), second.as_mut()]
+        .map(|entry| entry.map(|(limit, buckets)| (*limit, &mut buckets[slot])));
+
+    for (limit, bucket) in buckets.iter_mut().flatten() {
+        bucket.refill(*limit, now);
+    }
+    if let Some((_, bucket)) = buckets
+        .iter_mut()
+        .flatten()
+        .find(|(_, bucket)| bucket.tokens < 1.0)
+    {
+        return RateCheck::Rejected {
+            notify: bucket.reject(),
+        };
+    }
+    for (_, bucket) in buckets.iter_mut().flatten() {
+        bucket.tokens -= 1.0;
+    }
+    RateCheck::Allowed
+}
+
+/// Global limiter (`None` = no global limit)
+static GLOBAL_LIMITER: LazyLock<RwLock<Option<Arc<SlotLimiter>>>> =
+    LazyLock::new(|| RwLock::new(Some(Arc::new(SlotLimiter::new(DEFAULT_RATE_LIMIT)))));
+
+/// Reply sent to rate-limited players
+static RATE_LIMIT_MESSAGE: LazyLock<RwLock<Arc<str>>> =
+    LazyLock::new(|| RwLock::new(Arc::from(DEFAULT_RATE_LIMIT_MESSAGE)));
+
+/// Get the global limiter
+pub(crate) fn global_limiter() -> Option<Arc<SlotLimiter>> {
+    GLOBAL_LIMITER.read().clone()
+}
+
+/// Set the rate limit applied to every command players run
+///
+/// `None` disables the global limit; per-command limits still apply.
+/// Buckets start full again after a change.
+pub fn set_command_rate_limit(limit: Option<RateLimit>) {
+    *GLOBAL_LIMITER.write() = limit.map(|limit| Arc::new(SlotLimiter::new(limit)));
+}
+
+/// Set the reply sent to players who hit a rate limit
+pub fn set_rate_limit_message(message: &str) {
+    *RATE_LIMIT_MESSAGE.write() = Arc::from(message);
+}
+
+/// Get the reply sent to rate-limited players
+pub(crate) fn rate_limit_message() -> Arc<str> {
+    RATE_LIMIT_MESSAGE.read().clone()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    impl SlotLimiter {
+        fn try_acquire(&self, slot: i32, now: Instant) -> bool {
+            acquire(Some(self), None, slot, now) == RateCheck::Allowed
+        }
+    }
+
+    #[test]
+    fn test_token_bucket() {
+        let limiter = SlotLimiter::new(RateLimit::new(3, 2.0));
+        let start = Instant::now();
+
+        // Burst, then rejected
+        for _ in 0..3 {
+            assert!(limiter.try_acquire(5, start));
+        }
+        assert!(!limiter.try_acquire(5, start));
+
+        // Other slots and the console are independent
+        assert!(limiter.try_acquire(6, start));
+        assert!(limiter.try_acquire(-1, start));
+        assert!(limiter.try_acquire(MAX_PLAYERS as i32, start));
+
+        // Two tokens per second
+        let later = start + Duration::from_millis(500);
+        assert!(limiter.try_acquire(5, later));
+        assert!(!limiter.try_acquire(5, later));
+
+        // Refill is capped at the burst size
+        let much_later = start + Duration::from_secs(60);
+        for _ in 0..3 {
+            assert!(limiter.try_acquire(5, much_later));
+        }
+        assert!(!limiter.try_acquire(5, much_later));
+
+        limiter.reset(5);
+        assert!(limiter.try_acquire(5, much_later));
+    }
+
+    #[test]
+    fn test_cooldown() {
+        let limiter = SlotLimiter::new(RateLimit::cooldown(Duration::from_secs(5)));
+        let start = Instant::now();
+
+        assert!(limiter.try_acquire(0, start));
+        assert!(!limiter.try_acquire(0, start + Duration::from_secs(4)));
+        assert!(limiter.try_acquire(0, start + Duration::from_secs(10)));
+    }
+
+    #[test]
+    fn test_rejection_takes_no_token() {
+        let global = SlotLimiter::new(RateLimit::new(2, 1.0));
+        let command = SlotLimiter::new(RateLimit::cooldown(Duration::from_secs(10)));
+        let start = Instant::now();
+
+        assert_eq!(
+            acquire(Some(&global), Some(&command), 3, start),
+            RateCheck::Allowed
+        );
+
+        // The command's cooldown rejects without using the global token,
+        // and only the first rejection is reported
+        assert_eq!(
+            acquire(Some(&global), Some(&command), 3, start),
+            RateCheck::Rejected { notify: true }
+        );
+        assert_eq!(
+            acquire(Some(&global), Some(&command), 3, start),
+            RateCheck::Rejected { notify: false }
+        );
+        assert!(global.try_acquire(3, start));
+        assert!(!global.try_acquire(3, start));
+
+        // Reported again once the bucket had a token
+        let later = start + Duration::from_secs(10);
+        assert_eq!(acquire(None, Some(&command), 3, later), RateCheck::Allowed);
+        assert_eq!(
+            acquire(None, Some(&command), 3, later),
+            RateCheck::Rejected { notify: true }
+        );
+    }
+}
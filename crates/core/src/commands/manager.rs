@@ -1,13 +1,25 @@
 //! Command manager - registration and dispatch
+//!
+//! The registered commands are published as an immutable snapshot.
+//! Registration copies the current manager (entries are shared), changes
+//! the copy and swaps it in. Dispatch clones the snapshot's `Arc` and runs
+//! handlers without holding any lock, so a handler can register,
+//! unregister or dispatch other commands.
 
-use std::collections::HashMap;
-use std::sync::LazyLock;
+use std::sync::{Arc, LazyLock};
+use std::time::Instant;
 
 use parking_lot::RwLock;
 use slotmap::{new_key_type, SlotMap};
 
-use super::info::{CommandCallback, CommandContext, CommandInfo, CommandResult};
+use super::filter::NameFilter;
+use super::info::{CommandArgs, CommandCallback, CommandContext, CommandInfo, CommandResult};
+use super::limit::{
+    acquire, global_limiter, rate_limit_message, RateCheck, RateLimit, SlotLimiter,
+};
+use super::table::{name_hash, names_match, NameKind, NameTable};
 use crate::entities::PlayerController;
+use crate::profiler::{ProfileHandle, ProfileKind};
 
 new_key_type! {
     /// Handle for a registered command
@@ -20,12 +32,25 @@ pub const DEFAULT_PREFIX: &str = "csr_";
 /// CounterStrikeSharp compatibility prefix
 pub const CSS_PREFIX: &str = "css_";
 
+/// Strip a `csr_` or `css_` prefix (any case), leaving the chat name
+fn chat_name(name: &str) -> Option<&str> {
+    [DEFAULT_PREFIX, CSS_PREFIX].iter().find_map(|prefix| {
+        let head = name.get(..prefix.len())?;
+        let short = &name[prefix.len()..];
+        (head.eq_ignore_ascii_case(prefix) && !short.is_empty()).then_some(short)
+    })
+}
+
 /// Registered command information
 struct CommandEntry {
     /// Full command name (e.g., "csr_ping")
     name: String,
     /// Short name without prefix (e.g., "ping")
     short_name: String,
+    /// [`name_hash`] of the full name
+    name_hash: u64,
+    /// [`name_hash`] of the short name, if the name has a chat prefix
+    chat_hash: Option<u64>,
     /// Command description
     description: String,
     /// Callback function
@@ -34,26 +59,29 @@ struct CommandEntry {
     server_only: bool,
     /// Required permission (e.g., "@css/ban")
     required_permission: Option<String>,
+    /// Per-player limit on top of the global one
+    limiter: Option<SlotLimiter>,
+    /// Profile entry for the callback
+    profile: ProfileHandle,
 }
 
 /// Global command manager
+#[derive(Clone)]
 pub struct CommandManager {
-    /// Commands indexed by key
-    commands: SlotMap<CommandKey, CommandEntry>,
+    /// Commands indexed by key (shared with older snapshots, which keeps
+    /// their rate limit state)
+    commands: SlotMap<CommandKey, Arc<CommandEntry>>,
 
-    /// Lookup by full command name (case-insensitive, lowercase)
-    by_name: HashMap<String, CommandKey>,
-
-    /// Lookup by short name for chat commands (case-insensitive, lowercase)
-    by_short_name: HashMap<String, CommandKey>,
+    /// Full names (console) and short names (chat), case-insensitive,
+    /// all added on registration
+    names: NameTable,
 }
 
 impl CommandManager {
     fn new() -> Self {
         Self {
             commands: SlotMap::with_key(),
-            by_name: HashMap::new(),
-            by_short_name: HashMap::new(),
+            names: NameTable::new(),
         }
     }
 
@@ -64,42 +92,44 @@ impl CommandManager {
         description: &str,
         server_only: bool,
         required_permission: Option<String>,
+        rate_limit: Option<RateLimit>,
         callback: CommandCallback,
     ) -> Option<CommandKey> {
-        let name_lower = name.to_lowercase();
+        let hash = name_hash(name.as_bytes());
 
         // Check if already registered
-        if self.by_name.contains_key(&name_lower) {
+        if self.find_by_hash(hash, name).is_some() {
             tracing::warn!("Command '{}' already registered", name);
             return None;
         }
 
-        // Extract short name (remove prefix if present)
-        let short_name = if name_lower.starts_with(DEFAULT_PREFIX) {
-            name_lower[DEFAULT_PREFIX.len()..].to_string()
-        } else if name_lower.starts_with(CSS_PREFIX) {
-            // Support CSS prefix for compatibility
-            name_lower[CSS_PREFIX.len()..].to_string()
-        } else {
-            // No known prefix, use full name as short name
-            name_lower.clone()
-        };
+        // Commands without a known prefix get no chat name
+        let short_name = chat_name(name);
 
         let entry = CommandEntry {
             name: name.to_string(),
-            short_name: short_name.clone(),
+            short_name: short_name.unwrap_or(name).to_string(),
+            name_hash: hash,
+            chat_hash: short_name.map(|short| name_hash(short.as_bytes())),
             description: description.to_string(),
             callback,
             server_only,
             required_permission,
+            limiter: rate_limit.map(SlotLimiter::new),
+            profile: ProfileHandle::new(ProfileKind::Command, name),
         };
 
-        let key = self.commands.insert(entry);
-        self.by_name.insert(name_lower, key);
+        let chat_hash = entry.chat_hash;
+        let key = self.commands.insert(Arc::new(entry));
+        self.names.insert(hash, NameKind::Console, key);
 
-        // Only register short name if it's different from the full name
-        if short_name != name.to_lowercase() {
-            self.by_short_name.insert(short_name, key);
+        if let (Some(short_name), Some(chat_hash)) = (short_name, chat_hash) {
+            // The newest command takes over a shared short name
+            // (css_ping over csr_ping)
+            if let Some(previous) = self.find_by_short_name(short_name) {
+                self.names.remove(chat_hash, NameKind::Chat, previous);
+            }
+            self.names.insert(chat_hash, NameKind::Chat, key);
         }
 
         tracing::debug!("Registered command: {}", name);
@@ -108,36 +138,123 @@ impl CommandManager {
 
     /// Unregister a command by key
     fn unregister(&mut self, key: CommandKey) -> bool {
-        if let Some(entry) = self.commands.remove(key) {
-            self.by_name.remove(&entry.name.to_lowercase());
-            self.by_short_name.remove(&entry.short_name);
-            tracing::debug!("Unregistered command: {}", entry.name);
-            true
-        } else {
-            false
+        let Some(entry) = self.commands.remove(key) else {
+            return false;
+        };
+        self.names.remove(entry.name_hash, NameKind::Console, key);
+
+        if let Some(chat_hash) = entry.chat_hash {
+            // Hand a shared short name back to the other prefix's command
+            if self.names.remove(chat_hash, NameKind::Chat, key) {
+                let fallback = [DEFAULT_PREFIX, CSS_PREFIX].iter().find_map(|prefix| {
+                    self.find_by_name(&format!("{}{}", prefix, entry.short_name))
+                });
+                if let Some(fallback) = fallback {
+                    self.names.insert(chat_hash, NameKind::Chat, fallback);
+                }
+            }
         }
+
+        tracing::debug!("Unregistered command: {}", entry.name);
+        true
     }
 
     /// Find command by full name
     pub fn find_by_name(&self, name: &str) -> Option<CommandKey> {
-        self.by_name.get(&name.to_lowercase()).copied()
+        self.find_by_hash(name_hash(name.as_bytes()), name)
+    }
+
+    /// Find command by full name, given its [`name_hash`]
+    pub(crate) fn find_by_hash(&self, hash: u64, name: &str) -> Option<CommandKey> {
+        self.names.find(hash, NameKind::Console, |key| {
+            names_match(&self.commands[key].name, name)
+        })
     }
 
     /// Find command by short name (for chat commands)
     pub fn find_by_short_name(&self, name: &str) -> Option<CommandKey> {
-        self.by_short_name.get(&name.to_lowercase()).copied()
+        self.names
+            .find(name_hash(name.as_bytes()), NameKind::Chat, |key| {
+                names_match(&self.commands[key].short_name, name)
+            })
+    }
+
+    /// Find the command a chat word (`ping` in `!ping`) refers to
+    ///
+    /// Hashes the borrowed word, so words that aren't commands cost no
+    /// allocation.
+    pub fn find_chat_command(&self, word: &str) -> Option<CommandKey> {
+        self.find_by_short_name(word)
+    }
+
+    /// Check if any command's full name has this [`name_hash`]
+    fn has_name_hash(&self, hash: u64) -> bool {
+        self.names.contains_hash(hash, NameKind::Console)
+    }
+
+    /// [`name_hash`] of every command's full name
+    fn name_hashes(&self) -> impl Iterator<Item = u64> + '_ {
+        self.commands.values().map(|entry| entry.name_hash)
+    }
+
+    /// Forget a player slot's rate limit history (its player left)
+    pub(crate) fn reset_rate_limits(&self, slot: i32) {
+        if let Some(limiter) = global_limiter() {
+            limiter.reset(slot);
+        }
+        for entry in self.commands.values() {
+            if let Some(limiter) = &entry.limiter {
+                limiter.reset(slot);
+            }
+        }
+    }
+
+    /// Take a token from the global limiter and the command's own
+    fn within_rate_limit(entry: &CommandEntry, slot: i32) -> RateCheck {
+        let global = global_limiter();
+        acquire(
+            global.as_deref(),
+            entry.limiter.as_ref(),
+            slot,
+            Instant::now(),
+        )
     }
 
     /// Execute a command by key
-    fn execute(
+    pub(crate) fn execute(
         &self,
         key: CommandKey,
         player: Option<&PlayerController>,
         info: &CommandInfo,
     ) -> CommandResult {
         if let Some(entry) = self.commands.get(key) {
+            let from_server = info.context() == CommandContext::ServerConsole;
+
+            // Client commands only run for a resolved controller, so every
+            // check below sees the player who sent them
+            if !from_server && player.is_none() {
+                tracing::debug!(
+                    "Ignoring '{}' from slot {} without a controller",
+                    entry.name,
+                    info.player_slot()
+                );
+                return CommandResult::Handled;
+            }
+
+            // Rate limit players before any other work
+            if !from_server {
+                let slot = info.player_slot();
+                if let RateCheck::Rejected { notify } = Self::within_rate_limit(entry, slot) {
+                    tracing::trace!("Rate limited '{}' for slot {}", entry.name, slot);
+                    if notify {
+                        info.reply(&rate_limit_message());
+                    }
+                    return CommandResult::Handled;
+                }
+            }
+
             // Check server-only restriction
-            if entry.server_only && player.is_some() {
+            if entry.server_only && !from_server {
                 info.reply("This command can only be executed from the server console.");
                 return CommandResult::Handled;
             }
@@ -156,6 +273,7 @@ impl CommandManager {
                 }
             }
 
+            let _scope = entry.profile.scope();
             (entry.callback)(player, info)
         } else {
             CommandResult::Continue
@@ -190,9 +308,55 @@ impl CommandManager {
     }
 }
 
-/// Global command manager instance
-pub static COMMANDS: LazyLock<RwLock<CommandManager>> =
-    LazyLock::new(|| RwLock::new(CommandManager::new()));
+/// Global command manager instance (the current snapshot)
+///
+/// Use [`commands`] to hold on to a snapshot; a read guard on this lock
+/// blocks registration while it is held.
+pub static COMMANDS: LazyLock<RwLock<Arc<CommandManager>>> =
+    LazyLock::new(|| RwLock::new(Arc::new(CommandManager::new())));
+
+/// The current command snapshot
+///
+/// Keys found in it can be executed and looked up in later snapshots;
+/// unregistered keys just find nothing.
+pub fn commands() -> Arc<CommandManager> {
+    COMMANDS.read().clone()
+}
+
+/// Hashes of the names in [`COMMANDS`], checked without its lock
+pub(crate) static COMMAND_FILTER: NameFilter = NameFilter::new();
+
+/// Register a command in [`COMMANDS`] and [`COMMAND_FILTER`]
+fn register_global(
+    name: &str,
+    description: &str,
+    server_only: bool,
+    required_permission: Option<String>,
+    rate_limit: Option<RateLimit>,
+    callback: CommandCallback,
+) -> Option<CommandKey> {
+    let mut current = COMMANDS.write();
+    let mut manager = CommandManager::clone(&current);
+    let key = manager.register(
+        name,
+        description,
+        server_only,
+        required_permission,
+        rate_limit,
+        callback,
+    )?;
+    if !COMMAND_FILTER.insert(manager.commands[key].name_hash) {
+        COMMAND_FILTER.rebuild(manager.name_hashes());
+    }
+    *current = Arc::new(manager);
+    Some(key)
+}
+
+/// Profile entries for console and chat dispatch
+static CONSOLE_DISPATCH_PROFILE: LazyLock<ProfileHandle> =
+    LazyLock::new(|| ProfileHandle::new(ProfileKind::Core, "dispatch_console_command"));
+static CHAT_DISPATCH_PROFILE: LazyLock<ProfileHandle> =
+    LazyLock::new(|| ProfileHandle::new(ProfileKind::Core, "dispatch_chat_command"));
 
 /// Register a command with the default prefix (csr_)
 ///
@@ -217,9 +381,7 @@ pub fn register_command<F>(name: &str, description: &str, callback: F) -> Option
 where
     F: Fn(Option<&PlayerController>, &CommandInfo) -> CommandResult + Send + Sync + 'static,
 {
-    COMMANDS
-        .write()
-        .register(name, description, false, None, Box::new(callback))
+    register_global(name, description, false, None, None, Box::new(callback))
 }
 
 /// Register a command with extended options
@@ -256,11 +418,50 @@ pub fn register_command_ex<F>(
 where
     F: Fn(Option<&PlayerController>, &CommandInfo) -> CommandResult + Send + Sync + 'static,
 {
-    COMMANDS.write().register(
+    register_global(
+        name,
+        description,
+        false,
+        permission.map(|s| s.to_string()),
+        None,
+        Box::new(callback),
+    )
+}
+
+/// Register a command with its own per-player rate limit
+///
+/// Like [`register_command_ex`], with `rate_limit` applied on top of the
+/// global limit (see [`set_command_rate_limit`](super::set_command_rate_limit)).
+/// Called by the `#[console_command]` macro when a cooldown is specified.
+///
+/// # Example
+/// ```ignore
+/// use cs2rust_core::commands::{register_command_with_rate_limit, CommandResult, RateLimit};
+///
+/// let key = register_command_with_rate_limit(
+///     "csr_rtv",
+///     "Rock the vote",
+///     None,
+///     RateLimit::cooldown(Duration::from_secs(2)),
+///     |player, info| CommandResult::Handled,
+/// );
+/// ```
+pub fn register_command_with_rate_limit<F>(
+    name: &str,
+    description: &str,
+    permission: Option<&str>,
+    rate_limit: RateLimit,
+    callback: F,
+) -> Option<CommandKey>
+where
+    F: Fn(Option<&PlayerController>, &CommandInfo) -> CommandResult + Send + Sync + 'static,
+{
+    register_global(
         name,
         description,
         false,
         permission.map(|s| s.to_string()),
+        Some(rate_limit),
         Box::new(callback),
     )
 }
@@ -273,51 +474,59 @@ pub fn register_server_command<F>(name: &str, description: &str, callback: F) ->
 where
     F: Fn(Option<&PlayerController>, &CommandInfo) -> CommandResult + Send + Sync + 'static,
 {
-    COMMANDS
-        .write()
-        .register(name, description, true, None, Box::new(callback))
+    register_global(name, description, true, None, None, Box::new(callback))
 }
 
 /// Unregister a command
 pub fn unregister_command(key: CommandKey) -> bool {
-    COMMANDS.write().unregister(key)
+    let mut current = COMMANDS.write();
+    let Some(hash) = current.commands.get(key).map(|entry| entry.name_hash) else {
+        return false;
+    };
+    let mut manager = CommandManager::clone(&current);
+    manager.unregister(key);
+    // Another name may share the hash
+    if !manager.has_name_hash(hash) {
+        COMMAND_FILTER.remove(hash);
+    }
+    *current = Arc::new(manager);
+    true
 }
 
-/// Dispatch a command from console
+/// Dispatch a console command found with [`CommandManager::find_by_name`]
 pub(crate) fn dispatch_console_command(
-    command_name: &str,
-    args: Vec<String>,
-    raw_string: String,
+    key: CommandKey,
+    args: CommandArgs<'_>,
+    raw_string: &str,
     player: Option<PlayerController>,
     player_slot: i32,
 ) -> CommandResult {
-    let manager = COMMANDS.read();
+    let _scope = CONSOLE_DISPATCH_PROFILE.scope();
+    let manager = commands();
 
-    let context = if player.is_some() {
-        CommandContext::ClientConsole
-    } else {
+    // The engine's slot says who sent the command; a client whose
+    // controller didn't resolve is rejected by execute()
+    let context = if player_slot < 0 {
         CommandContext::ServerConsole
+    } else {
+        CommandContext::ClientConsole
     };
 
-    let info = CommandInfo::new(args, raw_string, player, context, player_slot);
-
-    if let Some(key) = manager.find_by_name(command_name) {
-        manager.execute(key, info.player(), &info)
-    } else {
-        CommandResult::Continue
-    }
+    let info = CommandInfo::from_args(args, raw_string, player, context, player_slot);
+    manager.execute(key, info.player(), &info)
 }
 
-/// Dispatch a command from chat
+/// Dispatch a chat command found with [`CommandManager::find_chat_command`]
 pub(crate) fn dispatch_chat_command(
-    short_name: &str,
-    args: Vec<String>,
-    raw_string: String,
+    key: CommandKey,
+    args: &[&str],
+    raw_string: &str,
     player: PlayerController,
     player_slot: i32,
     is_silent: bool,
 ) -> CommandResult {
-    let manager = COMMANDS.read();
+    let _scope = CHAT_DISPATCH_PROFILE.scope();
+    let manager = commands();
 
     let context = if is_silent {
         CommandContext::ChatSilent
@@ -325,26 +534,16 @@ pub(crate) fn dispatch_chat_command(
         CommandContext::ChatPublic
     };
 
-    let info = CommandInfo::new(args, raw_string, Some(player), context, player_slot);
-
-    // First try to find by short name
-    if let Some(key) = manager.find_by_short_name(short_name) {
-        return manager.execute(key, info.player(), &info);
-    }
-
-    // Try with default prefix
-    let prefixed_name = format!("{}{}", DEFAULT_PREFIX, short_name);
-    if let Some(key) = manager.find_by_name(&prefixed_name) {
-        return manager.execute(key, info.player(), &info);
-    }
-
-    // Try with css_ prefix for compatibility
-    let css_prefixed = format!("{}{}", CSS_PREFIX, short_name);
-    if let Some(key) = manager.find_by_name(&css_prefixed) {
-        return manager.execute(key, info.player(), &info);
-    }
+    let info = CommandInfo::from_args(
+        CommandArgs::Words(args),
+        raw_string,
+        Some(player),
+        context,
+        player_slot,
+    );
 
-    CommandResult::Continue
+    // Unregistered since it was found: execute() returns Continue
+    manager.execute(key, info.player(), &info)
 }
 
 #[cfg(test)]
@@ -361,6 +560,7 @@ mod tests {
                 "Test command",
                 false,
                 None,
+                None,
                 Box::new(|_, _| CommandResult::Handled),
             )
             .unwrap();
@@ -381,6 +581,7 @@ mod tests {
                 "Slap command",
                 false,
                 None,
+                None,
                 Box::new(|_, _| CommandResult::Handled),
             )
             .unwrap();
@@ -389,6 +590,71 @@ mod tests {
         assert!(manager.find_by_short_name("slap").is_some());
     }
 
+    #[test]
+    fn test_find_chat_command() {
+        let mut manager = CommandManager::new();
+        let handler = || -> CommandCallback { Box::new(|_, _| CommandResult::Handled) };
+
+        let ping = manager
+            .register("csr_ping", "Ping", false, None, None, handler())
+            .unwrap();
+        let slap = manager
+            .register("css_slap", "Slap", false, None, None, handler())
+            .unwrap();
+        let status = manager
+            .register("status_ex", "Unprefixed", false, None, None, handler())
+            .unwrap();
+
+        assert_eq!(manager.find_chat_command("ping"), Some(ping));
+        assert_eq!(manager.find_chat_command("PiNg"), Some(ping));
+        assert_eq!(manager.find_chat_command("slap"), Some(slap));
+        assert_eq!(manager.find_chat_command("status_ex"), None);
+        assert_eq!(manager.find_chat_command("pin"), None);
+        assert_eq!(manager.find_chat_command("pingg"), None);
+        assert_eq!(manager.find_chat_command("ünïcode"), None);
+
+        // A csr_ command shadowed by a css_ one becomes reachable again
+        let css_ping = manager
+            .register("css_ping", "Ping (CSS)", false, None, None, handler())
+            .unwrap();
+        assert_eq!(manager.find_chat_command("ping"), Some(css_ping));
+        assert!(manager.unregister(css_ping));
+        assert_eq!(manager.find_chat_command("ping"), Some(ping));
+
+        assert!(manager.unregister(status));
+        assert!(manager.unregister(slap));
+        assert_eq!(manager.find_chat_command("slap"), None);
+    }
+
+    #[test]
+    fn test_many_commands() {
+        let mut manager = CommandManager::new();
+        let handler = || -> CommandCallback { Box::new(|_, _| CommandResult::Handled) };
+
+        let keys: Vec<CommandKey> = (0..5000)
+            .map(|i| {
+                let prefix = if i % 2 == 0 { "csr" } else { "css" };
+                let name = format!("{prefix}_Plugin{}_Cmd{i}", i % 40);
+                manager.register(&name, "", false, None, None, handler()).unwrap()
+            })
+            .collect();
+        assert_eq!(manager.len(), 5000);
+        assert_eq!(manager.names.len(), 10000);
+
+        assert_eq!(manager.find_by_name("csr_plugin0_cmd0"), Some(keys[0]));
+        assert_eq!(manager.find_by_name("CSS_PLUGIN9_CMD4049"), Some(keys[4049]));
+        assert_eq!(manager.find_chat_command("plugin1_cmd4001"), Some(keys[4001]));
+        assert_eq!(manager.find_by_name("csr_plugin1_cmd4001"), None);
+
+        for &key in keys.iter().step_by(2) {
+            assert!(manager.unregister(key));
+        }
+        assert_eq!(manager.find_by_name("csr_plugin0_cmd0"), None);
+        assert_eq!(manager.find_chat_command("plugin0_cmd0"), None);
+        assert_eq!(manager.find_chat_command("plugin9_cmd4049"), Some(keys[4049]));
+        assert_eq!(manager.names.len(), 5000);
+    }
+
     #[test]
     fn test_unregister_command() {
         let mut manager = CommandManager::new();
@@ -399,6 +665,7 @@ mod tests {
                 "Temporary",
                 false,
                 None,
+                None,
                 Box::new(|_, _| CommandResult::Handled),
             )
             .unwrap();
@@ -408,6 +675,70 @@ mod tests {
         assert!(manager.find_by_name("csr_temp").is_none());
     }
 
+    #[test]
+    fn test_client_command_needs_controller() {
+        use std::sync::atomic::{AtomicUsize, Ordering};
+        use std::sync::Arc;
+
+        let mut manager = CommandManager::new();
+        let calls = Arc::new(AtomicUsize::new(0));
+        let counted = calls.clone();
+        let key = manager
+            .register(
+                "csr_admin_dump",
+                "Server only",
+                true,
+                None,
+                None,
+                Box::new(move |_, _| {
+                    counted.fetch_add(1, Ordering::Relaxed);
+                    CommandResult::Handled
+                }),
+            )
+            .unwrap();
+
+        let args = ["csr_admin_dump"];
+        let run = |context, slot| {
+            let info = CommandInfo::new(&args, "csr_admin_dump", None, context, slot);
+            manager.execute(key, None, &info)
+        };
+
+        // A client slot without a controller is not the server console
+        assert_eq!(run(CommandContext::ClientConsole, 3), CommandResult::Handled);
+        assert_eq!(calls.load(Ordering::Relaxed), 0);
+
+        assert_eq!(run(CommandContext::ServerConsole, -1), CommandResult::Handled);
+        assert_eq!(calls.load(Ordering::Relaxed), 1);
+    }
+
+    #[test]
+    fn test_handlers_run_outside_lock() {
+        // A handler that registers and unregisters a command would
+        // deadlock if dispatch held the lock
+        let outer = register_server_command("csr_test_reentrant", "Re-entrant", |_, _| {
+            let inner = register_command("csr_test_reentrant_inner", "Inner", |_, _| {
+                CommandResult::Handled
+            });
+            assert!(inner.is_some_and(unregister_command));
+            CommandResult::Handled
+        })
+        .unwrap();
+
+        let args = ["csr_test_reentrant"];
+        let result = dispatch_console_command(
+            outer,
+            CommandArgs::Words(&args),
+            "csr_test_reentrant",
+            None,
+            -1,
+        );
+        assert_eq!(result, CommandResult::Handled);
+        assert!(commands()
+            .find_by_name("csr_test_reentrant_inner")
+            .is_none());
+        assert!(unregister_command(outer));
+    }
+
     #[test]
     fn test_duplicate_registration() {
         let mut manager = CommandManager::new();
@@ -417,6 +748,7 @@ mod tests {
             "First",
             false,
             None,
+            None,
             Box::new(|_, _| CommandResult::Handled),
         );
         let key2 = manager.register(
@@ -424,6 +756,7 @@ mod tests {
             "Second",
             false,
             None,
+            None,
             Box::new(|_, _| CommandResult::Handled),
         );
 
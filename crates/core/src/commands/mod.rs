@@ -30,19 +30,50 @@
 //! // - `!ping` or `/ping` in chat
 //! ```
 
+mod async_command;
 pub mod chat;
+mod filter;
 mod info;
+mod limit;
 mod manager;
 mod native;
+mod outbox;
 pub mod print;
+mod stream;
+mod table;
+mod template;
 
+pub use async_command::{
+    register_async_command, register_async_command_ex, register_async_server_command,
+    AsyncCommandInfo,
+};
 pub use info::{CommandCallback, CommandContext, CommandInfo, CommandResult};
+pub use limit::{
+    set_command_rate_limit, set_rate_limit_message, RateLimit, DEFAULT_RATE_LIMIT,
+    DEFAULT_RATE_LIMIT_MESSAGE,
+};
 pub use manager::{
-    register_command, register_command_ex, register_server_command, unregister_command,
-    CommandKey, CommandManager, COMMANDS, CSS_PREFIX, DEFAULT_PREFIX,
+    commands, register_command, register_command_ex, register_command_with_rate_limit,
+    register_server_command, unregister_command, CommandKey, CommandManager, COMMANDS, CSS_PREFIX,
+    DEFAULT_PREFIX,
+};
+pub use outbox::{
+    queue_print, queue_print_all, queued_print_count, MAX_PRINTS_PER_FRAME, MAX_QUEUED_PRINTS,
+};
+pub use print::HudDestination;
+pub use stream::{
+    capture_replies, ReplyStream, MAX_STREAM_BACKLOG, STREAM_LINES_PER_FRAME_CHAT,
+    STREAM_LINES_PER_FRAME_CONSOLE, STREAM_LINES_PER_FRAME_SERVER,
 };
+pub use template::{intern_template, MessageTemplate, TemplateError, CHAT_COLORS};
+
+use parking_lot::Mutex;
 
 use crate::hooks::HookError;
+use crate::listeners::ListenerKey;
+
+/// Disconnect listener that clears the leaving player's rate limits
+static DISCONNECT_LISTENER: Mutex<Option<ListenerKey>> = Mutex::new(None);
 
 /// Initialize the command system (console commands only)
 ///
@@ -55,6 +86,22 @@ pub fn init() -> Result<(), HookError> {
     // Initialize console command hook (ICvar::DispatchConCommand)
     native::init_command_hooks()?;
 
+    // A new player in a slot starts with full rate limit buckets and
+    // nothing queued for the previous one
+    let key = crate::listeners::on_client_disconnect(|slot| {
+        commands().reset_rate_limits(slot);
+        outbox::clear_queued_prints(slot);
+    });
+    if let Some(old) = DISCONNECT_LISTENER.lock().replace(key) {
+        crate::listeners::remove_listener(old);
+    }
+
+    // Built-in server commands
+    crate::logging::register_commands();
+    stream::register_commands();
+    crate::profiler::register_commands();
+    crate::events::register_commands();
+
     tracing::info!("Command system initialized (console commands only)");
     tracing::info!("Call init_chat_hooks() with server module info to enable chat commands");
     Ok(())
@@ -91,9 +138,21 @@ pub fn shutdown() {
     // Remove console command hook
     native::shutdown_command_hooks();
 
+    if let Some(key) = DISCONNECT_LISTENER.lock().take() {
+        crate::listeners::remove_listener(key);
+    }
+
     tracing::info!("Command system shutdown complete");
 }
 
+/// End of frame work: pace out reply streams, then send queued prints
+///
+/// Called from the GameFrame hook on the main thread.
+pub(crate) fn frame_end() {
+    stream::pump_streams();
+    outbox::flush_prints();
+}
+
 /// Check if console command hooks are initialized
 pub fn is_initialized() -> bool {
     native::is_initialized()
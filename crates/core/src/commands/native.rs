@@ -6,9 +6,12 @@ use std::ffi::{c_char, c_void, CStr};
 use std::sync::atomic::{AtomicPtr, Ordering};
 use std::sync::OnceLock;
 
-use super::manager::{dispatch_console_command, COMMANDS};
+use super::info::CommandArgs;
+use super::manager::{dispatch_console_command, COMMANDS, COMMAND_FILTER};
+use super::table::name_hash;
 use super::CommandResult;
 use crate::engine::engine;
+use crate::entities::cached_player_controller;
 use crate::hooks::{vtable, HookError, VTableHookKey};
 
 /// Default VTable index for ICvar::DispatchConCommand (Linux)
@@ -50,18 +53,6 @@ struct CCommand {
 }
 
 impl CCommand {
-    /// Count the number of arguments
-    fn arg_count(&self) -> usize {
-        let mut count = 0;
-        for ptr in &self.args {
-            if ptr.is_null() {
-                break;
-            }
-            count += 1;
-        }
-        count
-    }
-
     /// Get argument by index as string slice
     fn arg(&self, index: usize) -> &str {
         if index < self.args.len() && !self.args[index].is_null() {
@@ -71,16 +62,31 @@ impl CCommand {
         }
     }
 
-    /// Get all arguments as a Vec<String>
-    fn get_args(&self) -> Vec<String> {
-        (0..self.arg_count())
-            .map(|i| self.arg(i).to_string())
-            .collect()
+    /// Get the command name's bytes without decoding them
+    fn name_bytes(&self) -> &[u8] {
+        if self.args[0].is_null() {
+            &[]
+        } else {
+            unsafe { CStr::from_ptr(self.args[0]).to_bytes() }
+        }
     }
 
-    /// Get the full command string
-    fn get_command_string(&self) -> String {
-        self.get_args().join(" ")
+    /// Borrow the argument pointers
+    fn argv(&self) -> CommandArgs<'_> {
+        // SAFETY: the engine fills argv with strings in this command
+        unsafe { CommandArgs::argv(&self.args) }
+    }
+
+    /// Get the full command string, rebuilt from the arguments
+    ///
+    /// The engine's own argument buffer isn't read: its layout in this
+    /// struct hasn't been checked against the SDK.
+    fn command_string(&self) -> String {
+        let args: Vec<&str> = (0..self.args.len())
+            .take_while(|&i| !self.args[i].is_null())
+            .map(|i| self.arg(i))
+            .collect();
+        args.join(" ")
     }
 }
 
@@ -116,36 +122,35 @@ extern "C" fn dispatch_con_command_hook(
     }
     let original: DispatchConCommandFn = unsafe { std::mem::transmute(original_ptr) };
 
-    // Parse command info safely
-    let (command_name, command_args, raw_string, player_slot) = unsafe {
-        let args_ref = &*args;
-        let ctx_ref = &*ctx;
-
-        let command_args = args_ref.get_args();
-        let command_name = command_args.first().cloned().unwrap_or_default();
-        let raw_string = args_ref.get_command_string();
-        let player_slot = ctx_ref.player_slot;
-
-        (command_name, command_args, raw_string, player_slot)
-    };
-
-    // Check if this is one of our commands
-    let is_our_command = {
-        let manager = COMMANDS.read();
-        manager.find_by_name(&command_name).is_some()
-    };
-
-    if is_our_command {
-        // Get player controller if this is from a client
-        let player = if player_slot >= 0 {
-            // TODO: Get player controller from slot via entity system
-            None
-        } else {
-            None
-        };
+    // Check ownership on the command name in engine memory before
+    // touching anything else; most commands stop at the lock-free filter
+    let args_ref = unsafe { &*args };
+    let name_hash = name_hash(args_ref.name_bytes());
+    if !COMMAND_FILTER.might_contain(name_hash) {
+        original(this, cmd, ctx, args);
+        return;
+    }
 
-        let result =
-            dispatch_console_command(&command_name, command_args, raw_string, player, player_slot);
+    let command_name = args_ref.arg(0);
+    let command_key = COMMANDS.read().find_by_hash(name_hash, command_name);
+
+    if let Some(command_key) = command_key {
+        let player_slot = unsafe { (*ctx).player_slot };
+
+        // Resolve the sending client's controller through the slot table
+        // (None for the server console; clients that don't resolve are
+        // rejected by the dispatcher)
+        let player = cached_player_controller(player_slot).filter(|p| p.is_connected());
+
+        // Arguments stay borrowed from the engine's CCommand
+        let raw_string = args_ref.command_string();
+        let result = dispatch_console_command(
+            command_key,
+            args_ref.argv(),
+            &raw_string,
+            player,
+            player_slot,
+        );
 
         if result >= CommandResult::Handled {
             // Don't call original - we handled it
@@ -0,0 +1,473 @@
+//! Batched client printing
+//!
+//! [`queue_print`] and [`queue_print_all`] don't call the engine. They add
+//! the message to a per-frame outbox, which is flushed once at the end of
+//! GameFrame. While messages wait:
+//!
+//! - an identical broadcast (same destination and text) is only kept once,
+//!   and a direct message already covered by a pending broadcast is dropped
+//! - a direct message identical to the recipient's previous one is dropped;
+//!   console lines are joined into one engine call; a new center message
+//!   replaces the pending one
+//! - each client gets at most [`MAX_PRINTS_PER_FRAME`] messages per frame
+//!   (broadcasts included), the rest wait for later frames, so a burst
+//!   can't overflow the reliable channel
+//!
+//! Broadcasts and direct messages wait in one queue and go out in the
+//! order they were queued. Once a message has to wait for a later frame,
+//! every later message to the same client waits too. A broadcast reaches
+//! every client, so one that waits holds back everything queued after it.
+//!
+//! Message text is copied into NUL-terminated buffers taken from a pool,
+//! so a steady flow of messages doesn't allocate.
+
+use std::collections::VecDeque;
+use std::ffi::CStr;
+
+use parking_lot::Mutex;
+
+use super::print::{self, HudDestination};
+use crate::entities::{cached_player_controller, MAX_PLAYERS};
+
+/// Messages sent to one client per frame, broadcasts included
+pub const MAX_PRINTS_PER_FRAME: usize = 8;
+
+/// Messages held for one recipient (or for everyone) before new ones are dropped
+pub const MAX_QUEUED_PRINTS: usize = 128;
+
+/// Joined console lines stay under this many bytes
+const MAX_COALESCED_LEN: usize = 1024;
+
+/// Spare buffers kept for reuse
+const MAX_POOLED_BUFFERS: usize = 256;
+
+/// Buffers that grew beyond this aren't kept
+const MAX_POOLED_CAPACITY: usize = 4096;
+
+/// A queued message
+struct Message {
+    dest: HudDestination,
+    /// Text with its NUL terminator
+    text: Vec<u8>,
+}
+
+impl Message {
+    /// Text without the terminator
+    fn body(&self) -> &[u8] {
+        &self.text[..self.text.len() - 1]
+    }
+
+    fn is(&self, dest: HudDestination, text: &[u8]) -> bool {
+        self.dest == dest && self.body() == text
+    }
+
+    fn c_str(&self) -> &CStr {
+        // Safety: queued text is checked for NULs and always terminated
+        unsafe { CStr::from_bytes_with_nul_unchecked(&self.text) }
+    }
+
+    /// Replace the text, keeping the buffer
+    fn set(&mut self, text: &[u8]) {
+        self.text.clear();
+        self.text.extend_from_slice(text);
+        self.text.push(0);
+    }
+
+    /// Add a line, keeping the buffer
+    fn append_line(&mut self, text: &[u8]) {
+        self.text.pop();
+        self.text.push(b'\n');
+        self.text.extend_from_slice(text);
+        self.text.push(0);
+    }
+}
+
+/// Recipient of a message
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Target {
+    All,
+    Slot(usize),
+}
+
+/// Messages waiting for the end of the frame
+struct Outbox {
+    /// Every queued message, oldest first
+    queue: VecDeque<(Target, Message)>,
+    /// Queued broadcasts
+    queued_all: usize,
+    /// Queued direct messages per slot
+    queued: [usize; MAX_PLAYERS],
+    pool: Vec<Vec<u8>>,
+}
+
+impl Outbox {
+    const fn new() -> Self {
+        Self {
+            queue: VecDeque::new(),
+            queued_all: 0,
+            queued: [0; MAX_PLAYERS],
+            pool: Vec::new(),
+        }
+    }
+
+    /// Queued messages for one target, newest first
+    fn pending(&mut self, target: Target) -> impl Iterator<Item = &mut Message> {
+        self.queue
+            .iter_mut()
+            .rev()
+            .filter(move |(t, _)| *t == target)
+            .map(|(_, m)| m)
+    }
+
+    /// Check if an identical broadcast is queued
+    fn has_broadcast(&self, dest: HudDestination, text: &[u8]) -> bool {
+        self.queued_all > 0
+            && self
+                .queue
+                .iter()
+                .any(|(t, m)| *t == Target::All && m.is(dest, text))
+    }
+
+    fn count_mut(&mut self, target: Target) -> &mut usize {
+        match target {
+            Target::All => &mut self.queued_all,
+            Target::Slot(slot) => &mut self.queued[slot],
+        }
+    }
+
+    /// Keep the messages for which `take` returns false, in order
+    fn drain_where(
+        &mut self,
+        mut take: impl FnMut(Target) -> bool,
+        mut taken: impl FnMut(&mut Self, Target, Message),
+    ) {
+        for _ in 0..self.queue.len() {
+            let Some((target, message)) = self.queue.pop_front() else {
+                break;
+            };
+            if take(target) {
+                *self.count_mut(target) -= 1;
+                taken(self, target, message);
+            } else {
+                self.queue.push_back((target, message));
+            }
+        }
+    }
+
+    fn message(&mut self, dest: HudDestination, text: &[u8]) -> Message {
+        let mut message = Message {
+            dest,
+            text: self.pool.pop().unwrap_or_default(),
+        };
+        message.set(text);
+        message
+    }
+
+    fn recycle(&mut self, buffer: Vec<u8>) {
+        if self.pool.len() < MAX_POOLED_BUFFERS && buffer.capacity() <= MAX_POOLED_CAPACITY {
+            self.pool.push(buffer);
+        }
+    }
+
+    /// Add a message at the back of the queue
+    fn push_back(&mut self, target: Target, dest: HudDestination, text: &[u8]) {
+        let message = self.message(dest, text);
+        self.queue.push_back((target, message));
+        *self.count_mut(target) += 1;
+    }
+
+    /// Queue a broadcast (false if dropped as a duplicate or over the cap)
+    fn push_all(&mut self, dest: HudDestination, text: &[u8]) -> bool {
+        if self.queued_all >= MAX_QUEUED_PRINTS || self.has_broadcast(dest, text) {
+            return false;
+        }
+        self.push_back(Target::All, dest, text);
+        true
+    }
+
+    /// Queue a message to one slot (false if dropped as a duplicate or over the cap)
+    fn push(&mut self, slot: usize, dest: HudDestination, text: &[u8]) -> bool {
+        if self.has_broadcast(dest, text) {
+            return false;
+        }
+
+        let target = Target::Slot(slot);
+        if self.queued[slot] > 0 {
+            // Joining a line to a message queued before a broadcast would
+            // send it ahead of that broadcast
+            let at_back = matches!(self.queue.back(), Some((t, _)) if *t == target);
+            if let Some(last) = self.pending(target).next() {
+                if last.is(dest, text) {
+                    return false;
+                }
+                if at_back
+                    && dest == HudDestination::Console
+                    && last.dest == HudDestination::Console
+                    && last.text.len() + text.len() < MAX_COALESCED_LEN
+                {
+                    last.append_line(text);
+                    return true;
+                }
+            }
+            if dest == HudDestination::Center {
+                if let Some(pending) = self.pending(target).find(|m| m.dest == dest) {
+                    pending.set(text);
+                    return true;
+                }
+            }
+        }
+        if self.queued[slot] >= MAX_QUEUED_PRINTS {
+            return false;
+        }
+
+        self.push_back(target, dest, text);
+        true
+    }
+
+    /// Move the messages due this frame into `out`, in queue order
+    fn take_due(&mut self, out: &mut Vec<(Target, Message)>) {
+        // Broadcasts count against every client's budget
+        let mut broadcasts = 0;
+        let mut direct = [0usize; MAX_PLAYERS];
+        let mut most_direct = 0;
+        let mut waiting = [false; MAX_PLAYERS];
+        let mut any_waiting = false;
+
+        self.drain_where(
+            |target| match target {
+                Target::All => {
+                    let due = !any_waiting && broadcasts + most_direct < MAX_PRINTS_PER_FRAME;
+                    if due {
+                        broadcasts += 1;
+                    } else {
+                        // Everyone gets broadcasts, so nothing may pass one
+                        any_waiting = true;
+                        waiting = [true; MAX_PLAYERS];
+                    }
+                    due
+                }
+                Target::Slot(slot) => {
+                    let due = !waiting[slot] && broadcasts + direct[slot] < MAX_PRINTS_PER_FRAME;
+                    if due {
+                        direct[slot] += 1;
+                        most_direct = most_direct.max(direct[slot]);
+                    } else {
+                        any_waiting = true;
+                        waiting[slot] = true;
+                    }
+                    due
+                }
+            },
+            |_, target, message| out.push((target, message)),
+        );
+    }
+
+    /// Drop everything queued for a slot
+    fn clear_slot(&mut self, slot: usize) {
+        if self.queued[slot] > 0 {
+            self.drain_where(
+                |target| target == Target::Slot(slot),
+                |outbox, _, message| outbox.recycle(message.text),
+            );
+        }
+    }
+
+    fn len(&self) -> usize {
+        self.queue.len()
+    }
+}
+
+static OUTBOX: Mutex<Outbox> = Mutex::new(Outbox::new());
+
+/// Messages being sent (kept to reuse its allocation)
+static SENDING: Mutex<Vec<(Target, Message)>> = Mutex::new(Vec::new());
+
+/// Check that a message can be sent as a C string
+fn valid(message: &str) -> bool {
+    if message.as_bytes().contains(&0) {
+        tracing::warn!("Invalid message for ClientPrint: contains null byte");
+        return false;
+    }
+    true
+}
+
+/// Queue a message to a player, sent at the end of the frame
+///
+/// Safe to call from any thread. The message is dropped if the player
+/// is gone by then.
+pub fn queue_print(slot: i32, dest: HudDestination, message: &str) {
+    let Some(slot) = usize::try_from(slot).ok().filter(|&s| s < MAX_PLAYERS) else {
+        tracing::warn!("queue_print called with invalid slot {}", slot);
+        return;
+    };
+    if valid(message) && !OUTBOX.lock().push(slot, dest, message.as_bytes()) {
+        tracing::trace!("Print to slot {} dropped (duplicate or queue full)", slot);
+    }
+}
+
+/// Queue a message to all players, sent at the end of the frame
+///
+/// Safe to call from any thread. Identical broadcasts queued in the same
+/// frame are sent once.
+pub fn queue_print_all(dest: HudDestination, message: &str) {
+    if valid(message) && !OUTBOX.lock().push_all(dest, message.as_bytes()) {
+        tracing::trace!("Broadcast dropped (duplicate or queue full)");
+    }
+}
+
+/// Number of queued messages not sent yet
+pub fn queued_print_count() -> usize {
+    OUTBOX.lock().len()
+}
+
+/// Drop a slot's queued messages (its client left)
+pub(crate) fn clear_queued_prints(slot: i32) {
+    if let Some(slot) = usize::try_from(slot).ok().filter(|&s| s < MAX_PLAYERS) {
+        OUTBOX.lock().clear_slot(slot);
+    }
+}
+
+/// Send the messages due this frame
+///
+/// Called from GameFrame hook on the main thread. The outbox isn't locked
+/// while the engine is called, so printing may queue more messages.
+pub(crate) fn flush_prints() {
+    let mut sending = SENDING.lock();
+    OUTBOX.lock().take_due(&mut sending);
+    if sending.is_empty() {
+        return;
+    }
+
+    for (target, message) in sending.iter() {
+        match *target {
+            Target::All => print::client_print_all_c(message.dest, message.c_str()),
+            Target::Slot(slot) => {
+                let Some(player) = cached_player_controller(slot as i32) else {
+                    continue;
+                };
+                if player.is_connected() {
+                    unsafe {
+                        print::client_print_c(player.as_ptr(), message.dest, message.c_str())
+                    };
+                }
+            }
+        }
+    }
+
+    let mut outbox = OUTBOX.lock();
+    for (_, message) in sending.drain(..) {
+        outbox.recycle(message.text);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn due(outbox: &mut Outbox) -> Vec<(Target, HudDestination, String)> {
+        let mut out = Vec::new();
+        outbox.take_due(&mut out);
+        out.into_iter()
+            .map(|(target, m)| {
+                let text = m.c_str().to_str().unwrap().to_string();
+                outbox.recycle(m.text);
+                (target, m.dest, text)
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_outbox_merging() {
+        use HudDestination::*;
+        let mut outbox = Outbox::new();
+
+        assert!(outbox.push_all(Talk, b"Round starts"));
+        assert!(!outbox.push_all(Talk, b"Round starts"));
+        assert!(outbox.push_all(Center, b"Round starts"));
+
+        // Covered by the broadcast, repeated, joined, replaced
+        assert!(!outbox.push(3, Talk, b"Round starts"));
+        assert!(outbox.push(3, Talk, b"hi"));
+        assert!(!outbox.push(3, Talk, b"hi"));
+        assert!(outbox.push(3, Console, b"line 1"));
+        assert!(outbox.push(3, Console, b"line 2"));
+        assert!(outbox.push(3, Center, b"3"));
+        assert!(outbox.push(3, Center, b"2"));
+        assert_eq!(outbox.len(), 5);
+
+        let sent = due(&mut outbox);
+        assert_eq!(
+            sent,
+            [
+                (Target::All, Talk, "Round starts".to_string()),
+                (Target::All, Center, "Round starts".to_string()),
+                (Target::Slot(3), Talk, "hi".to_string()),
+                (Target::Slot(3), Console, "line 1\nline 2".to_string()),
+                (Target::Slot(3), Center, "2".to_string()),
+            ]
+        );
+        assert_eq!(outbox.len(), 0);
+        assert_eq!(outbox.pool.len(), 5);
+    }
+
+    #[test]
+    fn test_outbox_rate_cap() {
+        let mut outbox = Outbox::new();
+        outbox.push_all(HudDestination::Talk, b"everyone");
+        for i in 0..MAX_PRINTS_PER_FRAME + 1 {
+            outbox.push(0, HudDestination::Talk, format!("msg {i}").as_bytes());
+        }
+        outbox.push(1, HudDestination::Talk, b"other");
+
+        // The broadcast counts against every client's budget
+        let sent = due(&mut outbox);
+        let to_first = sent.iter().filter(|m| m.0 == Target::Slot(0)).count();
+        assert_eq!(to_first, MAX_PRINTS_PER_FRAME - 1);
+        assert!(sent.iter().any(|m| m.0 == Target::Slot(1)));
+
+        // The rest goes out next frame
+        assert_eq!(due(&mut outbox).len(), 2);
+
+        outbox.push(5, HudDestination::Talk, b"bye");
+        outbox.clear_slot(5);
+        assert_eq!(outbox.len(), 0);
+    }
+
+    #[test]
+    fn test_outbox_keeps_queue_order() {
+        use HudDestination::*;
+        let mut outbox = Outbox::new();
+        outbox.push(2, Talk, b"first");
+        outbox.push_all(Talk, b"second");
+        outbox.push(2, Talk, b"third");
+        outbox.push(4, Talk, b"fourth");
+
+        let sent = due(&mut outbox);
+        assert_eq!(
+            sent,
+            [
+                (Target::Slot(2), Talk, "first".to_string()),
+                (Target::All, Talk, "second".to_string()),
+                (Target::Slot(2), Talk, "third".to_string()),
+                (Target::Slot(4), Talk, "fourth".to_string()),
+            ]
+        );
+
+        // A client over its budget holds back the next broadcast, and
+        // nothing queued after that broadcast passes it
+        for i in 0..MAX_PRINTS_PER_FRAME + 1 {
+            outbox.push(2, Talk, format!("msg {i}").as_bytes());
+        }
+        outbox.push_all(Talk, b"later");
+        outbox.push(4, Talk, b"after");
+
+        let sent = due(&mut outbox);
+        assert_eq!(sent.len(), MAX_PRINTS_PER_FRAME);
+        assert!(sent.iter().all(|m| m.0 == Target::Slot(2)));
+
+        let sent = due(&mut outbox);
+        let order: Vec<_> = sent.iter().map(|m| m.2.as_str()).collect();
+        assert_eq!(order, ["msg 8", "later", "after"]);
+        assert_eq!(outbox.len(), 0);
+    }
+}
@@ -1,8 +1,10 @@
 //! Client print functionality for sending messages to players
 //!
 //! Uses signature scanning to find and call the game's ClientPrint function.
+//! The functions here call the engine right away; to send many messages,
+//! queue them with [`queue_print`](super::queue_print) instead.
 
-use std::ffi::{c_char, c_void, CString};
+use std::ffi::{c_char, c_void, CStr, CString};
 use std::sync::OnceLock;
 
 use crate::gamedata::{find_signature, GamedataError};
@@ -104,6 +106,17 @@ pub fn is_client_print_all_available() -> bool {
 /// # Safety
 /// Player pointer must be valid or null.
 pub unsafe fn client_print(player: *mut c_void, dest: HudDestination, message: &str) {
+    match CString::new(message) {
+        Ok(c_msg) => client_print_c(player, dest, &c_msg),
+        Err(_) => tracing::warn!("Invalid message for ClientPrint: contains null byte"),
+    }
+}
+
+/// Print an already NUL-terminated message to a specific player
+///
+/// # Safety
+/// Player pointer must be valid or null.
+pub unsafe fn client_print_c(player: *mut c_void, dest: HudDestination, message: &CStr) {
     if player.is_null() {
         tracing::warn!("client_print called with null player");
         return;
@@ -111,22 +124,14 @@ pub unsafe fn client_print(player: *mut c_void, dest: HudDestination, message: &
 
     let Some(Some(func)) = CLIENT_PRINT.get() else {
         // Fall back to logging
-        tracing::info!("[ClientPrint] {}", message);
+        tracing::info!("[ClientPrint] {}", message.to_string_lossy());
         return;
     };
 
-    let c_msg = match CString::new(message) {
-        Ok(s) => s,
-        Err(_) => {
-            tracing::warn!("Invalid message for ClientPrint: contains null byte");
-            return;
-        }
-    };
-
     func(
         player,
         dest as i32,
-        c_msg.as_ptr(),
+        message.as_ptr(),
         std::ptr::null(),
         std::ptr::null(),
         std::ptr::null(),
@@ -140,24 +145,24 @@ pub unsafe fn client_print(player: *mut c_void, dest: HudDestination, message: &
 /// * `dest` - Where to display the message
 /// * `message` - The message to send
 pub fn client_print_all(dest: HudDestination, message: &str) {
+    match CString::new(message) {
+        Ok(c_msg) => client_print_all_c(dest, &c_msg),
+        Err(_) => tracing::warn!("Invalid message for ClientPrintAll: contains null byte"),
+    }
+}
+
+/// Print an already NUL-terminated message to all players
+pub fn client_print_all_c(dest: HudDestination, message: &CStr) {
     let Some(Some(func)) = CLIENT_PRINT_ALL.get() else {
         // Fall back to logging
-        tracing::info!("[ClientPrintAll] {}", message);
+        tracing::info!("[ClientPrintAll] {}", message.to_string_lossy());
         return;
     };
 
-    let c_msg = match CString::new(message) {
-        Ok(s) => s,
-        Err(_) => {
-            tracing::warn!("Invalid message for ClientPrintAll: contains null byte");
-            return;
-        }
-    };
-
     unsafe {
         func(
             dest as i32,
-            c_msg.as_ptr(),
+            message.as_ptr(),
             std::ptr::null(),
             std::ptr::null(),
             std::ptr::null(),
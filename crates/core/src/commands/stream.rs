@@ -0,0 +1,501 @@
+//! Streaming command output
+//!
+//! A [`ReplyStream`] takes output of any size without printing it all in
+//! one frame. Where the text goes depends on the sink:
+//!
+//! - **Caller** ([`CommandInfo::reply_stream`]): lines are handed out a few
+//!   per frame from the GameFrame hook, to the server log or through the
+//!   client print queue, so a dump of thousands of lines never spikes a
+//!   tick or overflows a client's reliable channel
+//! - **Buffer** ([`ReplyStream::buffer`]): kept in memory, read back with
+//!   [`ReplyStream::contents`]
+//! - **File** ([`ReplyStream::file`]): written through a buffered writer
+//!
+//! [`capture_replies`] redirects every reply made while it runs, including
+//! `reply_stream()` streams, into a stream. The `csr_capture` server
+//! command uses it to write any command's output to a file. Async commands
+//! keep the capture for their whole task, so the file is complete once the
+//! task finishes.
+//!
+//! Streams are handles: clones write to the same sink, and a caller
+//! stream is finished once every handle is dropped and its text is out.
+//!
+//! [`CommandInfo::reply_stream`]: super::CommandInfo::reply_stream
+
+use std::cell::RefCell;
+use std::fmt::{self, Write as _};
+use std::fs::File;
+use std::io::{self, BufWriter, Write as _};
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+
+use parking_lot::Mutex;
+
+use super::async_command::caller;
+use super::info::{CommandContext, CommandInfo, CommandResult};
+use super::manager::{commands, register_server_command};
+use super::print::HudDestination;
+use crate::entities::PlayerController;
+
+/// Lines sent per frame to the server log
+pub const STREAM_LINES_PER_FRAME_SERVER: usize = 64;
+
+/// Lines sent per frame to a player's console (joined by the print queue)
+pub const STREAM_LINES_PER_FRAME_CONSOLE: usize = 32;
+
+/// Lines sent per frame to a player's chat
+pub const STREAM_LINES_PER_FRAME_CHAT: usize = 4;
+
+/// Unsent text kept per caller stream; more is dropped and counted
+pub const MAX_STREAM_BACKLOG: usize = 4 * 1024 * 1024;
+
+/// File sink write buffer
+const WRITE_BUFFER: usize = 64 * 1024;
+
+/// Text waiting to be sent to a command's caller
+struct CallerSink {
+    context: CommandContext,
+    slot: i32,
+    steam_id: u64,
+    text: String,
+    /// Bytes of `text` already sent
+    sent: usize,
+    /// Bytes dropped over the backlog limit
+    dropped: usize,
+}
+
+impl CallerSink {
+    fn lines_per_frame(&self) -> usize {
+        match self.context {
+            CommandContext::ServerConsole => STREAM_LINES_PER_FRAME_SERVER,
+            CommandContext::ClientConsole => STREAM_LINES_PER_FRAME_CONSOLE,
+            CommandContext::ChatPublic | CommandContext::ChatSilent => STREAM_LINES_PER_FRAME_CHAT,
+        }
+    }
+
+    fn deliver(&self, player: Option<&PlayerController>, line: &str) {
+        let dest = match self.context {
+            CommandContext::ServerConsole => {
+                tracing::info!("[Server] {}", line);
+                return;
+            }
+            CommandContext::ClientConsole => HudDestination::Console,
+            CommandContext::ChatPublic | CommandContext::ChatSilent => HudDestination::Talk,
+        };
+        if player.is_some() {
+            super::queue_print(self.slot, dest, line);
+        }
+    }
+
+    /// Send this frame's lines; returns true once nothing is left
+    ///
+    /// A final line without its newline is held back until `closed`.
+    fn pump(&mut self, closed: bool) -> bool {
+        let player = caller(self.slot, self.steam_id);
+        if player.is_none() && self.context != CommandContext::ServerConsole {
+            // The caller left, nobody to send to
+            return true;
+        }
+
+        for _ in 0..self.lines_per_frame() {
+            let rest = &self.text[self.sent..];
+            let line = match rest.find('\n') {
+                Some(end) => {
+                    self.sent += end + 1;
+                    &rest[..end]
+                }
+                None if closed && !rest.is_empty() => {
+                    self.sent = self.text.len();
+                    rest
+                }
+                None => break,
+            };
+            self.deliver(player.as_ref(), line);
+        }
+
+        if self.sent == self.text.len() {
+            self.text.clear();
+            self.sent = 0;
+            if closed && self.dropped > 0 {
+                let note = format!("... {} bytes of output dropped", self.dropped);
+                self.dropped = 0;
+                self.deliver(player.as_ref(), &note);
+            }
+            return closed;
+        }
+
+        // Reclaim sent text once it's most of the buffer
+        if self.sent > self.text.len() / 2 {
+            self.text.drain(..self.sent);
+            self.sent = 0;
+        }
+        false
+    }
+}
+
+enum Sink {
+    Caller(CallerSink),
+    Buffer(String),
+    File {
+        writer: BufWriter<File>,
+        path: PathBuf,
+        failed: bool,
+    },
+}
+
+impl Sink {
+    fn write(&mut self, text: &str) {
+        match self {
+            Sink::Caller(sink) => {
+                if sink.text.len() - sink.sent + text.len() > MAX_STREAM_BACKLOG {
+                    sink.dropped += text.len();
+                } else {
+                    sink.text.push_str(text);
+                }
+            }
+            Sink::Buffer(buffer) => buffer.push_str(text),
+            Sink::File {
+                writer,
+                path,
+                failed,
+            } => {
+                if !*failed {
+                    if let Err(e) = writer.write_all(text.as_bytes()) {
+                        tracing::warn!("Failed to write output to {}: {}", path.display(), e);
+                        *failed = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+impl Drop for Sink {
+    fn drop(&mut self) {
+        if let Sink::File {
+            writer,
+            path,
+            failed,
+        } = self
+        {
+            if let Err(e) = writer.flush() {
+                if !*failed {
+                    tracing::warn!("Failed to write output to {}: {}", path.display(), e);
+                }
+            }
+        }
+    }
+}
+
+/// A sink for command output of any size (see the module docs)
+#[derive(Clone)]
+pub struct ReplyStream {
+    sink: Arc<Mutex<Sink>>,
+}
+
+impl ReplyStream {
+    fn new(sink: Sink) -> Self {
+        Self {
+            sink: Arc::new(Mutex::new(sink)),
+        }
+    }
+
+    /// Stream to a command's caller, paced across frames
+    pub(crate) fn caller(context: CommandContext, slot: i32, steam_id: u64) -> Self {
+        if let Some(captured) = captured() {
+            return captured;
+        }
+        let stream = Self::new(Sink::Caller(CallerSink {
+            context,
+            slot,
+            steam_id,
+            text: String::new(),
+            sent: 0,
+            dropped: 0,
+        }));
+        ACTIVE.lock().push(stream.sink.clone());
+        stream
+    }
+
+    /// Stream into memory
+    pub fn buffer() -> Self {
+        Self::new(Sink::Buffer(String::new()))
+    }
+
+    /// Stream into a file (created or truncated, parent directories created)
+    pub fn file(path: &Path) -> io::Result<Self> {
+        if let Some(parent) = path.parent() {
+            std::fs::create_dir_all(parent)?;
+        }
+        let writer = BufWriter::with_capacity(WRITE_BUFFER, File::create(path)?);
+        Ok(Self::new(Sink::File {
+            writer,
+            path: path.to_path_buf(),
+            failed: false,
+        }))
+    }
+
+    /// Write a line
+    pub fn line(&self, text: &str) {
+        let mut sink = self.sink.lock();
+        sink.write(text);
+        sink.write("\n");
+    }
+
+    /// Write a formatted line
+    pub fn line_fmt(&self, args: fmt::Arguments<'_>) {
+        let mut sink = self.sink.lock();
+        let _ = SinkWriter(&mut sink).write_fmt(args);
+        sink.write("\n");
+    }
+
+    /// Text written so far (memory streams only, empty otherwise)
+    pub fn contents(&self) -> String {
+        match &*self.sink.lock() {
+            Sink::Buffer(buffer) => buffer.clone(),
+            _ => String::new(),
+        }
+    }
+}
+
+impl fmt::Write for ReplyStream {
+    fn write_str(&mut self, s: &str) -> fmt::Result {
+        self.sink.lock().write(s);
+        Ok(())
+    }
+}
+
+impl fmt::Debug for ReplyStream {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let kind = match &*self.sink.lock() {
+            Sink::Caller(_) => "caller",
+            Sink::Buffer(_) => "buffer",
+            Sink::File { .. } => "file",
+        };
+        f.debug_struct("ReplyStream").field("sink", &kind).finish()
+    }
+}
+
+/// `fmt::Write` into a locked sink
+struct SinkWriter<'a>(&'a mut Sink);
+
+impl fmt::Write for SinkWriter<'_> {
+    fn write_str(&mut self, s: &str) -> fmt::Result {
+        self.0.write(s);
+        Ok(())
+    }
+}
+
+/// Caller streams with text left to send
+static ACTIVE: Mutex<Vec<Arc<Mutex<Sink>>>> = Mutex::new(Vec::new());
+
+/// Send this frame's share of every caller stream
+///
+/// Called from the GameFrame hook, before queued prints are flushed.
+pub(super) fn pump_streams() {
+    let mut active = ACTIVE.lock();
+    active.retain(|stream| {
+        // Only this list holds it: every writer is gone
+        let closed = Arc::strong_count(stream) == 1;
+        match &mut *stream.lock() {
+            Sink::Caller(sink) => !sink.pump(closed),
+            _ => false,
+        }
+    });
+}
+
+thread_local! {
+    /// Stream replies are redirected to (see [`capture_replies`])
+    static CAPTURE: RefCell<Option<ReplyStream>> = const { RefCell::new(None) };
+}
+
+/// The active capture stream, if any
+pub(super) fn captured() -> Option<ReplyStream> {
+    CAPTURE.with(|capture| capture.borrow().clone())
+}
+
+/// Write a reply to the active capture (false if nothing is capturing)
+pub(super) fn capture_reply(message: &str) -> bool {
+    CAPTURE.with(|capture| match &*capture.borrow() {
+        Some(stream) => {
+            stream.line(message);
+            true
+        }
+        None => false,
+    })
+}
+
+/// Redirect every command reply made by `f` on this thread into `stream`
+///
+/// Covers [`CommandInfo::reply`] and streams opened with
+/// [`CommandInfo::reply_stream`] (which write to `stream` directly).
+/// Captures nest; the innermost one wins.
+pub fn capture_replies<R>(stream: &ReplyStream, f: impl FnOnce() -> R) -> R {
+    let previous = CAPTURE.with(|capture| capture.replace(Some(stream.clone())));
+    // Restore even if `f` unwinds
+    struct Restore(Option<ReplyStream>);
+    impl Drop for Restore {
+        fn drop(&mut self) {
+            let previous = self.0.take();
+            CAPTURE.with(|capture| *capture.borrow_mut() = previous);
+        }
+    }
+    let _restore = Restore(previous);
+    f()
+}
+
+/// Register the built-in output capture command
+pub(crate) fn register_commands() {
+    register_server_command(
+        "csr_capture",
+        "Write a command's output to a file (usage: csr_capture <file> <command> [args])",
+        handle_capture,
+    );
+}
+
+fn handle_capture(_player: Option<&PlayerController>, info: &CommandInfo) -> CommandResult {
+    if info.arg_count() < 3 {
+        info.reply("Usage: csr_capture <file> <command> [args]");
+        return CommandResult::Handled;
+    }
+
+    // File names are relative to <cs2rust>/captures and can't leave it
+    let Some(path) = crate::config::data_file_path("captures", info.arg(1)) else {
+        info.reply("The capture file must be a relative path without '..'");
+        return CommandResult::Handled;
+    };
+    let stream = match ReplyStream::file(&path) {
+        Ok(stream) => stream,
+        Err(e) => {
+            info.reply(&format!("Could not create {}: {}", path.display(), e));
+            return CommandResult::Handled;
+        }
+    };
+
+    let args: Vec<&str> = info.args().skip(2).collect();
+    let raw_string = args.join(" ");
+
+    let manager = commands();
+    let Some(key) = manager.find_by_name(args[0]) else {
+        info.reply(&format!("Unknown command '{}'", args[0]));
+        return CommandResult::Handled;
+    };
+    let inner = CommandInfo::new(&args, &raw_string, None, CommandContext::ServerConsole, -1);
+    // Async commands hold their own handle, so the file stays open until
+    // their task finishes
+    let result = capture_replies(&stream, || manager.execute(key, None, &inner));
+    drop(stream);
+
+    info.reply(&format!(
+        "Captured '{}' ({:?}) to {}",
+        args[0],
+        result,
+        path.display()
+    ));
+    CommandResult::Handled
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_buffer_and_capture() {
+        let stream = ReplyStream::buffer();
+        stream.line("first");
+        stream.line_fmt(format_args!("{} + {}", 1, 2));
+
+        let mut writer = stream.clone();
+        write!(writer, "partial").unwrap();
+        assert_eq!(stream.contents(), "first\n1 + 2\npartial");
+
+        let captured = ReplyStream::buffer();
+        let result = capture_replies(&captured, || {
+            let info = CommandInfo::new(
+                &["csr_dump"],
+                "csr_dump",
+                None,
+                CommandContext::ServerConsole,
+                -1,
+            );
+            info.reply("one");
+            info.reply_stream().line("two");
+            7
+        });
+        assert_eq!(result, 7);
+        assert_eq!(captured.contents(), "one\ntwo\n");
+        assert!(!capture_reply("after"));
+    }
+
+    #[test]
+    fn test_caller_pacing() {
+        let mut sink = CallerSink {
+            context: CommandContext::ServerConsole,
+            slot: -1,
+            steam_id: 0,
+            text: String::new(),
+            sent: 0,
+            dropped: 0,
+        };
+        for i in 0..STREAM_LINES_PER_FRAME_SERVER + 10 {
+            sink.text.push_str(&format!("line {i}\n"));
+        }
+        sink.text.push_str("tail");
+
+        // One frame's worth, then the rest; the partial line waits
+        assert!(!sink.pump(false));
+        assert!(sink
+            .text
+            .starts_with(&format!("line {}\n", STREAM_LINES_PER_FRAME_SERVER)));
+        assert!(!sink.pump(false));
+        assert_eq!(&sink.text[sink.sent..], "tail");
+        assert!(!sink.pump(false));
+        assert!(sink.pump(true));
+        assert!(sink.text.is_empty());
+    }
+
+    #[test]
+    fn test_capture_async_command() {
+        use crate::commands::register_async_server_command;
+        use crate::tasks::executor::EXECUTOR_TEST;
+        use crate::tasks::{next_frame, process_async_tasks};
+
+        let _serial = EXECUTOR_TEST.lock();
+        let key = register_async_server_command("csr_test_slow_dump", "Slow", |info| async move {
+            next_frame().await;
+            info.reply("after a frame");
+            info.reply_stream().line_fmt(format_args!("streamed {}", 2));
+        })
+        .unwrap();
+
+        let file = format!("csr_async_capture_{}.txt", std::process::id());
+        let path = crate::config::data_file_path("captures", &file).unwrap();
+        let args = ["csr_capture", file.as_str(), "csr_test_slow_dump"];
+        let info = CommandInfo::new(&args, "", None, CommandContext::ServerConsole, -1);
+        assert_eq!(handle_capture(None, &info), CommandResult::Handled);
+
+        // The task replies on its second poll, after the capture returned
+        process_async_tasks();
+        process_async_tasks();
+
+        let text = std::fs::read_to_string(&path).unwrap();
+        let _ = std::fs::remove_file(&path);
+        crate::commands::unregister_command(key);
+        assert_eq!(text, "after a frame\nstreamed 2\n");
+    }
+
+    #[test]
+    fn test_file_stream() {
+        let path = std::env::temp_dir().join(format!("csr_stream_{}.txt", std::process::id()));
+        let stream = ReplyStream::file(&path).unwrap();
+        for i in 0..1000 {
+            stream.line_fmt(format_args!("entity {i}"));
+        }
+        drop(stream);
+
+        let text = std::fs::read_to_string(&path).unwrap();
+        let _ = std::fs::remove_file(&path);
+        assert_eq!(text.lines().count(), 1000);
+        assert_eq!(text.lines().last(), Some("entity 999"));
+    }
+}
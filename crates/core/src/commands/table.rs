@@ -0,0 +1,240 @@
+//! Command name index
+//!
+//! Command names are looked up by a case-insensitive 64-bit hash
+//! ([`name_hash`]) in an open-addressed table. Every name a command can be
+//! called by is an entry: its full name for the console, and its short
+//! name (`ping` for `csr_ping`) for chat. Entries are added when the
+//! command is registered, so a lookup is one hash of the borrowed name and
+//! a short probe, with no allocation and no prefix handling.
+
+use std::iter;
+
+use super::manager::CommandKey;
+use crate::schema::hash::{fnv1a_64, fnv1a_64_lowercase};
+
+/// Case-insensitive 64-bit hash of a command name
+///
+/// ASCII names are folded byte by byte; other UTF-8 names are folded with
+/// Unicode lowercasing, one character at a time.
+pub(crate) fn name_hash(name: &[u8]) -> u64 {
+    if name.is_ascii() {
+        return fnv1a_64_lowercase(name);
+    }
+    let Ok(name) = std::str::from_utf8(name) else {
+        // Can't be a registered name
+        return fnv1a_64(name);
+    };
+
+    const FNV_PRIME: u64 = 0x00000100000001B3;
+    let mut hash = fnv1a_64(b"");
+    let mut buf = [0u8; 4];
+    for c in name.chars().flat_map(char::to_lowercase) {
+        for &byte in c.encode_utf8(&mut buf).as_bytes() {
+            hash ^= byte as u64;
+            hash = hash.wrapping_mul(FNV_PRIME);
+        }
+    }
+    hash
+}
+
+/// Case-insensitive name comparison, consistent with [`name_hash`]
+pub(crate) fn names_match(a: &str, b: &str) -> bool {
+    if a.is_ascii() && b.is_ascii() {
+        return a.eq_ignore_ascii_case(b);
+    }
+    a.chars()
+        .flat_map(char::to_lowercase)
+        .eq(b.chars().flat_map(char::to_lowercase))
+}
+
+/// What an entry's name calls the command by
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(super) enum NameKind {
+    /// Full name, for the console
+    Console,
+    /// Short name, for chat
+    Chat,
+}
+
+#[derive(Clone, Copy)]
+struct Entry {
+    hash: u64,
+    kind: NameKind,
+    key: CommandKey,
+}
+
+/// Open-addressed (linear probing) table of command names
+///
+/// Kept at most half full. Different names can share a hash, so lookups
+/// confirm the name through a callback.
+#[derive(Clone)]
+pub(super) struct NameTable {
+    slots: Box<[Option<Entry>]>,
+    len: usize,
+}
+
+impl NameTable {
+    const MIN_CAPACITY: usize = 64;
+
+    pub(super) fn new() -> Self {
+        Self {
+            slots: Box::new([]),
+            len: 0,
+        }
+    }
+
+    fn mask(&self) -> usize {
+        self.slots.len() - 1
+    }
+
+    /// Slots from the hash's home slot onwards, up to the first empty one
+    fn probe(&self, hash: u64) -> impl Iterator<Item = (usize, &Entry)> {
+        let mask = self.slots.len().wrapping_sub(1);
+        let mut index = hash as usize;
+        iter::from_fn(move || {
+            index &= mask;
+            let entry = self.slots.get(index)?.as_ref()?;
+            let found = (index, entry);
+            index += 1;
+            Some(found)
+        })
+        .take(self.slots.len())
+    }
+
+    /// Find the command a name refers to
+    ///
+    /// `matches` confirms the name of a command whose entry has the hash.
+    pub(super) fn find(
+        &self,
+        hash: u64,
+        kind: NameKind,
+        mut matches: impl FnMut(CommandKey) -> bool,
+    ) -> Option<CommandKey> {
+        self.probe(hash)
+            .find(|(_, e)| e.hash == hash && e.kind == kind && matches(e.key))
+            .map(|(_, e)| e.key)
+    }
+
+    /// Check if any name of this kind has the hash
+    pub(super) fn contains_hash(&self, hash: u64, kind: NameKind) -> bool {
+        self.probe(hash)
+            .any(|(_, e)| e.hash == hash && e.kind == kind)
+    }
+
+    /// Add a name for a command
+    pub(super) fn insert(&mut self, hash: u64, kind: NameKind, key: CommandKey) {
+        if (self.len + 1) * 2 > self.slots.len() {
+            self.grow();
+        }
+        self.place(Entry { hash, kind, key });
+        self.len += 1;
+    }
+
+    /// Remove a command's name (false if it wasn't there)
+    pub(super) fn remove(&mut self, hash: u64, kind: NameKind, key: CommandKey) -> bool {
+        let Some(mut hole) = self
+            .probe(hash)
+            .find(|(_, e)| e.hash == hash && e.kind == kind && e.key == key)
+            .map(|(index, _)| index)
+        else {
+            return false;
+        };
+        self.slots[hole] = None;
+        self.len -= 1;
+
+        // Shift later entries of the run back so probes still reach them
+        let mask = self.mask();
+        let mut index = hole;
+        loop {
+            index = (index + 1) & mask;
+            let Some(entry) = self.slots[index] else {
+                return true;
+            };
+            let home = entry.hash as usize & mask;
+            // Move unless its home lies in (hole, index]
+            if (index.wrapping_sub(home) & mask) >= (index.wrapping_sub(hole) & mask) {
+                self.slots[hole] = Some(entry);
+                self.slots[index] = None;
+                hole = index;
+            }
+        }
+    }
+
+    fn place(&mut self, entry: Entry) {
+        let mask = self.mask();
+        let mut index = entry.hash as usize & mask;
+        while self.slots[index].is_some() {
+            index = (index + 1) & mask;
+        }
+        self.slots[index] = Some(entry);
+    }
+
+    fn grow(&mut self) {
+        let capacity = (self.slots.len() * 2).max(Self::MIN_CAPACITY);
+        let old = std::mem::replace(&mut self.slots, vec![None; capacity].into_boxed_slice());
+        for entry in old.iter().flatten() {
+            self.place(*entry);
+        }
+    }
+
+    /// Number of names
+    #[cfg(test)]
+    pub(super) fn len(&self) -> usize {
+        self.len
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use slotmap::SlotMap;
+
+    #[test]
+    fn test_name_hash() {
+        assert_eq!(name_hash(b"CSR_Ping"), name_hash(b"csr_ping"));
+        assert_ne!(name_hash(b"csr_ping"), name_hash(b"css_ping"));
+        assert_eq!(name_hash("Ünï".as_bytes()), name_hash("ünï".as_bytes()));
+        assert!(names_match("CSR_Ping", "csr_ping"));
+        assert!(names_match("Ünï", "ünï"));
+        assert!(!names_match("ünï", "uni"));
+    }
+
+    #[test]
+    fn test_name_table() {
+        let mut keys: SlotMap<CommandKey, u64> = SlotMap::with_key();
+        let mut table = NameTable::new();
+        assert_eq!(table.find(1, NameKind::Console, |_| true), None);
+
+        // Enough names to grow several times, with colliding hashes mixed in
+        let entries: Vec<(u64, CommandKey)> = (0..2000u64)
+            .map(|i| {
+                let hash = if i % 7 == 0 {
+                    42
+                } else {
+                    name_hash(format!("csr_{i}").as_bytes())
+                };
+                (hash, keys.insert(i))
+            })
+            .collect();
+        for &(hash, key) in &entries {
+            table.insert(hash, NameKind::Console, key);
+        }
+        assert_eq!(table.len(), entries.len());
+        assert!(!table.contains_hash(42, NameKind::Chat));
+
+        for &(hash, key) in &entries {
+            assert_eq!(table.find(hash, NameKind::Console, |k| k == key), Some(key));
+        }
+
+        // Removing every other entry keeps the rest reachable
+        for &(hash, key) in entries.iter().step_by(2) {
+            assert!(table.remove(hash, NameKind::Console, key));
+            assert!(!table.remove(hash, NameKind::Console, key));
+        }
+        for (i, &(hash, key)) in entries.iter().enumerate() {
+            let found = table.find(hash, NameKind::Console, |k| k == key);
+            assert_eq!(found.is_some(), i % 2 == 1);
+        }
+        assert_eq!(table.len(), entries.len() / 2);
+    }
+}
@@ -0,0 +1,364 @@
+//! Pre-compiled message templates
+//!
+//! A template such as `"{green}[Server]{default} Welcome, {name}!"` is
+//! parsed once, at load, into literal text and argument slots. Color names
+//! are resolved to chat color bytes at that point. Rendering then only
+//! copies literal bytes and formats the arguments.
+//!
+//! Rendering writes into a thread-local buffer that already ends in the NUL
+//! terminator, so the result goes straight to `ClientPrint` without a
+//! `CString` allocation per message.
+//!
+//! ```ignore
+//! use cs2rust_core::commands::{intern_template, HudDestination};
+//!
+//! let welcome = intern_template("{green}Welcome{default}, {name}!", &["name"])?;
+//! welcome.print_all(HudDestination::Talk, &[&player.name_string()]);
+//! ```
+//!
+//! Use `{{` and `}}` for literal braces.
+
+use std::cell::RefCell;
+use std::collections::HashMap;
+use std::ffi::{c_void, CStr};
+use std::fmt::{self, Display, Write as _};
+use std::sync::{Arc, LazyLock};
+
+use parking_lot::RwLock;
+
+use super::print::{self, HudDestination};
+
+/// Chat color names usable as `{color}` placeholders, with their control byte
+pub const CHAT_COLORS: &[(&str, u8)] = &[
+    ("default", 0x01),
+    ("white", 0x01),
+    ("darkred", 0x02),
+    ("lightpurple", 0x03),
+    ("green", 0x04),
+    ("olive", 0x05),
+    ("lime", 0x06),
+    ("red", 0x07),
+    ("grey", 0x08),
+    ("yellow", 0x09),
+    ("silver", 0x0A),
+    ("bluegrey", 0x0A),
+    ("blue", 0x0B),
+    ("darkblue", 0x0C),
+    ("purple", 0x0E),
+    ("lightred", 0x0F),
+    ("gold", 0x10),
+];
+
+/// Template compilation errors
+#[derive(Debug, Clone, PartialEq, Eq, thiserror::Error)]
+pub enum TemplateError {
+    /// A placeholder that is neither a color nor a declared argument
+    #[error("Unknown placeholder '{{{0}}}'")]
+    UnknownPlaceholder(String),
+
+    /// A `{` without its `}`
+    #[error("Unclosed '{{' at byte {0}")]
+    Unclosed(usize),
+
+    /// A `}` without its `{` (use `}}` for a literal brace)
+    #[error("Unmatched '}}' at byte {0}")]
+    Unmatched(usize),
+
+    /// The template text contains a NUL byte
+    #[error("Template contains a null byte")]
+    NulByte,
+}
+
+/// A compiled piece of a template
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Segment {
+    /// Range of the template's literal text
+    Text(u32, u32),
+    /// Index into the render arguments
+    Arg(u16),
+}
+
+/// A message template compiled into literal text and argument slots
+#[derive(Debug, Clone)]
+pub struct MessageTemplate {
+    /// All literal text, colors already resolved
+    text: Box<str>,
+    segments: Box<[Segment]>,
+    /// Argument names, in render argument order
+    args: Box<[Box<str>]>,
+}
+
+impl MessageTemplate {
+    /// Compile a template
+    ///
+    /// `args` names the `{placeholders}` filled at render time, in the order
+    /// their values are passed. Any other placeholder must be a color from
+    /// [`CHAT_COLORS`].
+    pub fn compile(source: &str, args: &[&str]) -> Result<Self, TemplateError> {
+        if source.contains('\0') {
+            return Err(TemplateError::NulByte);
+        }
+
+        let mut text = String::with_capacity(source.len());
+        let mut segments = Vec::new();
+        let mut literal_start = 0;
+        let mut rest = source;
+
+        // Close the current literal run, if any
+        let flush = |text: &String, start: &mut usize, segments: &mut Vec<Segment>| {
+            if text.len() > *start {
+                segments.push(Segment::Text(*start as u32, text.len() as u32));
+                *start = text.len();
+            }
+        };
+
+        while let Some(at) = rest.find(['{', '}']) {
+            let offset = source.len() - rest.len() + at;
+            text.push_str(&rest[..at]);
+            let tail = &rest[at..];
+
+            if let Some(after) = tail.strip_prefix("{{") {
+                text.push('{');
+                rest = after;
+            } else if let Some(after) = tail.strip_prefix("}}") {
+                text.push('}');
+                rest = after;
+            } else if tail.starts_with('}') {
+                return Err(TemplateError::Unmatched(offset));
+            } else {
+                let end = tail.find('}').ok_or(TemplateError::Unclosed(offset))?;
+                let name = &tail[1..end];
+                rest = &tail[end + 1..];
+
+                if let Some(index) = args.iter().position(|arg| *arg == name) {
+                    flush(&text, &mut literal_start, &mut segments);
+                    segments.push(Segment::Arg(index as u16));
+                } else if let Some(&(_, byte)) = CHAT_COLORS
+                    .iter()
+                    .find(|(color, _)| color.eq_ignore_ascii_case(name))
+                {
+                    text.push(byte as char);
+                } else {
+                    return Err(TemplateError::UnknownPlaceholder(name.to_string()));
+                }
+            }
+        }
+        text.push_str(rest);
+        flush(&text, &mut literal_start, &mut segments);
+
+        Ok(Self {
+            text: text.into_boxed_str(),
+            segments: segments.into_boxed_slice(),
+            args: args.iter().map(|&arg| arg.into()).collect(),
+        })
+    }
+
+    /// Argument names, in render argument order
+    pub fn arg_names(&self) -> impl Iterator<Item = &str> {
+        self.args.iter().map(|arg| &**arg)
+    }
+
+    /// Render into `buf`, NUL-terminated
+    ///
+    /// Missing arguments render as nothing; NUL bytes in argument values
+    /// are removed.
+    fn render_into(&self, buf: &mut Vec<u8>, args: &[&dyn Display]) {
+        buf.clear();
+        buf.reserve(self.text.len() + 1);
+
+        let mut has_args = false;
+        for segment in self.segments.iter() {
+            match *segment {
+                Segment::Text(start, end) => {
+                    buf.extend_from_slice(&self.text.as_bytes()[start as usize..end as usize])
+                }
+                Segment::Arg(index) => {
+                    if let Some(arg) = args.get(index as usize) {
+                        let _ = write!(ByteWriter(buf), "{}", arg);
+                        has_args = true;
+                    }
+                }
+            }
+        }
+
+        if has_args && buf.contains(&0) {
+            buf.retain(|&b| b != 0);
+        }
+        buf.push(0);
+    }
+
+    /// Render into the thread's buffer and pass the result to `f`
+    pub fn render_with<R>(&self, args: &[&dyn Display], f: impl FnOnce(&CStr) -> R) -> R {
+        RENDER_BUFFER.with(|cell| match cell.try_borrow_mut() {
+            Ok(mut buf) => {
+                self.render_into(&mut buf, args);
+                f(rendered(&buf))
+            }
+            // Rendering from inside `f`: use a one-off buffer
+            Err(_) => {
+                let mut buf = Vec::new();
+                self.render_into(&mut buf, args);
+                f(rendered(&buf))
+            }
+        })
+    }
+
+    /// Render to an owned string
+    pub fn render(&self, args: &[&dyn Display]) -> String {
+        self.render_with(args, |text| text.to_string_lossy().into_owned())
+    }
+
+    /// Render and print to a player right away
+    ///
+    /// # Safety
+    /// Player pointer must be valid or null.
+    pub unsafe fn print_to(
+        &self,
+        player: *mut c_void,
+        dest: HudDestination,
+        args: &[&dyn Display],
+    ) {
+        self.render_with(args, |text| print::client_print_c(player, dest, text));
+    }
+
+    /// Render and print to all players right away
+    pub fn print_all(&self, dest: HudDestination, args: &[&dyn Display]) {
+        self.render_with(args, |text| print::client_print_all_c(dest, text));
+    }
+
+    /// Render and queue for a player (see [`queue_print`](super::queue_print))
+    pub fn queue_to(&self, slot: i32, dest: HudDestination, args: &[&dyn Display]) {
+        self.render_with(args, |text| super::queue_print(slot, dest, as_str(text)));
+    }
+
+    /// Render and queue for all players (see [`queue_print_all`](super::queue_print_all))
+    pub fn queue_all(&self, dest: HudDestination, args: &[&dyn Display]) {
+        self.render_with(args, |text| super::queue_print_all(dest, as_str(text)));
+    }
+}
+
+thread_local! {
+    /// Reused render output
+    static RENDER_BUFFER: RefCell<Vec<u8>> = const { RefCell::new(Vec::new()) };
+}
+
+/// `fmt::Write` into a byte buffer
+struct ByteWriter<'a>(&'a mut Vec<u8>);
+
+impl fmt::Write for ByteWriter<'_> {
+    fn write_str(&mut self, s: &str) -> fmt::Result {
+        self.0.extend_from_slice(s.as_bytes());
+        Ok(())
+    }
+}
+
+fn rendered(buf: &[u8]) -> &CStr {
+    // Safety: render_into removes interior NULs and terminates the buffer
+    unsafe { CStr::from_bytes_with_nul_unchecked(buf) }
+}
+
+fn as_str(text: &CStr) -> &str {
+    // Safety: rendered from UTF-8 literals and `Display` output, and
+    // removing NUL bytes keeps it valid
+    unsafe { std::str::from_utf8_unchecked(text.to_bytes()) }
+}
+
+/// Compiled templates by source text (one per argument name list)
+static TEMPLATES: LazyLock<RwLock<HashMap<Box<str>, Vec<Arc<MessageTemplate>>>>> =
+    LazyLock::new(|| RwLock::new(HashMap::new()));
+
+fn find_interned(
+    templates: &HashMap<Box<str>, Vec<Arc<MessageTemplate>>>,
+    source: &str,
+    args: &[&str],
+) -> Option<Arc<MessageTemplate>> {
+    templates
+        .get(source)?
+        .iter()
+        .find(|template| template.arg_names().eq(args.iter().copied()))
+        .cloned()
+}
+
+/// Get a compiled template, compiling it on first use
+///
+/// Templates are interned: the same source and argument names always give
+/// the same compiled template, so plugins can call this where they print
+/// without compiling again.
+pub fn intern_template(source: &str, args: &[&str]) -> Result<Arc<MessageTemplate>, TemplateError> {
+    if let Some(template) = find_interned(&TEMPLATES.read(), source, args) {
+        return Ok(template);
+    }
+
+    let template = Arc::new(MessageTemplate::compile(source, args)?);
+    let mut templates = TEMPLATES.write();
+    if let Some(existing) = find_interned(&templates, source, args) {
+        return Ok(existing);
+    }
+    templates
+        .entry(source.into())
+        .or_default()
+        .push(template.clone());
+    Ok(template)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_compile_and_render() {
+        let template = MessageTemplate::compile(
+            "{green}[Server]{Default} {name} has {kills} kills",
+            &["name", "kills"],
+        )
+        .unwrap();
+        assert_eq!(template.arg_names().collect::<Vec<_>>(), ["name", "kills"]);
+        assert_eq!(
+            template.render(&[&"bob", &12]),
+            "\x04[Server]\x01 bob has 12 kills"
+        );
+
+        template.render_with(&[&"a\0b", &1], |text| {
+            assert_eq!(text.to_bytes(), b"\x04[Server]\x01 ab has 1 kills");
+        });
+
+        // Missing arguments render as nothing
+        assert_eq!(
+            template.render(&[&"bob"]),
+            "\x04[Server]\x01 bob has  kills"
+        );
+
+        let braces = MessageTemplate::compile("{{literal}} {x}", &["x"]).unwrap();
+        assert_eq!(braces.render(&[&'!']), "{literal} !");
+    }
+
+    #[test]
+    fn test_compile_errors() {
+        assert_eq!(
+            MessageTemplate::compile("hi {nmae}", &["name"]).unwrap_err(),
+            TemplateError::UnknownPlaceholder("nmae".to_string())
+        );
+        assert_eq!(
+            MessageTemplate::compile("hi {name", &["name"]).unwrap_err(),
+            TemplateError::Unclosed(3)
+        );
+        assert_eq!(
+            MessageTemplate::compile("hi }", &[]).unwrap_err(),
+            TemplateError::Unmatched(3)
+        );
+        assert_eq!(
+            MessageTemplate::compile("a\0", &[]).unwrap_err(),
+            TemplateError::NulByte
+        );
+    }
+
+    #[test]
+    fn test_intern_template() {
+        let a = intern_template("{red}{x}", &["x"]).unwrap();
+        let b = intern_template("{red}{x}", &["x"]).unwrap();
+        let c = intern_template("{red}{x}", &["y", "x"]).unwrap();
+        assert!(Arc::ptr_eq(&a, &b));
+        assert!(!Arc::ptr_eq(&a, &c));
+        assert_eq!(c.render(&[&1, &2]), "\x072");
+    }
+}
@@ -2,7 +2,7 @@
 //!
 //! Handles resolving paths for configuration files based on the plugin's location.
 
-use std::path::PathBuf;
+use std::path::{Component, Path, PathBuf};
 
 use super::{ConfigError, ConfigResult};
 
@@ -49,10 +49,51 @@ pub fn core_config_path() -> ConfigResult<PathBuf> {
     Ok(configs_dir()?.join("core.toml"))
 }
 
+/// Returns the path for a file named in a server command argument.
+///
+/// Path: `game/csgo/addons/cs2rust/{dir}/{name}`
+///
+/// Returns `None` if `name` is empty, absolute, or has `..` components, so a
+/// command argument can't point outside `dir`.
+pub fn data_file_path(dir: &str, name: &str) -> Option<PathBuf> {
+    let base = cs2rust_base_dir()
+        .map(|base| base.join(dir))
+        .unwrap_or_else(|_| PathBuf::from("."));
+    contained_path(&base, name)
+}
+
+/// Join `name` onto `base` if it stays inside it
+fn contained_path(base: &Path, name: &str) -> Option<PathBuf> {
+    let name = Path::new(name);
+    let contained = name.components().next().is_some()
+        && name
+            .components()
+            .all(|component| matches!(component, Component::Normal(_) | Component::CurDir));
+    contained.then(|| base.join(name))
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
 
+    #[test]
+    fn test_contained_path() {
+        let base = Path::new("/game/csgo/addons/cs2rust/captures");
+        assert_eq!(
+            contained_path(base, "status.txt"),
+            Some(base.join("status.txt"))
+        );
+        assert_eq!(
+            contained_path(base, "./daily/status.txt"),
+            Some(base.join("./daily/status.txt"))
+        );
+
+        assert_eq!(contained_path(base, ""), None);
+        assert_eq!(contained_path(base, "/etc/passwd"), None);
+        assert_eq!(contained_path(base, "../configs/core.toml"), None);
+        assert_eq!(contained_path(base, "daily/../../bin/cs2rust.so"), None);
+    }
+
     #[test]
     fn test_plugin_config_path_format() {
         // This test verifies path construction logic
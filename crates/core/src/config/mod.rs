@@ -32,7 +32,9 @@ mod loader;
 
 use serde::{de::DeserializeOwned, Deserialize, Serialize};
 
-pub use loader::{configs_dir, core_config_path, cs2rust_base_dir, plugin_config_path};
+pub use loader::{
+    configs_dir, core_config_path, cs2rust_base_dir, data_file_path, plugin_config_path,
+};
 
 /// Configuration system errors
 #[derive(Debug, thiserror::Error)]
@@ -142,8 +144,13 @@ pub struct CoreConfig {
     /// Config version for future migration support
     pub version: u32,
 
-    /// Enable debug logging
+    /// Enable debug logging (overrides `log_filter` with `debug`)
     pub debug: bool,
+
+    /// Log filter directives, in `RUST_LOG` syntax (e.g. `info,cs2rust_core::events=debug`)
+    ///
+    /// Applied at load and whenever the config is reloaded with `csr_log reload`.
+    pub log_filter: String,
 }
 
 impl Default for CoreConfig {
@@ -151,6 +158,7 @@ impl Default for CoreConfig {
         Self {
             version: 1,
             debug: false,
+            log_filter: "info".to_string(),
         }
     }
 }
@@ -189,6 +197,15 @@ impl CoreConfig {
         Ok(())
     }
 
+    /// Effective log filter directives for this config
+    pub fn log_directives(&self) -> &str {
+        if self.debug {
+            "debug"
+        } else {
+            &self.log_filter
+        }
+    }
+
     /// Reload core config from file.
     pub fn reload(&mut self) -> ConfigResult<()> {
         let path = core_config_path()?;
@@ -227,6 +244,17 @@ mod tests {
         let config = CoreConfig::default();
         assert_eq!(config.version, 1);
         assert!(!config.debug);
+        assert_eq!(config.log_directives(), "info");
+    }
+
+    #[test]
+    fn test_core_config_log_directives() {
+        let mut config: CoreConfig = toml::from_str("log_filter = \"warn,cs2rust_core=debug\"").unwrap();
+        assert_eq!(config.version, 1);
+        assert_eq!(config.log_directives(), "warn,cs2rust_core=debug");
+
+        config.debug = true;
+        assert_eq!(config.log_directives(), "debug");
     }
 
     #[test]
@@ -234,6 +262,7 @@ mod tests {
         let config = CoreConfig {
             version: 2,
             debug: true,
+            ..Default::default()
         };
 
         let toml_str = toml::to_string_pretty(&config).unwrap();
@@ -88,9 +88,9 @@ pub use handle::{INVALID_EHANDLE_INDEX, MAX_EDICTS, MAX_EDICT_BITS, NUM_SERIAL_N
 
 // Re-export player utilities
 pub use player::{
-    find_player_by_steamid, get_all_player_controllers, get_player_controller,
-    get_player_controller_by_index, get_player_controller_by_userid, get_players, player_count,
-    PlayerConnectedState, MAX_PLAYERS,
+    cached_player_controller, find_player_by_steamid, get_all_player_controllers,
+    get_player_controller, get_player_controller_by_index, get_player_controller_by_userid,
+    get_players, player_count, resolve_player_controller, PlayerConnectedState, MAX_PLAYERS,
 };
 
 // Re-export entity system functions
@@ -26,6 +26,7 @@
 
 use std::ffi::c_void;
 use std::marker::PhantomData;
+use std::sync::atomic::{AtomicPtr, Ordering};
 
 use cs2rust_macros::SchemaClass;
 
@@ -323,6 +324,98 @@ pub fn player_count() -> usize {
     get_players().count()
 }
 
+// ============================================================================
+// Player Slot Table
+// ============================================================================
+
+/// Controller pointer per slot (null = not resolved yet)
+///
+/// Filled on first lookup and cleared when the slot's client disconnects,
+/// its controller is deleted, or the map ends, so an entry is never a
+/// dangling pointer.
+static PLAYER_SLOTS: [AtomicPtr<c_void>; MAX_PLAYERS] =
+    [const { AtomicPtr::new(std::ptr::null_mut()) }; MAX_PLAYERS];
+
+/// Get a player controller by slot through the slot table
+///
+/// Same result as [`get_player_controller`], but after the first lookup
+/// of a slot it's one atomic load instead of an entity system lookup. Meant
+/// for hot paths like command dispatch.
+pub fn cached_player_controller(slot: i32) -> Option<PlayerController> {
+    let entry = PLAYER_SLOTS.get(usize::try_from(slot).ok()?)?;
+
+    let ptr = entry.load(Ordering::Acquire);
+    if !ptr.is_null() {
+        // Safety: entries are cleared before their entity goes away
+        return unsafe { PlayerController::from_ptr(ptr) };
+    }
+
+    let controller = get_player_controller(slot)?;
+    entry.store(controller.as_ptr(), Ordering::Release);
+    Some(controller)
+}
+
+/// Resolve a controller pointer handed over by the engine
+///
+/// Returns the controller with its slot if the pointer is the controller
+/// the entity system has for that slot.
+///
+/// # Safety
+///
+/// `ptr` must be null or point to a live entity.
+pub unsafe fn resolve_player_controller(ptr: *mut c_void) -> Option<(PlayerController, i32)> {
+    if ptr.is_null() {
+        return None;
+    }
+    let slot = super::entity_ref::EntityRef::read_entity_index_from_ptr(ptr) - 1;
+
+    let controller = cached_player_controller(slot)?;
+    if controller.as_ptr() == ptr {
+        return Some((controller, slot));
+    }
+
+    // Stale entry, look the slot up again
+    forget_player_slot(slot);
+    let controller = cached_player_controller(slot)?;
+    (controller.as_ptr() == ptr).then_some((controller, slot))
+}
+
+/// Clear a slot's table entry (its client left)
+pub(crate) fn forget_player_slot(slot: i32) {
+    if let Some(entry) = usize::try_from(slot).ok().and_then(|i| PLAYER_SLOTS.get(i)) {
+        entry.store(std::ptr::null_mut(), Ordering::Release);
+    }
+}
+
+/// Clear the table entry holding a deleted entity, if any
+///
+/// A controller can only be cached in the slot matching its entity index,
+/// so this checks one entry whatever the entity is. `ptr` must be null or
+/// point to a live entity.
+pub(crate) fn forget_player_controller(ptr: *mut c_void) {
+    let slot = super::entity_ref::EntityRef::read_entity_index_from_ptr(ptr) - 1;
+    forget_player_entry(slot, ptr);
+}
+
+/// Clear a slot's entry if it still holds `ptr`
+fn forget_player_entry(slot: i32, ptr: *mut c_void) {
+    if let Some(entry) = usize::try_from(slot).ok().and_then(|i| PLAYER_SLOTS.get(i)) {
+        let _ = entry.compare_exchange(
+            ptr,
+            std::ptr::null_mut(),
+            Ordering::AcqRel,
+            Ordering::Relaxed,
+        );
+    }
+}
+
+/// Clear the whole table (map change)
+pub(crate) fn clear_player_slots() {
+    for entry in &PLAYER_SLOTS {
+        entry.store(std::ptr::null_mut(), Ordering::Release);
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -404,4 +497,29 @@ mod tests {
         // Slot 63 should be entity index 64
         assert_eq!(63 + 1, 64);
     }
+
+    #[test]
+    fn test_player_slot_table() {
+        // Never dereferenced, only compared
+        let fake = 0x1000 as *mut c_void;
+        PLAYER_SLOTS[7].store(fake, Ordering::Release);
+        PLAYER_SLOTS[8].store(fake, Ordering::Release);
+
+        assert_eq!(cached_player_controller(7).unwrap().as_ptr(), fake);
+        assert!(cached_player_controller(-1).is_none());
+        assert!(cached_player_controller(MAX_PLAYERS as i32).is_none());
+
+        forget_player_slot(8);
+        assert!(PLAYER_SLOTS[8].load(Ordering::Acquire).is_null());
+
+        forget_player_entry(7, 0x2000 as *mut c_void);
+        assert_eq!(PLAYER_SLOTS[7].load(Ordering::Acquire), fake);
+        forget_player_entry(-1, fake);
+        forget_player_entry(MAX_PLAYERS as i32, fake);
+        assert_eq!(PLAYER_SLOTS[7].load(Ordering::Acquire), fake);
+        forget_player_entry(7, fake);
+        assert!(PLAYER_SLOTS[7].load(Ordering::Acquire).is_null());
+        // Null (index -1) touches no entry
+        forget_player_controller(std::ptr::null_mut());
+    }
 }
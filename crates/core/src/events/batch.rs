@@ -0,0 +1,222 @@
+//! Per-frame batched event delivery
+//!
+//! Subscribers registered with
+//! [`register_event_batched`](super::register_event_batched) don't run when
+//! an event fires. The dispatcher appends the fields they declared to a
+//! per-event arena, and at the end of each GameFrame every subscriber is
+//! called once with an [`EventBatch`] of that frame's events. Hot combat
+//! events then cost one field capture each instead of one call per
+//! subscriber.
+//!
+//! The arena keeps its buffers between frames, so steady-state batching
+//! doesn't allocate.
+
+use super::raw::GameEventRef;
+use super::snapshot::{CapturedField, EventFieldKind};
+
+/// A captured field value (strings point into the arena's string buffer)
+#[derive(Debug, Clone, Copy)]
+enum BatchValue {
+    Bool(bool),
+    Int(i32),
+    Uint64(u64),
+    Float(f32),
+    /// Byte range in `BatchArena::strings` (empty for missing keys)
+    String(u32, u32),
+}
+
+/// Events captured during one frame
+#[derive(Debug, Default)]
+pub(super) struct BatchArena {
+    /// Start of each event in `values`
+    starts: Vec<u32>,
+    /// Field index (into the hook's batch fields) and value
+    values: Vec<(u16, BatchValue)>,
+    strings: String,
+}
+
+impl BatchArena {
+    pub(super) fn is_empty(&self) -> bool {
+        self.starts.is_empty()
+    }
+
+    pub(super) fn clear(&mut self) {
+        self.starts.clear();
+        self.values.clear();
+        self.strings.clear();
+    }
+
+    /// Append the values of `fields` read from `event`
+    pub(super) fn capture(&mut self, event: &GameEventRef, fields: &[CapturedField]) {
+        self.starts.push(self.values.len() as u32);
+
+        for (index, captured) in fields.iter().enumerate() {
+            let key = captured.key();
+            let value = match captured.field().kind {
+                EventFieldKind::Bool => BatchValue::Bool(event.get_bool_c(key, false)),
+                EventFieldKind::Int => BatchValue::Int(event.get_int_c(key, 0)),
+                EventFieldKind::Uint64 => BatchValue::Uint64(event.get_uint64_c(key, 0)),
+                EventFieldKind::Float => BatchValue::Float(event.get_float_c(key, 0.0)),
+                EventFieldKind::String => {
+                    let value = event.get_str_c(key).unwrap_or("");
+                    let start = self.strings.len() as u32;
+                    self.strings.push_str(value);
+                    BatchValue::String(start, value.len() as u32)
+                }
+            };
+            self.values.push((index as u16, value));
+        }
+    }
+}
+
+/// One frame's worth of an event, as passed to batched subscribers
+#[derive(Clone, Copy)]
+pub struct EventBatch<'a> {
+    fields: &'a [CapturedField],
+    arena: &'a BatchArena,
+}
+
+impl<'a> EventBatch<'a> {
+    pub(super) fn new(fields: &'a [CapturedField], arena: &'a BatchArena) -> Self {
+        Self { fields, arena }
+    }
+
+    /// Number of events in the batch
+    pub fn len(&self) -> usize {
+        self.arena.starts.len()
+    }
+
+    /// Check if the batch has no events
+    pub fn is_empty(&self) -> bool {
+        self.arena.starts.is_empty()
+    }
+
+    /// Get one event of the batch
+    pub fn get(&self, index: usize) -> Option<BatchedEvent<'a>> {
+        let start = *self.arena.starts.get(index)? as usize;
+        let end = self
+            .arena
+            .starts
+            .get(index + 1)
+            .map_or(self.arena.values.len(), |&end| end as usize);
+        Some(BatchedEvent {
+            fields: self.fields,
+            values: &self.arena.values[start..end],
+            strings: &self.arena.strings,
+        })
+    }
+
+    /// Iterate over the events in the order they fired
+    pub fn iter(&self) -> impl Iterator<Item = BatchedEvent<'a>> + '_ {
+        (0..self.len()).filter_map(|index| self.get(index))
+    }
+}
+
+/// One event in an [`EventBatch`]
+///
+/// Getters mirror [`EventSnapshot`](super::EventSnapshot)'s and return
+/// `default` for fields no batched subscriber declared.
+#[derive(Clone, Copy)]
+pub struct BatchedEvent<'a> {
+    fields: &'a [CapturedField],
+    values: &'a [(u16, BatchValue)],
+    strings: &'a str,
+}
+
+impl<'a> BatchedEvent<'a> {
+    fn value(&self, key: &str, kind: EventFieldKind) -> Option<BatchValue> {
+        self.values
+            .iter()
+            .find(|(index, _)| {
+                let field = self.fields[*index as usize].field();
+                field.kind == kind && field.name == key
+            })
+            .map(|(_, value)| *value)
+    }
+
+    /// Get a captured boolean value
+    pub fn get_bool(&self, key: &str, default: bool) -> bool {
+        match self.value(key, EventFieldKind::Bool) {
+            Some(BatchValue::Bool(value)) => value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured integer value
+    pub fn get_int(&self, key: &str, default: i32) -> i32 {
+        match self.value(key, EventFieldKind::Int) {
+            Some(BatchValue::Int(value)) => value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured 64-bit unsigned integer value
+    pub fn get_uint64(&self, key: &str, default: u64) -> u64 {
+        match self.value(key, EventFieldKind::Uint64) {
+            Some(BatchValue::Uint64(value)) => value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured float value
+    pub fn get_float(&self, key: &str, default: f32) -> f32 {
+        match self.value(key, EventFieldKind::Float) {
+            Some(BatchValue::Float(value)) => value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured string value (`default` if missing or empty)
+    pub fn get_string(&self, key: &str, default: &'a str) -> &'a str {
+        match self.value(key, EventFieldKind::String) {
+            Some(BatchValue::String(start, len)) if len > 0 => {
+                &self.strings[start as usize..(start + len) as usize]
+            }
+            _ => default,
+        }
+    }
+}
+
+/// Type alias for batched subscriber callbacks
+pub type BatchCallback = Box<dyn Fn(&EventBatch) + Send + Sync>;
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEvent;
+    use crate::events::EventField;
+
+    #[test]
+    fn test_arena_round_trip() {
+        let fields: Vec<_> = [
+            EventField::int("attacker"),
+            EventField::string("weapon"),
+            EventField::float("distance"),
+        ]
+        .into_iter()
+        .filter_map(CapturedField::new)
+        .collect();
+
+        let mut arena = BatchArena::default();
+        for (attacker, weapon) in [(3, "awp"), (5, ""), (7, "deagle")] {
+            let mut event = ReplayEvent::new("player_hurt", 1);
+            event.set_int("attacker", attacker);
+            event.set_string("weapon", weapon);
+            let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+            arena.capture(&event_ref, &fields);
+        }
+
+        let batch = EventBatch::new(&fields, &arena);
+        let seen: Vec<_> = batch
+            .iter()
+            .map(|e| (e.get_int("attacker", -1), e.get_string("weapon", "none")))
+            .collect();
+        assert_eq!(seen, vec![(3, "awp"), (5, "none"), (7, "deagle")]);
+        assert_eq!(batch.get(2).unwrap().get_float("distance", 1.0), 0.0);
+        assert_eq!(batch.get(0).unwrap().get_int("userid", -1), -1);
+        assert!(batch.get(3).is_none());
+
+        arena.clear();
+        assert!(arena.is_empty());
+    }
+}
@@ -0,0 +1,502 @@
+//! Creating and firing game events
+//!
+//! [`create_event`] asks `IGameEventManager2::CreateEvent` for a new event
+//! and wraps it in an [`EventBuilder`]. Firing goes through the manager's
+//! `FireEvent`, so plugin-fired events reach registered handlers like the
+//! engine's own.
+//!
+//! Events fired often (announcements, HUD hints) can be pooled with
+//! [`reserve_events`]: a number of blank events per name is created at the
+//! end of each GameFrame, and `create_event` takes one from the pool before
+//! asking the engine. Creating the event is then off the firing path, and
+//! the event name is converted to a C string once per pool rather than once
+//! per event.
+//!
+//! The pool does not lower the number of engine allocations. `FireEvent`
+//! frees every event it is given and `IGameEvent` has no way to clear its
+//! keys, so each fired event is replaced by a new `CreateEvent` at the end
+//! of the frame. Only builders dropped before any setter ran return their
+//! event to the pool. Names that were never reserved get no pool and are
+//! created on demand.
+
+use std::collections::HashMap;
+use std::ffi::{c_char, c_void, CString};
+use std::ptr::NonNull;
+use std::sync::LazyLock;
+
+use parking_lot::Mutex;
+
+use cs2rust_sdk::{IGameEvent, IGameEventManager2};
+
+use super::key::GameEventKey;
+use super::manager::{vtable, EVENTS};
+use super::raw::GameEventRef;
+use crate::schema::hash::hash_str;
+
+/// Most events kept ready per event name
+pub const MAX_POOLED_EVENTS: usize = 64;
+
+/// Function pointer types for IGameEventManager2 methods
+type CreateEventFn =
+    extern "C" fn(*mut IGameEventManager2, *const c_char, bool, *mut i32) -> *mut IGameEvent;
+type FireEventFn = extern "C" fn(*mut IGameEventManager2, *mut IGameEvent, bool) -> bool;
+type FireEventClientSideFn = extern "C" fn(*mut IGameEventManager2, *mut IGameEvent) -> bool;
+type FreeEventFn = extern "C" fn(*mut IGameEventManager2, *mut IGameEvent);
+
+/// Get a manager method from its vtable
+///
+/// # Safety
+/// `engine` must point to a live `IGameEventManager2` and `F` must be the
+/// method's signature.
+unsafe fn manager_fn<F: Copy>(engine: NonNull<IGameEventManager2>, index: usize) -> F {
+    let vtable = *(engine.as_ptr() as *const *const *const c_void);
+    std::mem::transmute_copy(&*vtable.add(index))
+}
+
+fn engine_create(engine: NonNull<IGameEventManager2>, name: &CString) -> *mut IGameEvent {
+    unsafe {
+        let create_fn: CreateEventFn = manager_fn(engine, vtable::CREATE_EVENT);
+        create_fn(engine.as_ptr(), name.as_ptr(), true, std::ptr::null_mut())
+    }
+}
+
+fn engine_free(engine: NonNull<IGameEventManager2>, event: *mut IGameEvent) {
+    unsafe {
+        let free_fn: FreeEventFn = manager_fn(engine, vtable::FREE_EVENT);
+        free_fn(engine.as_ptr(), event);
+    }
+}
+
+/// Blank events and the C name for one reserved event name
+struct NamePool {
+    name: CString,
+    /// Events to keep ready (0 = pool is dropped at the next refill)
+    target: usize,
+    events: Vec<NonNull<IGameEvent>>,
+}
+
+/// Per-name event pools
+///
+/// Pooled events belong to the manager that created them; they are
+/// forgotten (not freed) if another manager shows up, since the old one may
+/// already be gone.
+pub(super) struct EventPools {
+    engine: *mut IGameEventManager2,
+    pools: HashMap<u32, NamePool>,
+}
+
+// SAFETY: pooled events are only handed out under the pool's mutex
+unsafe impl Send for EventPools {}
+
+impl EventPools {
+    pub(super) fn new() -> Self {
+        Self {
+            engine: std::ptr::null_mut(),
+            pools: HashMap::new(),
+        }
+    }
+
+    /// Drop pooled events that belong to a previous manager
+    fn check_engine(&mut self, engine: NonNull<IGameEventManager2>) {
+        if self.engine == engine.as_ptr() {
+            return;
+        }
+        let forgotten: usize = self
+            .pools
+            .values_mut()
+            .map(|p| p.events.drain(..).count())
+            .sum();
+        if forgotten > 0 {
+            tracing::debug!(
+                "Game event manager changed, dropped {} pooled events",
+                forgotten
+            );
+        }
+        self.engine = engine.as_ptr();
+    }
+
+    /// The pool reserved for `name`, if any
+    fn pool(&mut self, name: &str) -> Option<&mut NamePool> {
+        self.pools
+            .get_mut(&hash_str(name))
+            .filter(|pool| pool.name.as_bytes() == name.as_bytes())
+    }
+
+    /// Keep `count` blank events of `name` ready
+    ///
+    /// Returns `false` if `name` contains a NUL byte or its hash is already
+    /// taken by another pooled name.
+    pub(super) fn reserve(&mut self, name: &str, count: usize) -> bool {
+        let count = count.min(MAX_POOLED_EVENTS);
+        if let Some(pool) = self.pool(name) {
+            pool.target = count;
+            return true;
+        }
+        let key = hash_str(name);
+        if count == 0 || self.pools.contains_key(&key) {
+            return count == 0;
+        }
+        let Ok(name) = CString::new(name) else {
+            return false;
+        };
+        self.pools.insert(
+            key,
+            NamePool {
+                name,
+                target: count,
+                events: Vec::new(),
+            },
+        );
+        true
+    }
+
+    /// Take a pooled event of `name`, or create one
+    pub(super) fn take(
+        &mut self,
+        engine: NonNull<IGameEventManager2>,
+        name: &str,
+    ) -> Option<NonNull<IGameEvent>> {
+        self.check_engine(engine);
+        if let Some(pool) = self.pool(name) {
+            if let Some(event) = pool.events.pop() {
+                return Some(event);
+            }
+            return NonNull::new(engine_create(engine, &pool.name));
+        }
+        let name = CString::new(name).ok()?;
+        NonNull::new(engine_create(engine, &name))
+    }
+
+    /// Return an unwritten event, freeing it if its pool is full
+    pub(super) fn give_back(
+        &mut self,
+        engine: NonNull<IGameEventManager2>,
+        event: NonNull<IGameEvent>,
+    ) {
+        let same_engine = self.engine == engine.as_ptr();
+        let pool = match unsafe { GameEventRef::from_ptr(event.as_ptr()) } {
+            Some(event) => self.pool(event.get_name()),
+            None => None,
+        };
+        match pool {
+            Some(pool) if same_engine && pool.events.len() < pool.target => pool.events.push(event),
+            _ => engine_free(engine, event.as_ptr()),
+        }
+    }
+
+    /// Create events until every pool holds its target
+    ///
+    /// Events above a lowered target are freed, and pools reserved with a
+    /// count of 0 are dropped.
+    pub(super) fn refill(&mut self, engine: NonNull<IGameEventManager2>) {
+        self.check_engine(engine);
+        self.pools.retain(|_, pool| {
+            while pool.events.len() > pool.target {
+                if let Some(event) = pool.events.pop() {
+                    engine_free(engine, event.as_ptr());
+                }
+            }
+            pool.target > 0
+        });
+        for pool in self.pools.values_mut() {
+            while pool.events.len() < pool.target {
+                match NonNull::new(engine_create(engine, &pool.name)) {
+                    Some(event) => pool.events.push(event),
+                    None => {
+                        tracing::warn!(
+                            "CreateEvent failed for '{}', pool disabled",
+                            pool.name.to_string_lossy()
+                        );
+                        pool.target = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    /// Free every pooled event
+    pub(super) fn release(&mut self, engine: NonNull<IGameEventManager2>) {
+        self.check_engine(engine);
+        for pool in self.pools.values_mut() {
+            for event in pool.events.drain(..) {
+                engine_free(engine, event.as_ptr());
+            }
+        }
+    }
+}
+
+/// Global event pools
+static POOLS: LazyLock<Mutex<EventPools>> = LazyLock::new(|| Mutex::new(EventPools::new()));
+
+/// A created event waiting to be filled in and fired
+///
+/// Setters chain; the `_key` variants take a precomputed [`GameEventKey`]
+/// and don't allocate. Dropping the builder without firing frees the event.
+///
+/// # Example
+///
+/// ```ignore
+/// if let Some(event) = create_event("show_survival_respawn_status") {
+///     event
+///         .set_string("loc_token", "#Announcement")
+///         .set_int("duration", 5)
+///         .fire(false);
+/// }
+/// ```
+pub struct EventBuilder {
+    event: GameEventRef,
+    engine: NonNull<IGameEventManager2>,
+    /// No setter has run (the event can go back to its pool)
+    blank: bool,
+}
+
+impl EventBuilder {
+    fn new(engine: NonNull<IGameEventManager2>, event: NonNull<IGameEvent>) -> Self {
+        Self {
+            event: unsafe { GameEventRef::from_ptr(event.as_ptr()) }
+                .expect("event pointer is non-null"),
+            engine,
+            blank: true,
+        }
+    }
+
+    /// The event being built
+    pub fn event(&self) -> &GameEventRef {
+        &self.event
+    }
+
+    /// Set a boolean value
+    pub fn set_bool(mut self, key: &str, value: bool) -> Self {
+        self.blank = false;
+        self.event.set_bool(key, value);
+        self
+    }
+
+    /// Set an integer value
+    pub fn set_int(mut self, key: &str, value: i32) -> Self {
+        self.blank = false;
+        self.event.set_int(key, value);
+        self
+    }
+
+    /// Set a 64-bit unsigned integer value
+    pub fn set_uint64(mut self, key: &str, value: u64) -> Self {
+        self.blank = false;
+        self.event.set_uint64(key, value);
+        self
+    }
+
+    /// Set a float value
+    pub fn set_float(mut self, key: &str, value: f32) -> Self {
+        self.blank = false;
+        self.event.set_float(key, value);
+        self
+    }
+
+    /// Set a string value
+    pub fn set_string(mut self, key: &str, value: &str) -> Self {
+        self.blank = false;
+        self.event.set_string(key, value);
+        self
+    }
+
+    /// Set a boolean value using a pre-built key
+    pub fn set_bool_key(mut self, key: &GameEventKey, value: bool) -> Self {
+        self.blank = false;
+        self.event.set_bool_key(key, value);
+        self
+    }
+
+    /// Set an integer value using a pre-built key
+    pub fn set_int_key(mut self, key: &GameEventKey, value: i32) -> Self {
+        self.blank = false;
+        self.event.set_int_key(key, value);
+        self
+    }
+
+    /// Set a 64-bit unsigned integer value using a pre-built key
+    pub fn set_uint64_key(mut self, key: &GameEventKey, value: u64) -> Self {
+        self.blank = false;
+        self.event.set_uint64_key(key, value);
+        self
+    }
+
+    /// Set a float value using a pre-built key
+    pub fn set_float_key(mut self, key: &GameEventKey, value: f32) -> Self {
+        self.blank = false;
+        self.event.set_float_key(key, value);
+        self
+    }
+
+    /// Set a string value using a pre-built key
+    pub fn set_string_key(mut self, key: &GameEventKey, value: &str) -> Self {
+        self.blank = false;
+        self.event.set_string_key(key, value);
+        self
+    }
+
+    /// Give up ownership of the event (the engine frees it from here on)
+    fn into_raw(self) -> (NonNull<IGameEventManager2>, *mut IGameEvent) {
+        let parts = (self.engine, self.event.as_ptr());
+        std::mem::forget(self);
+        parts
+    }
+
+    /// Fire the event to every client and to registered handlers
+    ///
+    /// The engine frees the event. Returns `false` if the engine rejected
+    /// it or a pre hook blocked it.
+    pub fn fire(self, dont_broadcast: bool) -> bool {
+        let (engine, event) = self.into_raw();
+        unsafe {
+            let fire_fn: FireEventFn = manager_fn(engine, vtable::FIRE_EVENT);
+            fire_fn(engine.as_ptr(), event, dont_broadcast)
+        }
+    }
+
+    /// Fire the event on the server side only (`FireEventClientSide`)
+    ///
+    /// Registered handlers are not called. The engine frees the event.
+    pub fn fire_client_side(self) -> bool {
+        let (engine, event) = self.into_raw();
+        unsafe {
+            let fire_fn: FireEventClientSideFn = manager_fn(engine, vtable::FIRE_EVENT_CLIENT_SIDE);
+            fire_fn(engine.as_ptr(), event)
+        }
+    }
+}
+
+impl Drop for EventBuilder {
+    fn drop(&mut self) {
+        match NonNull::new(self.event.as_ptr()) {
+            Some(event) if self.blank => POOLS.lock().give_back(self.engine, event),
+            _ => engine_free(self.engine, self.event.as_ptr()),
+        }
+    }
+}
+
+/// Create an event to fill in and fire
+///
+/// Takes a pooled event if [`reserve_events`] set up a pool for `name`.
+/// Returns `None` if the game event manager isn't available yet or the
+/// engine doesn't know the event.
+pub fn create_event(name: &str) -> Option<EventBuilder> {
+    let engine = EVENTS.engine()?;
+    let event = POOLS.lock().take(engine, name);
+    match event {
+        Some(event) => Some(EventBuilder::new(engine, event)),
+        None => {
+            tracing::warn!("CreateEvent failed for '{}'", name);
+            None
+        }
+    }
+}
+
+/// Keep `count` blank events of `name` ready for [`create_event`]
+///
+/// The pool is filled at the end of each GameFrame, up to
+/// [`MAX_POOLED_EVENTS`]. A count of 0 stops pooling the event. Fired
+/// events are freed by the engine, so every event taken from the pool is
+/// replaced by a new one at the end of the frame.
+pub fn reserve_events(name: &str, count: usize) -> bool {
+    POOLS.lock().reserve(name, count)
+}
+
+/// Top up the event pools (called at the end of every GameFrame)
+pub(super) fn refill_pools() {
+    if let Some(engine) = EVENTS.engine() {
+        POOLS.lock().refill(engine);
+    }
+}
+
+/// Free all pooled events
+pub(super) fn release_pools() {
+    if let Some(engine) = EVENTS.engine() {
+        POOLS.lock().release(engine);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEngine;
+
+    #[test]
+    fn test_pool_reuse_and_refill() {
+        let mut engine = ReplayEngine::new();
+        let engine_ptr = NonNull::new(engine.as_ptr()).unwrap();
+        let mut pools = EventPools::new();
+
+        assert!(pools.reserve("round_announce", 2));
+        pools.refill(engine_ptr);
+        assert_eq!(engine.created(), 2);
+
+        let first = pools.take(engine_ptr, "round_announce").unwrap();
+        let second = pools.take(engine_ptr, "round_announce").unwrap();
+        assert_eq!(engine.created(), 2);
+
+        // Pool empty: created on demand
+        let third = pools.take(engine_ptr, "round_announce").unwrap();
+        assert_eq!(engine.created(), 3);
+        let name = unsafe { GameEventRef::from_ptr(third.as_ptr()) }.unwrap();
+        assert_eq!(name.get_name(), "round_announce");
+
+        // Blank events go back up to the target, the rest are freed
+        pools.give_back(engine_ptr, first);
+        pools.give_back(engine_ptr, second);
+        pools.give_back(engine_ptr, third);
+        assert_eq!(engine.freed(), 1);
+
+        pools.refill(engine_ptr);
+        assert_eq!(engine.created(), 3);
+
+        // Lowering the target frees the surplus, 0 drops the pool
+        assert!(pools.reserve("round_announce", 1));
+        pools.refill(engine_ptr);
+        assert_eq!(engine.freed(), 2);
+        assert!(pools.reserve("round_announce", 0));
+        pools.refill(engine_ptr);
+        assert_eq!(engine.freed(), 3);
+        assert!(pools.pools.is_empty());
+    }
+
+    #[test]
+    fn test_unreserved_names_get_no_pool() {
+        let mut engine = ReplayEngine::new();
+        let engine_ptr = NonNull::new(engine.as_ptr()).unwrap();
+        let mut pools = EventPools::new();
+
+        let event = pools.take(engine_ptr, "player_team").unwrap();
+        assert_eq!(engine.created(), 1);
+        assert!(pools.pools.is_empty());
+
+        // No pool to go back to: freed
+        pools.give_back(engine_ptr, event);
+        assert_eq!(engine.freed(), 1);
+        assert!(!pools.reserve("bad\0name", 1));
+    }
+
+    #[test]
+    fn test_builder_fire_and_drop() {
+        let mut engine = ReplayEngine::new();
+        let engine_ptr = NonNull::new(engine.as_ptr()).unwrap();
+        let mut pools = EventPools::new();
+        let key = GameEventKey::new(c"userid");
+
+        let event = pools.take(engine_ptr, "player_team").unwrap();
+        let builder = EventBuilder::new(engine_ptr, event)
+            .set_int_key(&key, 7)
+            .set_string("name", "bot")
+            .set_bool("silent", true);
+        assert_eq!(builder.event().get_int("userid", -1), 7);
+        assert!(builder.fire(false));
+        assert_eq!(engine.fired(), 1);
+        assert_eq!(engine.freed(), 1);
+
+        // Written but never fired: freed on drop
+        let event = pools.take(engine_ptr, "player_team").unwrap();
+        drop(EventBuilder::new(engine_ptr, event).set_int("team", 2));
+        assert_eq!(engine.fired(), 1);
+        assert_eq!(engine.freed(), 2);
+    }
+}
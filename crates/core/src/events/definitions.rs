@@ -0,0 +1,371 @@
+//! Game event definitions
+//!
+//! The engine reads its events from KeyValues files
+//! (`resource/game.gameevents` and friends) through
+//! `IGameEventManager2::LoadEventsFromFile`. The manager's hook on that
+//! method passes each file name here, and files found on disk are parsed
+//! into an [`EventDefinitions`] table of event names, key names and key
+//! types.
+//!
+//! Only loose files loaded after the hook is installed are seen. The stock
+//! files ship inside the game's VPKs and are loaded before plugins are, so
+//! the table normally holds mod and addon events only. It is informational:
+//! dispatch never consults it, and a name missing from it may still be a
+//! valid engine event.
+
+use std::collections::HashMap;
+use std::ffi::{CStr, CString};
+use std::path::PathBuf;
+use std::sync::{Arc, LazyLock};
+
+use parking_lot::RwLock;
+
+use super::snapshot::EventFieldKind;
+
+/// One key of an event definition
+#[derive(Debug, Clone)]
+pub struct EventKeyDefinition {
+    key: CString,
+    /// Type as written in the definition file (`short`, `player_controller`, ...)
+    type_name: Box<str>,
+    kind: EventFieldKind,
+}
+
+impl EventKeyDefinition {
+    fn new(name: &str, type_name: &str) -> Option<Self> {
+        Some(Self {
+            key: CString::new(name).ok()?,
+            type_name: type_name.into(),
+            kind: key_kind(type_name),
+        })
+    }
+
+    /// Key name
+    pub fn name(&self) -> &str {
+        self.key.to_str().unwrap_or("")
+    }
+
+    /// Key name as a C string, ready for the event's getters
+    pub fn c_name(&self) -> &CStr {
+        &self.key
+    }
+
+    /// Type as written in the definition file
+    pub fn type_name(&self) -> &str {
+        &self.type_name
+    }
+
+    /// Getter the key is read with
+    pub fn kind(&self) -> EventFieldKind {
+        self.kind
+    }
+}
+
+/// Getter used for a definition file key type
+///
+/// Integer-like types (`byte`, `short`, `long`, player and entity handles)
+/// are all read with `GetInt`.
+fn key_kind(type_name: &str) -> EventFieldKind {
+    match type_name {
+        "bool" => EventFieldKind::Bool,
+        "float" => EventFieldKind::Float,
+        "uint64" => EventFieldKind::Uint64,
+        "string" | "wstring" => EventFieldKind::String,
+        _ => EventFieldKind::Int,
+    }
+}
+
+/// An event as defined by the game
+#[derive(Debug, Clone)]
+pub struct EventDefinition {
+    name: Box<str>,
+    keys: Box<[EventKeyDefinition]>,
+}
+
+impl EventDefinition {
+    /// Event name
+    pub fn name(&self) -> &str {
+        &self.name
+    }
+
+    /// Keys in definition order
+    pub fn keys(&self) -> &[EventKeyDefinition] {
+        &self.keys
+    }
+
+    /// Find a key by name
+    pub fn key(&self, name: &str) -> Option<&EventKeyDefinition> {
+        self.keys.iter().find(|key| key.name() == name)
+    }
+}
+
+/// Every event definition read so far
+#[derive(Debug, Default)]
+pub struct EventDefinitions {
+    events: HashMap<Box<str>, Arc<EventDefinition>>,
+    /// Definition files read, in load order
+    files: Vec<String>,
+}
+
+impl EventDefinitions {
+    /// Look up an event
+    pub fn get(&self, name: &str) -> Option<&Arc<EventDefinition>> {
+        self.events.get(name)
+    }
+
+    /// Check if an event is defined
+    pub fn contains(&self, name: &str) -> bool {
+        self.events.contains_key(name)
+    }
+
+    /// Number of defined events
+    pub fn len(&self) -> usize {
+        self.events.len()
+    }
+
+    /// Check if no definition file has been read
+    pub fn is_empty(&self) -> bool {
+        self.events.is_empty()
+    }
+
+    /// Iterate over the defined events (in no particular order)
+    pub fn iter(&self) -> impl Iterator<Item = &Arc<EventDefinition>> {
+        self.events.values()
+    }
+
+    /// Definition files read, in load order
+    pub fn files(&self) -> &[String] {
+        &self.files
+    }
+}
+
+/// Current definitions, replaced whenever a file is read
+static DEFINITIONS: LazyLock<RwLock<Arc<EventDefinitions>>> =
+    LazyLock::new(|| RwLock::new(Arc::new(EventDefinitions::default())));
+
+/// Get the event definitions read so far
+pub fn event_definitions() -> Arc<EventDefinitions> {
+    DEFINITIONS.read().clone()
+}
+
+/// Check if an event is defined by a definition file read so far
+///
+/// Events from the stock VPK files aren't covered, so `false` does not
+/// mean the engine doesn't know the event.
+pub fn event_exists(name: &str) -> bool {
+    DEFINITIONS.read().contains(name)
+}
+
+/// Parse a definition file's events
+///
+/// The format is KeyValues text: a root block holding one block per event,
+/// each mapping key names to types. Comments and the `local`/`reliable`
+/// flags are skipped. Returns `None` if the text isn't a KeyValues block.
+pub fn parse_definitions(text: &str) -> Option<Vec<EventDefinition>> {
+    let mut tokens = Tokens { text };
+
+    // Root block name ("gameevents", "ModEvents", ...)
+    tokens.next()?;
+    if tokens.next()? != Token::Open {
+        return None;
+    }
+
+    let mut events = Vec::new();
+    loop {
+        let name = match tokens.next()? {
+            Token::Close => return Some(events),
+            Token::Text(name) => name,
+            Token::Open => return None,
+        };
+        if tokens.next()? != Token::Open {
+            return None;
+        }
+
+        let mut keys = Vec::new();
+        loop {
+            let key = match tokens.next()? {
+                Token::Close => break,
+                Token::Text(key) => key,
+                Token::Open => return None,
+            };
+            let Token::Text(type_name) = tokens.next()? else {
+                return None;
+            };
+            if key == "local" || key == "reliable" {
+                continue;
+            }
+            keys.extend(EventKeyDefinition::new(key, type_name));
+        }
+
+        events.push(EventDefinition {
+            name: name.into(),
+            keys: keys.into_boxed_slice(),
+        });
+    }
+}
+
+#[derive(Debug, PartialEq, Eq)]
+enum Token<'a> {
+    Open,
+    Close,
+    Text(&'a str),
+}
+
+/// KeyValues tokenizer (quoted or bare strings, braces, `//` comments)
+struct Tokens<'a> {
+    text: &'a str,
+}
+
+impl<'a> Tokens<'a> {
+    fn next(&mut self) -> Option<Token<'a>> {
+        loop {
+            self.text = self.text.trim_start();
+            match self.text.strip_prefix("//") {
+                Some(rest) => self.text = rest.split_once('\n').map_or("", |(_, rest)| rest),
+                None => break,
+            }
+        }
+
+        let mut chars = self.text.chars();
+        let token = match chars.next()? {
+            '{' => Token::Open,
+            '}' => Token::Close,
+            '"' => {
+                let (text, rest) = self.text[1..].split_once('"')?;
+                self.text = rest;
+                return Some(Token::Text(text));
+            }
+            _ => {
+                let end = self
+                    .text
+                    .find(|c: char| c.is_whitespace() || matches!(c, '{' | '}' | '"'))
+                    .unwrap_or(self.text.len());
+                let (text, rest) = self.text.split_at(end);
+                self.text = rest;
+                return Some(Token::Text(text));
+            }
+        };
+        self.text = chars.as_str();
+        Some(token)
+    }
+}
+
+/// Directories a definition file name is resolved against
+fn search_roots() -> Vec<PathBuf> {
+    // <game>/csgo/addons/cs2rust -> <game>/csgo
+    let Some(mod_dir) = crate::config::cs2rust_base_dir()
+        .ok()
+        .and_then(|base| base.parent()?.parent().map(PathBuf::from))
+    else {
+        return Vec::new();
+    };
+    let core_dir = mod_dir.with_file_name("core");
+    vec![mod_dir, core_dir]
+}
+
+/// Read a definition file the engine just loaded
+///
+/// Events in the file replace earlier definitions of the same name.
+/// Returns the number of events read, or `None` if the file isn't on disk.
+pub(super) fn load_file(file_name: &str) -> Option<usize> {
+    let text = search_roots()
+        .into_iter()
+        .find_map(|root| std::fs::read_to_string(root.join(file_name)).ok())?;
+
+    let Some(events) = parse_definitions(&text) else {
+        tracing::warn!("Could not parse event definitions in '{}'", file_name);
+        return None;
+    };
+
+    let mut current = DEFINITIONS.write();
+    let mut definitions = EventDefinitions {
+        events: current.events.clone(),
+        files: current.files.clone(),
+    };
+    let count = events.len();
+    for event in events {
+        definitions
+            .events
+            .insert(event.name.clone(), Arc::new(event));
+    }
+    definitions.files.push(file_name.to_string());
+    *current = Arc::new(definitions);
+
+    tracing::info!("Read {} event definitions from '{}'", count, file_name);
+    Some(count)
+}
+
+/// Check the built-in typed events against the definitions
+pub(super) fn check_builtin_events(definitions: &EventDefinitions) {
+    for (name, fields) in super::typed::BUILTIN_EVENTS {
+        let Some(definition) = definitions.get(name) else {
+            continue;
+        };
+        for field in fields.iter() {
+            match definition.key(field.name) {
+                Some(key) if key.kind() == field.kind => {}
+                Some(key) => tracing::warn!(
+                    "Event '{}' key '{}' is '{}' in this game build, typed event reads it as {:?}",
+                    name,
+                    field.name,
+                    key.type_name(),
+                    field.kind
+                ),
+                None => tracing::warn!(
+                    "Event '{}' has no key '{}' in this game build",
+                    name,
+                    field.name
+                ),
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_parse_definitions() {
+        let text = r#"
+            //=========== game events ===========
+            "gameevents"
+            {
+                "player_death"  // a player died
+                {
+                    "userid"    "player_controller"
+                    "attacker"  "player_controller"
+                    "headshot"  "bool"
+                    "weapon"    "string"
+                    "distance"  "float"
+                }
+                round_start
+                {
+                    "timelimit" "long"
+                    "local"     "1"
+                }
+                "begin_new_match" {}
+            }
+        "#;
+
+        let events = parse_definitions(text).unwrap();
+        assert_eq!(events.len(), 3);
+
+        let death = &events[0];
+        assert_eq!(death.name(), "player_death");
+        assert_eq!(death.keys().len(), 5);
+        assert_eq!(death.key("userid").unwrap().kind(), EventFieldKind::Int);
+        assert_eq!(death.key("headshot").unwrap().kind(), EventFieldKind::Bool);
+        assert_eq!(death.key("weapon").unwrap().kind(), EventFieldKind::String);
+        assert_eq!(death.key("distance").unwrap().type_name(), "float");
+        assert_eq!(death.key("weapon").unwrap().c_name(), c"weapon");
+
+        let round_start = &events[1];
+        assert_eq!(round_start.name(), "round_start");
+        assert_eq!(round_start.keys().len(), 1);
+        assert!(events[2].keys().is_empty());
+
+        assert!(parse_definitions("\"gameevents\" { \"broken\" }").is_none());
+        assert!(parse_definitions("").is_none());
+    }
+}
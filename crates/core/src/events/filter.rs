@@ -0,0 +1,371 @@
+//! Declarative event filters
+//!
+//! A handler registered with
+//! [`register_event_filtered`](super::register_event_filtered) only runs
+//! when every condition of its [`EventFilter`] holds. The dispatcher
+//! evaluates the filters itself: each field named by the filters on an
+//! event is read from the engine at most once per dispatch and shared by
+//! all handlers, and handlers whose filter fails are never called.
+//!
+//! A field is read when the first filter that needs it is evaluated, so
+//! later filters don't see changes pre hooks make to it.
+
+use std::ops::{Bound, RangeBounds};
+
+use super::raw::GameEventRef;
+use super::snapshot::{CapturedField, EventField, EventFieldKind};
+use crate::schema::hash::hash_str;
+
+/// Filter fields per event whose values are cached during a dispatch
+///
+/// Conditions on further fields read them each time they are evaluated.
+const CACHED_FIELDS: usize = 8;
+
+/// Test applied to one field
+#[derive(Debug, Clone, PartialEq)]
+enum FilterTest {
+    Bool(bool),
+    IntIn(Box<[i32]>),
+    /// Inclusive bounds (empty if min > max)
+    IntRange(i32, i32),
+    Uint64In(Box<[u64]>),
+    /// Inclusive bounds (empty if min > max)
+    Uint64Range(u64, u64),
+    FloatRange(Bound<f32>, Bound<f32>),
+    /// Accepted values and their hashes
+    StringIn(Box<[(u32, Box<str>)]>),
+}
+
+macro_rules! inclusive_bounds {
+    ($name:ident, $ty:ty) => {
+        /// Convert a range to inclusive bounds
+        fn $name(range: impl RangeBounds<$ty>) -> ($ty, $ty) {
+            let min = match range.start_bound() {
+                Bound::Included(v) => Some(*v),
+                Bound::Excluded(v) => v.checked_add(1),
+                Bound::Unbounded => Some(<$ty>::MIN),
+            };
+            let max = match range.end_bound() {
+                Bound::Included(v) => Some(*v),
+                Bound::Excluded(v) => v.checked_sub(1),
+                Bound::Unbounded => Some(<$ty>::MAX),
+            };
+            match (min, max) {
+                (Some(min), Some(max)) => (min, max),
+                // Nothing is above MAX or below MIN
+                _ => (<$ty>::MAX, <$ty>::MIN),
+            }
+        }
+    };
+}
+
+inclusive_bounds!(int_bounds, i32);
+inclusive_bounds!(uint64_bounds, u64);
+
+/// Conditions a handler's event must meet, all of which must hold
+///
+/// # Example
+///
+/// ```ignore
+/// // Only big hits by player 3
+/// let filter = EventFilter::new()
+///     .int_eq("attacker", 3)
+///     .int_range("dmg_health", 100..);
+/// ```
+#[derive(Debug, Clone, Default)]
+pub struct EventFilter {
+    conditions: Vec<(EventField, FilterTest)>,
+}
+
+impl EventFilter {
+    /// Create a filter that matches every event
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Check if the filter has no conditions
+    pub fn is_empty(&self) -> bool {
+        self.conditions.is_empty()
+    }
+
+    fn with(mut self, field: EventField, test: FilterTest) -> Self {
+        self.conditions.push((field, test));
+        self
+    }
+
+    /// Require a boolean field to equal `value`
+    pub fn bool_eq(self, key: &'static str, value: bool) -> Self {
+        self.with(EventField::bool(key), FilterTest::Bool(value))
+    }
+
+    /// Require an integer field to equal `value`
+    pub fn int_eq(self, key: &'static str, value: i32) -> Self {
+        self.int_in(key, [value])
+    }
+
+    /// Require an integer field to be one of `values`
+    pub fn int_in(self, key: &'static str, values: impl IntoIterator<Item = i32>) -> Self {
+        let values = values.into_iter().collect();
+        self.with(EventField::int(key), FilterTest::IntIn(values))
+    }
+
+    /// Require an integer field to be in `range`
+    pub fn int_range(self, key: &'static str, range: impl RangeBounds<i32>) -> Self {
+        let (min, max) = int_bounds(range);
+        self.with(EventField::int(key), FilterTest::IntRange(min, max))
+    }
+
+    /// Require a 64-bit unsigned integer field to equal `value`
+    pub fn uint64_eq(self, key: &'static str, value: u64) -> Self {
+        self.uint64_in(key, [value])
+    }
+
+    /// Require a 64-bit unsigned integer field to be one of `values`
+    pub fn uint64_in(self, key: &'static str, values: impl IntoIterator<Item = u64>) -> Self {
+        let values = values.into_iter().collect();
+        self.with(EventField::uint64(key), FilterTest::Uint64In(values))
+    }
+
+    /// Require a 64-bit unsigned integer field to be in `range`
+    pub fn uint64_range(self, key: &'static str, range: impl RangeBounds<u64>) -> Self {
+        let (min, max) = uint64_bounds(range);
+        self.with(EventField::uint64(key), FilterTest::Uint64Range(min, max))
+    }
+
+    /// Require a float field to be in `range`
+    pub fn float_range(self, key: &'static str, range: impl RangeBounds<f32>) -> Self {
+        let bounds = (range.start_bound().cloned(), range.end_bound().cloned());
+        self.with(
+            EventField::float(key),
+            FilterTest::FloatRange(bounds.0, bounds.1),
+        )
+    }
+
+    /// Require a string field to equal `value` (missing keys read as "")
+    pub fn string_eq(self, key: &'static str, value: &str) -> Self {
+        self.string_in(key, [value])
+    }
+
+    /// Require a string field to be one of `values`
+    pub fn string_in<S: AsRef<str>>(
+        self,
+        key: &'static str,
+        values: impl IntoIterator<Item = S>,
+    ) -> Self {
+        let values = values
+            .into_iter()
+            .map(|v| (hash_str(v.as_ref()), Box::from(v.as_ref())))
+            .collect();
+        self.with(EventField::string(key), FilterTest::StringIn(values))
+    }
+
+    /// Resolve the conditions to indices into an event's filter fields,
+    /// adding fields no other filter reads yet
+    ///
+    /// Returns `None` if a key contains a NUL byte.
+    pub(super) fn resolve(&self, fields: &mut Vec<CapturedField>) -> Option<Box<[FieldCondition]>> {
+        self.conditions
+            .iter()
+            .map(|(field, test)| {
+                let index = match fields.iter().position(|f| f.field() == *field) {
+                    Some(index) => index,
+                    None => {
+                        fields.push(CapturedField::new(*field)?);
+                        fields.len() - 1
+                    }
+                };
+                Some(FieldCondition {
+                    field: index,
+                    test: test.clone(),
+                })
+            })
+            .collect()
+    }
+}
+
+/// A condition on one of an event's filter fields
+#[derive(Debug)]
+pub(super) struct FieldCondition {
+    /// Index into the event's filter fields
+    field: usize,
+    test: FilterTest,
+}
+
+/// A field value read for filtering
+#[derive(Debug, Clone, Copy)]
+enum Cached {
+    Unread,
+    Bool(bool),
+    Int(i32),
+    Uint64(u64),
+    Float(f32),
+    /// Hash of the value (compared exactly on a hash match)
+    String(u32),
+}
+
+/// Filter field values of one event, read on first use
+pub(super) struct FilterFields<'a> {
+    event: &'a GameEventRef,
+    fields: &'a [CapturedField],
+    cache: [Cached; CACHED_FIELDS],
+}
+
+impl<'a> FilterFields<'a> {
+    pub(super) fn new(event: &'a GameEventRef, fields: &'a [CapturedField]) -> Self {
+        Self {
+            event,
+            fields,
+            cache: [Cached::Unread; CACHED_FIELDS],
+        }
+    }
+
+    /// Check whether every condition holds
+    pub(super) fn matches(&mut self, conditions: &[FieldCondition]) -> bool {
+        conditions.iter().all(|condition| self.test(condition))
+    }
+
+    fn read_str(&self, index: usize) -> &'a str {
+        self.event.get_str_c(self.fields[index].key()).unwrap_or("")
+    }
+
+    fn value(&mut self, index: usize) -> Cached {
+        if let Some(cached) = self.cache.get(index) {
+            if !matches!(cached, Cached::Unread) {
+                return *cached;
+            }
+        }
+
+        let captured = &self.fields[index];
+        let key = captured.key();
+        let value = match captured.field().kind {
+            EventFieldKind::Bool => Cached::Bool(self.event.get_bool_c(key, false)),
+            EventFieldKind::Int => Cached::Int(self.event.get_int_c(key, 0)),
+            EventFieldKind::Uint64 => Cached::Uint64(self.event.get_uint64_c(key, 0)),
+            EventFieldKind::Float => Cached::Float(self.event.get_float_c(key, 0.0)),
+            EventFieldKind::String => Cached::String(hash_str(self.read_str(index))),
+        };
+        if let Some(slot) = self.cache.get_mut(index) {
+            *slot = value;
+        }
+        value
+    }
+
+    fn test(&mut self, condition: &FieldCondition) -> bool {
+        match (&condition.test, self.value(condition.field)) {
+            (FilterTest::Bool(want), Cached::Bool(value)) => value == *want,
+            (FilterTest::IntIn(set), Cached::Int(value)) => set.contains(&value),
+            (FilterTest::IntRange(min, max), Cached::Int(value)) => (*min..=*max).contains(&value),
+            (FilterTest::Uint64In(set), Cached::Uint64(value)) => set.contains(&value),
+            (FilterTest::Uint64Range(min, max), Cached::Uint64(value)) => {
+                (*min..=*max).contains(&value)
+            }
+            (FilterTest::FloatRange(min, max), Cached::Float(value)) => {
+                (*min, *max).contains(&value)
+            }
+            (FilterTest::StringIn(set), Cached::String(hash)) => set
+                .iter()
+                .any(|(h, s)| *h == hash && self.read_str(condition.field) == &**s),
+            _ => false,
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEvent;
+
+    fn matches(event: &mut ReplayEvent, filter: &EventFilter) -> bool {
+        let mut fields = Vec::new();
+        let conditions = filter.resolve(&mut fields).unwrap();
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+        FilterFields::new(&event_ref, &fields).matches(&conditions)
+    }
+
+    #[test]
+    fn test_conditions() {
+        let mut event = ReplayEvent::new("player_hurt", 1);
+        event.set_int("attacker", 3);
+        event.set_int("dmg_health", 100);
+        event.set_bool("headshot", true);
+        event.set_float("distance", 2.5);
+        event.set_string("weapon", "awp");
+
+        let hit = EventFilter::new().int_eq("attacker", 3);
+        assert!(matches(&mut event, &hit));
+        assert!(matches(
+            &mut event,
+            &hit.clone().int_range("dmg_health", 100..)
+        ));
+        assert!(!matches(&mut event, &hit.int_range("dmg_health", ..100)));
+        assert!(matches(
+            &mut event,
+            &EventFilter::new().int_in("attacker", [1, 3])
+        ));
+        assert!(!matches(
+            &mut event,
+            &EventFilter::new().bool_eq("headshot", false)
+        ));
+        assert!(!matches(
+            &mut event,
+            &EventFilter::new().float_range("distance", 1.0..2.5)
+        ));
+        assert!(matches(
+            &mut event,
+            &EventFilter::new().float_range("distance", 1.0..=2.5)
+        ));
+        assert!(matches(
+            &mut event,
+            &EventFilter::new().string_in("weapon", ["ak47", "awp"])
+        ));
+        assert!(!matches(
+            &mut event,
+            &EventFilter::new().string_eq("weapon", "ak47")
+        ));
+        // Missing keys read as zero values
+        assert!(matches(
+            &mut event,
+            &EventFilter::new().uint64_eq("xuid", 0)
+        ));
+        assert!(matches(
+            &mut event,
+            &EventFilter::new().string_eq("team", "")
+        ));
+        assert!(matches(&mut event, &EventFilter::new()));
+    }
+
+    #[test]
+    fn test_empty_ranges() {
+        assert_eq!(int_bounds(..i32::MIN), (i32::MAX, i32::MIN));
+        assert_eq!(
+            uint64_bounds((Bound::Excluded(u64::MAX), Bound::Unbounded)),
+            (u64::MAX, 0)
+        );
+        assert_eq!(int_bounds(-5..5), (-5, 4));
+    }
+
+    #[test]
+    fn test_fields_are_read_once() {
+        let mut event = ReplayEvent::new("player_hurt", 1);
+        event.set_int("attacker", 3);
+        event.set_string("weapon", "awp");
+
+        let mut fields = Vec::new();
+        let by_attacker = EventFilter::new().int_eq("attacker", 3);
+        let big_hits = EventFilter::new()
+            .int_eq("attacker", 3)
+            .string_eq("weapon", "ak47");
+        let first = by_attacker.resolve(&mut fields).unwrap();
+        let second = big_hits.resolve(&mut fields).unwrap();
+        assert_eq!(fields.len(), 2);
+
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+        let mut values = FilterFields::new(&event_ref, &fields);
+        assert!(values.matches(&first));
+        assert!(!values.matches(&second));
+        assert!(values.matches(&first));
+        // One read per field; the weapon hash did not match, so the
+        // string was not compared
+        assert_eq!(event.reads(), 2);
+    }
+}
@@ -0,0 +1,291 @@
+//! Pre-built event keys
+//!
+//! [`GameEventRef`]'s `&str` getters copy the key into a `CString` on every
+//! call. A [`GameEventKey`] holds a NUL-terminated key and its hash built
+//! once (at compile time when created in a `const`), and is what
+//! `#[derive(GameEvent)]` uses to decode typed events.
+
+use std::cell::RefCell;
+use std::ffi::CStr;
+use std::hash::{Hash, Hasher};
+
+use super::raw::GameEventRef;
+use super::snapshot::EventFieldKind;
+use crate::schema::hash::fnv1a_32;
+
+/// An event key with its C string and FNV-1a hash precomputed
+///
+/// # Example
+///
+/// ```ignore
+/// const DMG_HEALTH: GameEventKey = GameEventKey::new(c"dmg_health");
+///
+/// let damage = event.get_int_key(&DMG_HEALTH, 0);
+/// ```
+#[derive(Debug, Clone, Copy)]
+pub struct GameEventKey {
+    name: &'static CStr,
+    hash: u32,
+}
+
+impl GameEventKey {
+    /// Create a key from a C string
+    pub const fn new(name: &'static CStr) -> Self {
+        Self {
+            name,
+            hash: fnv1a_32(name.to_bytes()),
+        }
+    }
+
+    /// Create a key from NUL-terminated bytes
+    ///
+    /// # Panics
+    /// If `bytes` is not NUL-terminated or contains an interior NUL
+    /// (a compile error when used in a `const`).
+    pub const fn from_bytes_with_nul(bytes: &'static [u8]) -> Self {
+        match CStr::from_bytes_with_nul(bytes) {
+            Ok(name) => Self::new(name),
+            Err(_) => panic!("event key must end with its only NUL byte"),
+        }
+    }
+
+    /// The key as a C string
+    pub const fn as_c_str(&self) -> &'static CStr {
+        self.name
+    }
+
+    /// The key as a string (empty if not UTF-8)
+    pub fn as_str(&self) -> &'static str {
+        self.name.to_str().unwrap_or("")
+    }
+
+    /// FNV-1a hash of the key
+    pub const fn hash(&self) -> u32 {
+        self.hash
+    }
+}
+
+impl PartialEq for GameEventKey {
+    fn eq(&self, other: &Self) -> bool {
+        self.hash == other.hash && self.name == other.name
+    }
+}
+
+impl Eq for GameEventKey {}
+
+impl Hash for GameEventKey {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        state.write_u32(self.hash);
+    }
+}
+
+impl GameEventRef {
+    /// Get a boolean value using a pre-built key
+    pub fn get_bool_key(&self, key: &GameEventKey, default: bool) -> bool {
+        self.get_bool_c(key.name, default)
+    }
+
+    /// Get an integer value using a pre-built key
+    pub fn get_int_key(&self, key: &GameEventKey, default: i32) -> i32 {
+        self.get_int_c(key.name, default)
+    }
+
+    /// Get a 64-bit unsigned integer value using a pre-built key
+    pub fn get_uint64_key(&self, key: &GameEventKey, default: u64) -> u64 {
+        self.get_uint64_c(key.name, default)
+    }
+
+    /// Get a float value using a pre-built key
+    pub fn get_float_key(&self, key: &GameEventKey, default: f32) -> f32 {
+        self.get_float_c(key.name, default)
+    }
+
+    /// Borrow a string value using a pre-built key
+    ///
+    /// Returns `default` if the key is missing or empty.
+    pub fn get_str_key<'a>(&'a self, key: &GameEventKey, default: &'a str) -> &'a str {
+        self.get_str_c(key.name).unwrap_or(default)
+    }
+
+    /// Set a boolean value using a pre-built key
+    pub fn set_bool_key(&self, key: &GameEventKey, value: bool) {
+        self.set_bool_c(key.name, value);
+    }
+
+    /// Set an integer value using a pre-built key
+    pub fn set_int_key(&self, key: &GameEventKey, value: i32) {
+        self.set_int_c(key.name, value);
+    }
+
+    /// Set a 64-bit unsigned integer value using a pre-built key
+    pub fn set_uint64_key(&self, key: &GameEventKey, value: u64) {
+        self.set_uint64_c(key.name, value);
+    }
+
+    /// Set a float value using a pre-built key
+    pub fn set_float_key(&self, key: &GameEventKey, value: f32) {
+        self.set_float_c(key.name, value);
+    }
+
+    /// Set a string value using a pre-built key
+    ///
+    /// Does nothing if `value` contains a NUL byte. The value is copied
+    /// into a reused per-thread buffer rather than a new `CString`.
+    pub fn set_string_key(&self, key: &GameEventKey, value: &str) {
+        VALUE_BUFFER.with(|buffer| {
+            let mut buffer = buffer.borrow_mut();
+            buffer.clear();
+            buffer.extend_from_slice(value.as_bytes());
+            buffer.push(0);
+            if let Ok(value) = CStr::from_bytes_with_nul(&buffer) {
+                self.set_string_c(key.name, value);
+            }
+        });
+    }
+}
+
+thread_local! {
+    /// NUL-terminated copy of the last value passed to `set_string_key`
+    static VALUE_BUFFER: RefCell<Vec<u8>> = const { RefCell::new(Vec::new()) };
+}
+
+/// A type that can be read from an event field
+///
+/// Implemented for the value types `IGameEvent` supports. Used by
+/// `#[derive(GameEvent)]`.
+pub trait EventValue: Sized {
+    /// Type of the default passed to the getter
+    type Default;
+
+    /// Type returned by lazy view accessors (`&str` for strings)
+    type Output<'a>
+    where
+        Self: 'a;
+
+    /// Default when the field has no `#[game_event(default = ...)]`
+    const DEFAULT: Self::Default;
+
+    /// Engine getter used to read the value
+    const KIND: EventFieldKind;
+
+    /// Read the value of `key`, or `default` if it is missing
+    fn read(event: &GameEventRef, key: &GameEventKey, default: Self::Default) -> Self;
+
+    /// Borrow a memoized value for a view accessor
+    fn as_output(&self) -> Self::Output<'_>;
+}
+
+impl EventValue for bool {
+    type Default = bool;
+    type Output<'a> = bool;
+    const DEFAULT: bool = false;
+    const KIND: EventFieldKind = EventFieldKind::Bool;
+
+    fn read(event: &GameEventRef, key: &GameEventKey, default: bool) -> Self {
+        event.get_bool_key(key, default)
+    }
+
+    fn as_output(&self) -> bool {
+        *self
+    }
+}
+
+impl EventValue for i32 {
+    type Default = i32;
+    type Output<'a> = i32;
+    const DEFAULT: i32 = 0;
+    const KIND: EventFieldKind = EventFieldKind::Int;
+
+    fn read(event: &GameEventRef, key: &GameEventKey, default: i32) -> Self {
+        event.get_int_key(key, default)
+    }
+
+    fn as_output(&self) -> i32 {
+        *self
+    }
+}
+
+impl EventValue for u64 {
+    type Default = u64;
+    type Output<'a> = u64;
+    const DEFAULT: u64 = 0;
+    const KIND: EventFieldKind = EventFieldKind::Uint64;
+
+    fn read(event: &GameEventRef, key: &GameEventKey, default: u64) -> Self {
+        event.get_uint64_key(key, default)
+    }
+
+    fn as_output(&self) -> u64 {
+        *self
+    }
+}
+
+impl EventValue for f32 {
+    type Default = f32;
+    type Output<'a> = f32;
+    const DEFAULT: f32 = 0.0;
+    const KIND: EventFieldKind = EventFieldKind::Float;
+
+    fn read(event: &GameEventRef, key: &GameEventKey, default: f32) -> Self {
+        event.get_float_key(key, default)
+    }
+
+    fn as_output(&self) -> f32 {
+        *self
+    }
+}
+
+impl EventValue for String {
+    type Default = &'static str;
+    type Output<'a> = &'a str;
+    const DEFAULT: &'static str = "";
+    const KIND: EventFieldKind = EventFieldKind::String;
+
+    fn read(event: &GameEventRef, key: &GameEventKey, default: &'static str) -> Self {
+        event.get_str_key(key, default).to_string()
+    }
+
+    fn as_output(&self) -> &str {
+        self
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEvent;
+    use crate::schema::hash::hash_str;
+
+    const USERID: GameEventKey = GameEventKey::new(c"userid");
+
+    #[test]
+    fn test_key_hash_and_name() {
+        assert_eq!(USERID.hash(), hash_str("userid"));
+        assert_eq!(USERID.as_str(), "userid");
+        assert_eq!(USERID, GameEventKey::from_bytes_with_nul(b"userid\0"));
+    }
+
+    #[test]
+    fn test_key_getters() {
+        let mut event = ReplayEvent::new("player_spawn", 1);
+        event.set_int("userid", 5);
+        event.set_string("weapon", "knife");
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+
+        assert_eq!(event_ref.get_int_key(&USERID, -1), 5);
+        assert_eq!(
+            event_ref.get_str_key(&GameEventKey::new(c"weapon"), ""),
+            "knife"
+        );
+        assert_eq!(
+            <String as EventValue>::read(&event_ref, &GameEventKey::new(c"team"), "none"),
+            "none"
+        );
+
+        let weapon = GameEventKey::new(c"weapon");
+        event_ref.set_string_key(&weapon, "deagle");
+        event_ref.set_string_key(&weapon, "ak");
+        event_ref.set_string_key(&weapon, "bad\0value");
+        assert_eq!(event_ref.get_str_key(&weapon, ""), "ak");
+    }
+}
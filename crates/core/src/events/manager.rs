@@ -1,23 +1,45 @@
 //! Event manager - registration, dispatch, and hooks
 //!
-//! Hooks IGameEventManager2::FireEvent to intercept game events.
+//! Hooks IGameEventManager2::FireEvent to intercept game events, and
+//! LoadEventsFromFile to follow the game's event definitions.
+//!
+//! Hooks are keyed by the FNV-1a hash of the event name. The engine's event
+//! id is mapped to that hash the first time each id fires, so dispatching an
+//! event that nobody hooks costs one `GetID` call, an array index and one
+//! hash probe, with no allocation.
+//!
+//! The hook table is published as an immutable snapshot that registration
+//! replaces, and the stack of events being fired is kept per thread, so a
+//! handler can fire another event without deadlocking on the manager.
+//!
+//! Events are only duplicated for post hooks that take a [`GameEventRef`].
+//! Events whose post hooks are all snapshot hooks get their declared fields
+//! captured into a pooled [`EventSnapshot`] instead, and events with no post
+//! hooks at all are never copied.
 
+use std::cell::RefCell;
 use std::collections::HashMap;
-use std::ffi::{c_char, c_void};
+use std::ffi::{c_char, c_void, CStr};
+use std::hash::{BuildHasherDefault, Hasher};
 use std::ptr::NonNull;
-use std::sync::atomic::{AtomicPtr, Ordering};
-use std::sync::LazyLock;
+use std::sync::atomic::{AtomicPtr, AtomicU32, Ordering};
+use std::sync::{Arc, LazyLock};
 
-use parking_lot::RwLock;
+use parking_lot::{Mutex, RwLock};
 
 use cs2rust_sdk::{IGameEvent, IGameEventManager2};
 
+use super::batch::{BatchArena, BatchCallback, EventBatch};
+use super::filter::{EventFilter, FieldCondition, FilterFields};
 use super::raw::GameEventRef;
+use super::snapshot::{CapturedField, EventField, EventSnapshot, SnapshotCallback};
 use super::types::{EventCallback, EventInfo, HookResult};
 use crate::hooks::{HookError, VTableHookKey};
+use crate::profiler::{ProfileHandle, ProfileKind};
+use crate::schema::hash::hash_str;
 
 /// VTable indices for IGameEventManager2 (Linux)
-mod vtable {
+pub(super) mod vtable {
     pub const LOAD_EVENTS_FROM_FILE: usize = 1;
     pub const RESET: usize = 2;
     pub const ADD_LISTENER: usize = 3;
@@ -30,7 +52,7 @@ mod vtable {
     pub const FREE_EVENT: usize = 10;
 }
 
-/// Global game event manager pointer (set when LoadEventsFromFile is called)
+/// Global game event manager pointer (set by [`set_game_event_manager`])
 static GAME_EVENT_MANAGER: AtomicPtr<IGameEventManager2> = AtomicPtr::new(std::ptr::null_mut());
 
 /// Hook keys for cleanup
@@ -51,40 +73,162 @@ type FreeEventFn = extern "C" fn(*mut IGameEventManager2, *mut IGameEvent);
 
 /// Original function pointers
 static ORIGINAL_FIRE_EVENT: AtomicPtr<c_void> = AtomicPtr::new(std::ptr::null_mut());
+static ORIGINAL_LOAD_EVENTS: AtomicPtr<c_void> = AtomicPtr::new(std::ptr::null_mut());
+
+/// Profile entry for the original FireEvent call
+static FIRE_EVENT_PROFILE: LazyLock<ProfileHandle> =
+    LazyLock::new(|| ProfileHandle::new(ProfileKind::Core, "IGameEventManager2::FireEvent"));
+
+/// A registered event handler and its profile entry
+struct EventHandler {
+    /// Conditions checked before calling (empty = always called)
+    filter: Box<[FieldCondition]>,
+    callback: EventCallback,
+    profile: ProfileHandle,
+}
+
+/// A registered snapshot post-hook and its profile entry
+struct SnapshotHandler {
+    callback: SnapshotCallback,
+    profile: ProfileHandle,
+}
+
+/// A registered batched subscriber and its profile entry
+struct BatchHandler {
+    callback: BatchCallback,
+    profile: ProfileHandle,
+}
+
+/// Largest engine event id cached in the id -> name hash table
+const MAX_CACHED_EVENT_ID: usize = 4096;
+
+/// Hasher for keys that are already FNV hashes
+///
+/// Spreads the 32-bit hash over 64 bits so the table's control bytes (taken
+/// from the top bits) stay well distributed.
+#[derive(Default)]
+struct PrehashedHasher(u64);
+
+impl Hasher for PrehashedHasher {
+    fn finish(&self) -> u64 {
+        self.0
+    }
+
+    fn write(&mut self, bytes: &[u8]) {
+        for &byte in bytes {
+            self.0 = (self.0 << 8) | byte as u64;
+        }
+    }
+
+    fn write_u32(&mut self, hash: u32) {
+        self.0 = (hash as u64).wrapping_mul(0x9E37_79B9_7F4A_7C15);
+    }
+}
+
+/// Map keyed by event name hash
+type EventHashMap<V> = HashMap<u32, V, BuildHasherDefault<PrehashedHasher>>;
 
 /// Storage for an event hook
+///
+/// Hooks are immutable once published in the table. Registration builds a
+/// new hook (sharing the existing handlers) and swaps in a new table.
+#[derive(Clone)]
 struct EventHook {
     name: String,
-    pre_hooks: Vec<EventCallback>,
-    post_hooks: Vec<EventCallback>,
+    pre_hooks: Vec<Arc<EventHandler>>,
+    post_hooks: Vec<Arc<EventHandler>>,
+    snapshot_hooks: Vec<Arc<SnapshotHandler>>,
+    /// Union of the fields declared by `snapshot_hooks`
+    snapshot_fields: Vec<CapturedField>,
+    /// Union of the fields read by handler filters
+    filter_fields: Vec<CapturedField>,
+    batch_hooks: Vec<Arc<BatchHandler>>,
+    /// Union of the fields declared by `batch_hooks` (only ever appended
+    /// to, so indices in the arena stay valid)
+    batch_fields: Vec<CapturedField>,
+    /// This frame's events for `batch_hooks`, shared by every version of
+    /// the hook
+    batch_arena: Option<Arc<Mutex<BatchArena>>>,
+}
+
+impl EventHook {
+    fn new(name: &str) -> Self {
+        Self {
+            name: name.to_string(),
+            pre_hooks: Vec::new(),
+            post_hooks: Vec::new(),
+            snapshot_hooks: Vec::new(),
+            snapshot_fields: Vec::new(),
+            filter_fields: Vec::new(),
+            batch_hooks: Vec::new(),
+            batch_fields: Vec::new(),
+            batch_arena: None,
+        }
+    }
+}
+
+/// Published hook table
+type HookTable = EventHashMap<Arc<EventHook>>;
+
+/// A hooked event between its pre and post processing
+struct FiringEvent {
+    /// Hook as it was when the event started firing
+    hook: Arc<EventHook>,
+    /// Engine copy for `post_hooks` (null if there are none)
+    copy: *mut IGameEvent,
+    /// Captured fields for `snapshot_hooks`
+    snapshot: Option<EventSnapshot>,
+}
+
+/// Snapshots kept for reuse (one per nesting level is enough)
+const SNAPSHOT_POOL_SIZE: usize = 8;
+
+thread_local! {
+    /// Events being fired on this thread, innermost last (None = not hooked)
+    ///
+    /// Only borrowed between handler calls, so handlers may fire events.
+    static EVENT_STACK: RefCell<Vec<Option<FiringEvent>>> = const { RefCell::new(Vec::new()) };
+
+    /// Snapshots returned after post processing
+    static SNAPSHOT_POOL: RefCell<Vec<EventSnapshot>> = const { RefCell::new(Vec::new()) };
 }
 
 /// Global event manager
-pub static EVENTS: LazyLock<RwLock<EventManager>> =
-    LazyLock::new(|| RwLock::new(EventManager::new()));
+pub static EVENTS: LazyLock<EventManager> = LazyLock::new(EventManager::new);
 
 /// Event manager for registering and dispatching event handlers
+///
+/// Dispatch holds the table lock only long enough to look up the event's
+/// hook, and never while handlers run. Handlers can therefore fire nested
+/// events and register or unregister handlers, and events fired from other
+/// threads don't wait on each other.
 pub struct EventManager {
-    /// Map of event name to hook data
-    hooks: HashMap<String, EventHook>,
+    /// Current hook table by event name hash, replaced on registration
+    hooks: RwLock<Arc<HookTable>>,
 
-    /// Stack of event names for tracking nested events
-    event_stack: Vec<Option<String>>,
+    /// Event name hash by engine event id (0 = not seen yet)
+    ///
+    /// Only filled after the event's name was compared with the hook
+    /// stored under its hash, and cleared whenever a hook is added, so a
+    /// cached id never leads to another event's hook.
+    id_cache: Box<[AtomicU32]>,
 
-    /// Stack of duplicated events for post-hooks
-    event_copies: Vec<*mut IGameEvent>,
-}
+    /// Name hashes of events with batched subscribers
+    batched: RwLock<Arc<[u32]>>,
 
-// SAFETY: Accessed only from game thread
-unsafe impl Send for EventManager {}
-unsafe impl Sync for EventManager {}
+    /// Game event manager used instead of the engine's (set during replay)
+    engine_override: AtomicPtr<IGameEventManager2>,
+}
 
 impl EventManager {
-    fn new() -> Self {
+    pub(super) fn new() -> Self {
         Self {
-            hooks: HashMap::new(),
-            event_stack: Vec::new(),
-            event_copies: Vec::new(),
+            hooks: RwLock::new(Arc::new(HookTable::default())),
+            id_cache: (0..MAX_CACHED_EVENT_ID)
+                .map(|_| AtomicU32::new(0))
+                .collect(),
+            batched: RwLock::new(Arc::new([])),
+            engine_override: AtomicPtr::new(std::ptr::null_mut()),
         }
     }
 
@@ -93,9 +237,264 @@ impl EventManager {
         NonNull::new(GAME_EVENT_MANAGER.load(Ordering::Acquire))
     }
 
+    /// Game event manager that duplicates and frees events for this manager
+    pub(super) fn engine(&self) -> Option<NonNull<IGameEventManager2>> {
+        NonNull::new(self.engine_override.load(Ordering::Acquire)).or_else(Self::game_event_manager)
+    }
+
+    /// Run `f` with `engine` duplicating and freeing events
+    pub(super) fn with_engine<R>(
+        &self,
+        engine: *mut IGameEventManager2,
+        f: impl FnOnce() -> R,
+    ) -> R {
+        let previous = self.engine_override.swap(engine, Ordering::AcqRel);
+        let result = f();
+        self.engine_override.store(previous, Ordering::Release);
+        result
+    }
+
+    /// Publish a new table with the hook for `name` changed by `update`
+    ///
+    /// The hook is created if needed. Does nothing if the name's hash
+    /// belongs to another event.
+    fn update_hook(&self, name: &str, update: impl FnOnce(&mut EventHook)) {
+        let mut current = self.hooks.write();
+        let mut table = HookTable::clone(&current);
+
+        let mut added = false;
+        let hook = table.entry(hash_str(name)).or_insert_with(|| {
+            tracing::debug!("Registering new event hook: {}", name);
+            added = true;
+            Arc::new(EventHook::new(name))
+        });
+        if added {
+            // Ids cached while no hook existed for this hash were never
+            // compared with this name
+            self.clear_event_ids();
+        }
+
+        if hook.name != name {
+            tracing::error!(
+                "Event name hash collision between '{}' and '{}', handler not registered",
+                name,
+                hook.name
+            );
+            return;
+        }
+
+        update(Arc::make_mut(hook));
+        *current = Arc::new(table);
+    }
+
+    /// Add a handler for an event
+    fn add_handler(&self, name: &str, post: bool, handler: EventHandler) {
+        self.update_hook(name, |hook| {
+            if post {
+                hook.post_hooks.push(Arc::new(handler));
+            } else {
+                hook.pre_hooks.push(Arc::new(handler));
+            }
+
+            tracing::trace!(
+                "Added {} handler for event '{}' (total: {} pre, {} post)",
+                if post { "post" } else { "pre" },
+                name,
+                hook.pre_hooks.len(),
+                hook.post_hooks.len()
+            );
+        });
+    }
+
+    /// Add a handler that only runs for events matching `filter`
+    fn add_filtered_handler(
+        &self,
+        name: &str,
+        post: bool,
+        filter: &EventFilter,
+        mut handler: EventHandler,
+    ) {
+        self.update_hook(name, |hook| {
+            let mut fields = hook.filter_fields.clone();
+            let Some(conditions) = filter.resolve(&mut fields) else {
+                tracing::warn!(
+                    "Invalid filter key for event '{}', handler not registered",
+                    name
+                );
+                return;
+            };
+            hook.filter_fields = fields;
+            handler.filter = conditions;
+
+            let handlers = if post {
+                &mut hook.post_hooks
+            } else {
+                &mut hook.pre_hooks
+            };
+            handlers.push(Arc::new(handler));
+
+            tracing::trace!(
+                "Added filtered {} handler for event '{}' ({} filter fields)",
+                if post { "post" } else { "pre" },
+                name,
+                hook.filter_fields.len()
+            );
+        });
+    }
+
+    /// Add a snapshot post-hook for an event
+    fn add_snapshot_handler(&self, name: &str, fields: &[EventField], handler: SnapshotHandler) {
+        self.update_hook(name, |hook| {
+            for field in fields {
+                if hook.snapshot_fields.iter().any(|f| f.field() == *field) {
+                    continue;
+                }
+                match CapturedField::new(*field) {
+                    Some(captured) => hook.snapshot_fields.push(captured),
+                    None => {
+                        tracing::warn!("Invalid field name '{}' for event '{}'", field.name, name)
+                    }
+                }
+            }
+            hook.snapshot_hooks.push(Arc::new(handler));
+
+            tracing::trace!(
+                "Added snapshot handler for event '{}' ({} fields captured)",
+                name,
+                hook.snapshot_fields.len()
+            );
+        });
+    }
+
+    /// Add a batched subscriber for an event
+    fn add_batch_handler(&self, name: &str, fields: &[EventField], handler: BatchHandler) {
+        let mut added = false;
+        self.update_hook(name, |hook| {
+            for field in fields {
+                if hook.batch_fields.iter().any(|f| f.field() == *field) {
+                    continue;
+                }
+                match CapturedField::new(*field) {
+                    Some(captured) => hook.batch_fields.push(captured),
+                    None => {
+                        tracing::warn!("Invalid field name '{}' for event '{}'", field.name, name)
+                    }
+                }
+            }
+            hook.batch_arena.get_or_insert_with(Default::default);
+            hook.batch_hooks.push(Arc::new(handler));
+            added = true;
+
+            tracing::trace!(
+                "Added batched handler for event '{}' ({} fields captured)",
+                name,
+                hook.batch_fields.len()
+            );
+        });
+
+        let key = hash_str(name);
+        let mut batched = self.batched.write();
+        if added && !batched.contains(&key) {
+            *batched = batched.iter().copied().chain([key]).collect();
+        }
+    }
+
+    /// Deliver this frame's batched events to their subscribers
+    pub(super) fn flush_batches(&self) {
+        let batched = self.batched.read().clone();
+        if batched.is_empty() {
+            return;
+        }
+
+        let table = self.hooks.read().clone();
+        for key in batched.iter() {
+            let Some(hook) = table.get(key) else {
+                continue;
+            };
+            let Some(arena) = &hook.batch_arena else {
+                continue;
+            };
+
+            // Events fired by subscribers go into the next batch
+            let mut pending = {
+                let mut arena = arena.lock();
+                if arena.is_empty() {
+                    continue;
+                }
+                std::mem::take(&mut *arena)
+            };
+
+            let batch = EventBatch::new(&hook.batch_fields, &pending);
+            for handler in &hook.batch_hooks {
+                let _scope = handler.profile.scope();
+                (handler.callback)(&batch);
+            }
+
+            // Hand the buffers back for the next frame
+            pending.clear();
+            let mut arena = arena.lock();
+            if arena.is_empty() {
+                *arena = pending;
+            }
+        }
+    }
+
+    /// Remove all handlers for an event
+    fn remove_hook(&self, name: &str) -> bool {
+        let mut current = self.hooks.write();
+        let key = hash_str(name);
+        if current.get(&key).map_or(true, |hook| hook.name != name) {
+            return false;
+        }
+
+        let mut table = HookTable::clone(&current);
+        table.remove(&key);
+        *current = Arc::new(table);
+        true
+    }
+
+    /// Find the hook for an event, using the engine id when possible
+    ///
+    /// A cached id is trusted. Otherwise the event's name is compared with
+    /// the hook's, and the id is only cached if the hash isn't taken by
+    /// another event.
+    fn find_hook(&self, event: &GameEventRef) -> Option<Arc<EventHook>> {
+        // Held until the id is cached, so a hook added meanwhile clears it
+        let table = self.hooks.read();
+        let slot = usize::try_from(event.get_id())
+            .ok()
+            .and_then(|id| self.id_cache.get(id));
+
+        if let Some(slot) = slot {
+            let cached = slot.load(Ordering::Relaxed);
+            if cached != 0 {
+                return table.get(&cached).cloned();
+            }
+        }
+
+        let name = event.get_name();
+        let hash = hash_str(name);
+        match table.get(&hash) {
+            Some(hook) if hook.name != name => None,
+            hook => {
+                if let Some(slot) = slot {
+                    slot.store(hash, Ordering::Relaxed);
+                }
+                hook.cloned()
+            }
+        }
+    }
+
+    /// Forget cached event ids (event descriptors were reloaded)
+    pub(crate) fn clear_event_ids(&self) {
+        for slot in self.id_cache.iter() {
+            slot.store(0, Ordering::Relaxed);
+        }
+    }
+
     /// Duplicate an event for post-hook processing
     fn duplicate_event(&self, event: *mut IGameEvent) -> *mut IGameEvent {
-        let manager = match Self::game_event_manager() {
+        let manager = match self.engine() {
             Some(m) => m.as_ptr(),
             None => return std::ptr::null_mut(),
         };
@@ -114,7 +513,7 @@ impl EventManager {
             return;
         }
 
-        let manager = match Self::game_event_manager() {
+        let manager = match self.engine() {
             Some(m) => m.as_ptr(),
             None => return,
         };
@@ -129,68 +528,111 @@ impl EventManager {
     /// Handle pre-fire event
     ///
     /// Returns (should_continue, modified_dont_broadcast)
-    fn on_fire_event(&mut self, event: *mut IGameEvent, dont_broadcast: bool) -> (bool, bool) {
+    pub(super) fn on_fire_event(
+        &self,
+        event: *mut IGameEvent,
+        dont_broadcast: bool,
+    ) -> (bool, bool) {
         let event_ref = match unsafe { GameEventRef::from_ptr(event) } {
             Some(e) => e,
             None => {
-                self.event_stack.push(None);
+                EVENT_STACK.with_borrow_mut(|stack| stack.push(None));
                 return (true, dont_broadcast);
             }
         };
 
-        let name = event_ref.get_name().to_string();
         let mut local_dont_broadcast = dont_broadcast;
 
-        if let Some(hook) = self.hooks.get(&name) {
-            self.event_stack.push(Some(name.clone()));
+        let Some(hook) = self.find_hook(&event_ref) else {
+            EVENT_STACK.with_borrow_mut(|stack| stack.push(None));
+            return (true, local_dont_broadcast);
+        };
 
-            // Run pre-hooks
-            for callback in &hook.pre_hooks {
-                let mut info = EventInfo::new(local_dont_broadcast);
-                let result = callback(&event_ref, &mut info);
-                local_dont_broadcast = info.dont_broadcast;
+        // Run pre-hooks
+        let mut filter_fields = FilterFields::new(&event_ref, &hook.filter_fields);
+        for handler in &hook.pre_hooks {
+            if !filter_fields.matches(&handler.filter) {
+                continue;
+            }
+            let mut info = EventInfo::new(local_dont_broadcast);
+            let result = {
+                let _scope = handler.profile.scope();
+                (handler.callback)(&event_ref, &mut info)
+            };
+            local_dont_broadcast = info.dont_broadcast;
 
-                if result >= HookResult::Handled {
-                    // Block the event, but duplicate for post-hooks
-                    self.event_copies.push(self.duplicate_event(event));
-                    self.free_event(event);
-                    return (false, local_dont_broadcast);
-                }
+            if result >= HookResult::Handled {
+                // Blocked events never reach post processing
+                self.free_event(event);
+                return (false, local_dont_broadcast);
             }
+        }
 
-            // Duplicate for post-hook access
-            self.event_copies.push(self.duplicate_event(event));
-        } else {
-            self.event_stack.push(None);
+        if let Some(arena) = &hook.batch_arena {
+            arena.lock().capture(&event_ref, &hook.batch_fields);
         }
 
+        // The engine frees the event inside FireEvent, so post hooks need
+        // their data taken now
+        let copy = if hook.post_hooks.is_empty() {
+            std::ptr::null_mut()
+        } else {
+            self.duplicate_event(event)
+        };
+        let snapshot = if hook.snapshot_hooks.is_empty() {
+            None
+        } else {
+            let mut snapshot = SNAPSHOT_POOL
+                .with_borrow_mut(|pool| pool.pop())
+                .unwrap_or_default();
+            snapshot.capture(&event_ref, &hook.snapshot_fields);
+            Some(snapshot)
+        };
+
+        EVENT_STACK.with_borrow_mut(|stack| {
+            stack.push(Some(FiringEvent {
+                hook,
+                copy,
+                snapshot,
+            }))
+        });
         (true, local_dont_broadcast)
     }
 
     /// Handle post-fire event
-    fn on_fire_event_post(&mut self, _event: *mut IGameEvent, dont_broadcast: bool) {
-        let hook_name = self.event_stack.pop();
-
-        if let Some(Some(name)) = hook_name {
-            if let Some(hook) = self.hooks.get(&name) {
-                if !hook.post_hooks.is_empty() {
-                    if let Some(event_copy) = self.event_copies.pop() {
-                        if let Some(event_ref) = unsafe { GameEventRef::from_ptr(event_copy) } {
-                            let mut info = EventInfo::new(dont_broadcast);
-                            for callback in &hook.post_hooks {
-                                callback(&event_ref, &mut info);
-                            }
-                        }
-                        self.free_event(event_copy);
-                    }
-                } else {
-                    // No post hooks, just free the copy
-                    if let Some(event_copy) = self.event_copies.pop() {
-                        self.free_event(event_copy);
-                    }
+    pub(super) fn on_fire_event_post(&self, _event: *mut IGameEvent, dont_broadcast: bool) {
+        let Some(Some(firing)) = EVENT_STACK.with_borrow_mut(|stack| stack.pop()) else {
+            return;
+        };
+
+        if let Some(event_ref) = unsafe { GameEventRef::from_ptr(firing.copy) } {
+            let mut info = EventInfo::new(dont_broadcast);
+            let mut filter_fields = FilterFields::new(&event_ref, &firing.hook.filter_fields);
+            for handler in &firing.hook.post_hooks {
+                if !filter_fields.matches(&handler.filter) {
+                    continue;
                 }
+                let _scope = handler.profile.scope();
+                (handler.callback)(&event_ref, &mut info);
+            }
+        }
+
+        if let Some(snapshot) = &firing.snapshot {
+            let mut info = EventInfo::new(dont_broadcast);
+            for handler in &firing.hook.snapshot_hooks {
+                let _scope = handler.profile.scope();
+                (handler.callback)(snapshot, &mut info);
             }
         }
+
+        self.free_event(firing.copy);
+        if let Some(snapshot) = firing.snapshot {
+            SNAPSHOT_POOL.with_borrow_mut(|pool| {
+                if pool.len() < SNAPSHOT_POOL_SIZE {
+                    pool.push(snapshot);
+                }
+            });
+        }
     }
 }
 
@@ -204,30 +646,130 @@ pub fn register_event<F>(name: &str, post: bool, callback: F)
 where
     F: Fn(&GameEventRef, &mut EventInfo) -> HookResult + Send + Sync + 'static,
 {
-    let mut manager = EVENTS.write();
+    let handler = EventHandler {
+        filter: Box::default(),
+        callback: Box::new(callback),
+        profile: ProfileHandle::new(
+            ProfileKind::Event,
+            &format!("{} {}", name, std::any::type_name::<F>()),
+        ),
+    };
 
-    let hook = manager.hooks.entry(name.to_string()).or_insert_with(|| {
-        tracing::debug!("Registering new event hook: {}", name);
-        EventHook {
-            name: name.to_string(),
-            pre_hooks: Vec::new(),
-            post_hooks: Vec::new(),
-        }
-    });
+    EVENTS.add_handler(name, post, handler);
+}
 
-    if post {
-        hook.post_hooks.push(Box::new(callback));
-    } else {
-        hook.pre_hooks.push(Box::new(callback));
-    }
+/// Register an event handler that only runs for matching events
+///
+/// The dispatcher checks `filter` before calling the handler, reading each
+/// filtered field once per event no matter how many handlers filter on it.
+///
+/// # Arguments
+/// * `name` - Event name (e.g., "player_hurt")
+/// * `post` - If true, handler runs after event fires; otherwise before
+/// * `filter` - Conditions the event must meet
+/// * `callback` - Function to call when a matching event fires
+///
+/// # Example
+///
+/// ```ignore
+/// register_event_filtered(
+///     "player_hurt",
+///     false,
+///     EventFilter::new().int_range("dmg_health", 100..),
+///     |event, _info| {
+///         tracing::info!("{} took a big hit", event.get_int("userid", -1));
+///         HookResult::Continue
+///     },
+/// );
+/// ```
+pub fn register_event_filtered<F>(name: &str, post: bool, filter: EventFilter, callback: F)
+where
+    F: Fn(&GameEventRef, &mut EventInfo) -> HookResult + Send + Sync + 'static,
+{
+    let handler = EventHandler {
+        filter: Box::default(),
+        callback: Box::new(callback),
+        profile: ProfileHandle::new(
+            ProfileKind::Event,
+            &format!("{} {}", name, std::any::type_name::<F>()),
+        ),
+    };
+
+    EVENTS.add_filtered_handler(name, post, &filter, handler);
+}
+
+/// Register a post-hook that reads a snapshot of declared fields
+///
+/// The fields are captured from the live event before it fires, so no
+/// engine copy of the event is made for this handler. Getters for fields
+/// that were not declared return their default.
+///
+/// # Arguments
+/// * `name` - Event name (e.g., "player_hurt")
+/// * `fields` - Fields the callback reads
+/// * `callback` - Function to call after the event fires
+///
+/// # Example
+///
+/// ```ignore
+/// register_event_snapshot(
+///     "player_hurt",
+///     &[EventField::int("attacker"), EventField::int("dmg_health")],
+///     |event, _info| {
+///         track_damage(event.get_int("attacker", -1), event.get_int("dmg_health", 0));
+///         HookResult::Continue
+///     },
+/// );
+/// ```
+pub fn register_event_snapshot<F>(name: &str, fields: &[EventField], callback: F)
+where
+    F: Fn(&EventSnapshot, &mut EventInfo) -> HookResult + Send + Sync + 'static,
+{
+    let handler = SnapshotHandler {
+        callback: Box::new(callback),
+        profile: ProfileHandle::new(
+            ProfileKind::Event,
+            &format!("{} {}", name, std::any::type_name::<F>()),
+        ),
+    };
 
-    tracing::trace!(
-        "Added {} handler for event '{}' (total: {} pre, {} post)",
-        if post { "post" } else { "pre" },
-        name,
-        hook.pre_hooks.len(),
-        hook.post_hooks.len()
-    );
+    EVENTS.add_snapshot_handler(name, fields, handler);
+}
+
+/// Register a subscriber that receives an event's batch once per frame
+///
+/// Instead of a call per event, the dispatcher captures `fields` from each
+/// event that fires (and isn't blocked) and calls `callback` once at the
+/// end of the GameFrame with all of them. Suited to stats trackers and HUD
+/// updaters on hot events like `player_hurt` and `weapon_fire`.
+///
+/// # Arguments
+/// * `name` - Event name (e.g., "weapon_fire")
+/// * `fields` - Fields the callback reads
+/// * `callback` - Function to call with the frame's events
+///
+/// # Example
+///
+/// ```ignore
+/// register_event_batched("weapon_fire", &[EventField::int("userid")], |batch| {
+///     for event in batch.iter() {
+///         count_shot(event.get_int("userid", -1));
+///     }
+/// });
+/// ```
+pub fn register_event_batched<F>(name: &str, fields: &[EventField], callback: F)
+where
+    F: Fn(&EventBatch) + Send + Sync + 'static,
+{
+    let handler = BatchHandler {
+        callback: Box::new(callback),
+        profile: ProfileHandle::new(
+            ProfileKind::Event,
+            &format!("{} {}", name, std::any::type_name::<F>()),
+        ),
+    };
+
+    EVENTS.add_batch_handler(name, fields, handler);
 }
 
 /// Unregister all handlers for an event
@@ -238,8 +780,7 @@ where
 /// # Returns
 /// true if the event was found and removed
 pub fn unregister_event(name: &str) -> bool {
-    let mut manager = EVENTS.write();
-    let removed = manager.hooks.remove(name).is_some();
+    let removed = EVENTS.remove_hook(name);
     if removed {
         tracing::debug!("Unregistered all handlers for event: {}", name);
     }
@@ -260,11 +801,12 @@ extern "C" fn fire_event_detour(
     }
     let original: FireEventFn = unsafe { std::mem::transmute(original_ptr) };
 
+    if super::record::is_recording() {
+        super::record::record_event(event, dont_broadcast);
+    }
+
     // Pre-hook processing
-    let (should_continue, new_dont_broadcast) = {
-        let mut manager = EVENTS.write();
-        manager.on_fire_event(event, dont_broadcast)
-    };
+    let (should_continue, new_dont_broadcast) = EVENTS.on_fire_event(event, dont_broadcast);
 
     if !should_continue {
         // Event was blocked
@@ -272,47 +814,109 @@ extern "C" fn fire_event_detour(
     }
 
     // Call original
-    let result = original(this, event, new_dont_broadcast);
+    let result = {
+        let _scope = FIRE_EVENT_PROFILE.scope();
+        original(this, event, new_dont_broadcast)
+    };
 
     // Post-hook processing
-    {
-        let mut manager = EVENTS.write();
-        manager.on_fire_event_post(event, new_dont_broadcast);
-    }
+    EVENTS.on_fire_event_post(event, new_dont_broadcast);
 
     result
 }
 
+/// Our LoadEventsFromFile detour
+///
+/// Event ids can change when descriptors are loaded, so the id cache and
+/// the event pools are reset, then the file's definitions are read (if the
+/// file is on disk) and the built-in typed events checked against them.
+extern "C" fn load_events_detour(
+    this: *mut IGameEventManager2,
+    filename: *const c_char,
+    search_all: bool,
+) -> i32 {
+    let original_ptr = ORIGINAL_LOAD_EVENTS.load(Ordering::Acquire);
+    if original_ptr.is_null() {
+        tracing::error!("LoadEventsFromFile original is null!");
+        return 0;
+    }
+    let original: LoadEventsFromFileFn = unsafe { std::mem::transmute(original_ptr) };
+
+    let loaded = original(this, filename, search_all);
+
+    EVENTS.clear_event_ids();
+    super::create::release_pools();
+
+    if !filename.is_null() {
+        let filename = unsafe { CStr::from_ptr(filename) }.to_string_lossy();
+        tracing::debug!(
+            "LoadEventsFromFile('{}') loaded {} events",
+            filename,
+            loaded
+        );
+        if super::definitions::load_file(&filename).is_some() {
+            let definitions = super::definitions::event_definitions();
+            super::record::describe_events(&definitions);
+            super::definitions::check_builtin_events(&definitions);
+        }
+    }
+
+    loaded
+}
+
 /// Initialize event hooks
 ///
-/// This needs to be called after the game event manager is available.
-/// We hook LoadEventsFromFile to capture the IGameEventManager2 pointer,
-/// then hook FireEvent for event interception.
+/// Installs the hooks right away if the game event manager is already
+/// known, otherwise [`set_game_event_manager`] installs them when it is.
 pub fn init_event_hooks() -> Result<(), HookError> {
-    // For now, we'll set up the infrastructure but the actual hooking
-    // will happen when we detect the game event manager.
-    // This is typically done via a LoadEventsFromFile hook or by
-    // finding the CGameEventManager vtable in memory.
-
-    tracing::info!("Event system initialized (waiting for game event manager)");
+    match EventManager::game_event_manager() {
+        Some(manager) => install_hooks(manager.as_ptr())?,
+        None => tracing::info!("Event system initialized (waiting for game event manager)"),
+    }
     Ok(())
 }
 
-/// Hook FireEvent on the game event manager
+/// Hook LoadEventsFromFile and FireEvent on the game event manager
 ///
-/// Called once we have the IGameEventManager2 pointer.
-pub fn hook_fire_event(manager: *mut IGameEventManager2) -> Result<(), HookError> {
+/// Does nothing if the hooks are already installed.
+fn install_hooks(manager: *mut IGameEventManager2) -> Result<(), HookError> {
     if manager.is_null() {
         return Err(HookError::InvalidAddress(0));
     }
 
-    // Store the manager pointer
-    GAME_EVENT_MANAGER.store(manager, Ordering::Release);
+    let mut keys = HOOK_KEYS.write();
+    if keys.fire_event_hook.is_some() {
+        return Ok(());
+    }
 
     unsafe {
         // Get vtable
         let vtable = *(manager as *const *mut *const ());
 
+        // Hook LoadEventsFromFile first so no reload is missed between the two
+        let load_events = match keys.load_events_hook {
+            Some(_) => None,
+            None => Some(crate::hooks::vtable::create_vtable_hook_direct(
+                "IGameEventManager2::LoadEventsFromFile",
+                vtable,
+                vtable::LOAD_EVENTS_FROM_FILE,
+                load_events_detour as *const (),
+            )),
+        };
+        match load_events {
+            None => {}
+            Some(Ok((key, original))) => {
+                ORIGINAL_LOAD_EVENTS.store(original as *mut c_void, Ordering::Release);
+                keys.load_events_hook = Some(key);
+                tracing::info!(
+                    "Hooked IGameEventManager2::LoadEventsFromFile at {:p}",
+                    original
+                );
+            }
+            // Dispatch works without it, only definitions aren't tracked
+            Some(Err(e)) => tracing::warn!("Failed to hook LoadEventsFromFile: {:?}", e),
+        }
+
         // Hook FireEvent
         let (key, original) = crate::hooks::vtable::create_vtable_hook_direct(
             "IGameEventManager2::FireEvent",
@@ -322,7 +926,7 @@ pub fn hook_fire_event(manager: *mut IGameEventManager2) -> Result<(), HookError
         )?;
 
         ORIGINAL_FIRE_EVENT.store(original as *mut c_void, Ordering::Release);
-        HOOK_KEYS.write().fire_event_hook = Some(key);
+        keys.fire_event_hook = Some(key);
 
         tracing::info!("Hooked IGameEventManager2::FireEvent at {:p}", original);
     }
@@ -330,14 +934,19 @@ pub fn hook_fire_event(manager: *mut IGameEventManager2) -> Result<(), HookError
     Ok(())
 }
 
-/// Set the game event manager pointer (called from external hook)
+/// Set the game event manager pointer and install the event hooks
+///
+/// Called by whatever acquires the manager (an interface lookup or an
+/// external hook).
 pub fn set_game_event_manager(manager: *mut IGameEventManager2) {
     let old = GAME_EVENT_MANAGER.swap(manager, Ordering::AcqRel);
+    if old != manager {
+        EVENTS.clear_event_ids();
+    }
     if old.is_null() && !manager.is_null() {
         tracing::info!("IGameEventManager2 acquired: {:p}", manager);
 
-        // Try to hook FireEvent
-        if let Err(e) = hook_fire_event(manager) {
+        if let Err(e) = install_hooks(manager) {
             tracing::error!("Failed to hook FireEvent: {:?}", e);
         }
     }
@@ -361,6 +970,403 @@ pub fn shutdown_event_hooks() {
 
     GAME_EVENT_MANAGER.store(std::ptr::null_mut(), Ordering::Release);
     ORIGINAL_FIRE_EVENT.store(std::ptr::null_mut(), Ordering::Release);
+    ORIGINAL_LOAD_EVENTS.store(std::ptr::null_mut(), Ordering::Release);
 
     tracing::info!("Event system shutdown complete");
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEvent;
+    use std::sync::atomic::AtomicUsize;
+
+    fn counting_handler(calls: &Arc<AtomicUsize>) -> EventHandler {
+        let calls = calls.clone();
+        EventHandler {
+            filter: Box::default(),
+            callback: Box::new(move |_, _| {
+                calls.fetch_add(1, Ordering::Relaxed);
+                HookResult::Continue
+            }),
+            profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+        }
+    }
+
+    fn fire(manager: &EventManager, event: &mut ReplayEvent) {
+        let (should_continue, dont_broadcast) = manager.on_fire_event(event.as_ptr(), false);
+        assert!(should_continue);
+        manager.on_fire_event_post(event.as_ptr(), dont_broadcast);
+    }
+
+    fn stack_depth() -> usize {
+        EVENT_STACK.with_borrow(|stack| stack.len())
+    }
+
+    #[test]
+    fn test_dispatch_by_event_id() {
+        let manager = EventManager::new();
+        let pre_calls = Arc::new(AtomicUsize::new(0));
+        let post_calls = Arc::new(AtomicUsize::new(0));
+        manager.add_handler("player_death", false, counting_handler(&pre_calls));
+        manager.add_handler("player_death", true, counting_handler(&post_calls));
+
+        let mut event = ReplayEvent::new("player_death", 7);
+        fire(&manager, &mut event);
+        fire(&manager, &mut event);
+
+        assert_eq!(pre_calls.load(Ordering::Relaxed), 2);
+        // Post hooks read a duplicate made through the engine's manager,
+        // which doesn't exist here
+        assert_eq!(post_calls.load(Ordering::Relaxed), 0);
+        assert_eq!(
+            manager.id_cache[7].load(Ordering::Relaxed),
+            hash_str("player_death")
+        );
+        assert_eq!(stack_depth(), 0);
+    }
+
+    #[test]
+    fn test_unhooked_event_is_skipped() {
+        let manager = EventManager::new();
+        let calls = Arc::new(AtomicUsize::new(0));
+        manager.add_handler("round_start", false, counting_handler(&calls));
+
+        let mut unhooked = ReplayEvent::new("weapon_fire", 3);
+        fire(&manager, &mut unhooked);
+        assert_eq!(calls.load(Ordering::Relaxed), 0);
+        assert_eq!(stack_depth(), 0);
+
+        // Events without a usable id fall back to hashing the name
+        let mut no_id = ReplayEvent::new("round_start", -1);
+        fire(&manager, &mut no_id);
+        assert_eq!(calls.load(Ordering::Relaxed), 1);
+    }
+
+    #[test]
+    fn test_hash_collision_checks_names() {
+        // Different names with the same FNV-1a hash
+        assert_eq!(
+            hash_str("custom_event_57178"),
+            hash_str("custom_event_499006")
+        );
+        let manager = EventManager::new();
+        let calls = Arc::new(AtomicUsize::new(0));
+        manager.add_handler("custom_event_57178", false, counting_handler(&calls));
+
+        let mut other = ReplayEvent::new("custom_event_499006", 9);
+        fire(&manager, &mut other);
+        fire(&manager, &mut other);
+        assert_eq!(calls.load(Ordering::Relaxed), 0);
+        assert_eq!(manager.id_cache[9].load(Ordering::Relaxed), 0);
+        assert!(!manager.remove_hook("custom_event_499006"));
+
+        let mut hooked = ReplayEvent::new("custom_event_57178", 8);
+        fire(&manager, &mut hooked);
+        assert_eq!(calls.load(Ordering::Relaxed), 1);
+        assert!(manager.remove_hook("custom_event_57178"));
+    }
+
+    #[test]
+    fn test_adding_hook_clears_cached_ids() {
+        let manager = EventManager::new();
+        let mut event = ReplayEvent::new("round_end", 5);
+        fire(&manager, &mut event);
+        assert_eq!(
+            manager.id_cache[5].load(Ordering::Relaxed),
+            hash_str("round_end")
+        );
+
+        let calls = Arc::new(AtomicUsize::new(0));
+        manager.add_handler("round_start", false, counting_handler(&calls));
+        assert_eq!(manager.id_cache[5].load(Ordering::Relaxed), 0);
+    }
+
+    #[test]
+    fn test_no_copy_without_post_hooks() {
+        let manager = EventManager::new();
+        let calls = Arc::new(AtomicUsize::new(0));
+        manager.add_handler("player_hurt", false, counting_handler(&calls));
+
+        let mut event = ReplayEvent::new("player_hurt", 4);
+        let (should_continue, _) = manager.on_fire_event(event.as_ptr(), false);
+        assert!(should_continue);
+        EVENT_STACK.with_borrow(|stack| {
+            let firing = stack.last().unwrap().as_ref().unwrap();
+            assert!(firing.copy.is_null());
+            assert!(firing.snapshot.is_none());
+        });
+        manager.on_fire_event_post(event.as_ptr(), false);
+        assert_eq!(stack_depth(), 0);
+    }
+
+    #[test]
+    fn test_snapshot_post_hook() {
+        let manager = EventManager::new();
+        let seen = Arc::new(parking_lot::Mutex::new(Vec::new()));
+        let seen_in_hook = seen.clone();
+        manager.add_snapshot_handler(
+            "player_hurt",
+            &[EventField::int("dmg_health"), EventField::string("weapon")],
+            SnapshotHandler {
+                callback: Box::new(move |event, _| {
+                    seen_in_hook.lock().push((
+                        event.get_int("dmg_health", -1),
+                        event.get_string("weapon", "").to_string(),
+                    ));
+                    HookResult::Continue
+                }),
+                profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+            },
+        );
+
+        let mut event = ReplayEvent::new("player_hurt", 4);
+        event.set_int("dmg_health", 40);
+        event.set_string("weapon", "awp");
+        let (should_continue, dont_broadcast) = manager.on_fire_event(event.as_ptr(), false);
+        assert!(should_continue);
+        EVENT_STACK.with_borrow(|stack| assert!(stack[0].as_ref().unwrap().copy.is_null()));
+
+        // The engine is done with the event by the time post hooks run
+        event.set_int("dmg_health", 0);
+        manager.on_fire_event_post(event.as_ptr(), dont_broadcast);
+        fire(&manager, &mut event);
+
+        assert_eq!(
+            *seen.lock(),
+            vec![(40, "awp".to_string()), (0, "awp".to_string())]
+        );
+        assert_eq!(SNAPSHOT_POOL.with_borrow(|pool| pool.len()), 1);
+    }
+
+    #[test]
+    fn test_blocked_event_leaves_no_stack_entry() {
+        let manager = EventManager::new();
+        manager.add_handler(
+            "player_chat",
+            false,
+            EventHandler {
+                filter: Box::default(),
+                callback: Box::new(|_, _| HookResult::Handled),
+                profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+            },
+        );
+
+        let mut event = ReplayEvent::new("player_chat", 9);
+        let (should_continue, _) = manager.on_fire_event(event.as_ptr(), false);
+        assert!(!should_continue);
+        assert_eq!(stack_depth(), 0);
+    }
+
+    #[test]
+    fn test_fire_event_from_pre_hook() {
+        static MANAGER: LazyLock<EventManager> = LazyLock::new(EventManager::new);
+        let order = Arc::new(parking_lot::Mutex::new(Vec::new()));
+
+        let log = order.clone();
+        MANAGER.add_handler(
+            "round_end",
+            false,
+            EventHandler {
+                filter: Box::default(),
+                callback: Box::new(move |_, _| {
+                    log.lock().push("round_end pre");
+                    // Fire a nested event and register a handler mid-dispatch
+                    let mut nested = ReplayEvent::new("round_mvp", 12);
+                    fire(&MANAGER, &mut nested);
+                    MANAGER.add_handler("round_end", false, counting_handler(&Arc::default()));
+                    assert_eq!(stack_depth(), 0);
+                    HookResult::Continue
+                }),
+                profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+            },
+        );
+        let log = order.clone();
+        MANAGER.add_snapshot_handler(
+            "round_mvp",
+            &[],
+            SnapshotHandler {
+                callback: Box::new(move |_, _| {
+                    log.lock().push("round_mvp post");
+                    HookResult::Continue
+                }),
+                profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+            },
+        );
+        let log = order.clone();
+        MANAGER.add_snapshot_handler(
+            "round_end",
+            &[],
+            SnapshotHandler {
+                callback: Box::new(move |_, _| {
+                    log.lock().push("round_end post");
+                    HookResult::Continue
+                }),
+                profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+            },
+        );
+
+        let mut event = ReplayEvent::new("round_end", 11);
+        fire(&MANAGER, &mut event);
+
+        assert_eq!(
+            *order.lock(),
+            vec!["round_end pre", "round_mvp post", "round_end post"]
+        );
+        assert_eq!(stack_depth(), 0);
+        // The handler added during dispatch is live for the next event
+        assert_eq!(
+            MANAGER.hooks.read()[&hash_str("round_end")].pre_hooks.len(),
+            2
+        );
+    }
+
+    #[test]
+    fn test_name_hash_matches_hash_str() {
+        let mut event = ReplayEvent::new("bomb_planted", 1);
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+        assert_eq!(event_ref.name_hash(), hash_str("bomb_planted"));
+        assert_eq!(event_ref.get_name(), "bomb_planted");
+    }
+
+    #[test]
+    fn test_replay_through_dispatch() {
+        use crate::events::record::{RecordedEvent, RecordedValue};
+        use crate::events::EventReplay;
+
+        let manager = EventManager::new();
+        let attackers = Arc::new(parking_lot::Mutex::new(Vec::new()));
+        let seen = attackers.clone();
+        manager.add_handler(
+            "player_death",
+            true,
+            EventHandler {
+                filter: Box::default(),
+                callback: Box::new(move |event, _| {
+                    seen.lock().push(event.get_int("attacker", -1));
+                    HookResult::Continue
+                }),
+                profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+            },
+        );
+        manager.add_handler(
+            "round_start",
+            false,
+            EventHandler {
+                filter: Box::default(),
+                callback: Box::new(|_, _| HookResult::Handled),
+                profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+            },
+        );
+
+        let record = |tick, name: &str, attacker| RecordedEvent {
+            tick,
+            id: -1,
+            dont_broadcast: false,
+            name: name.to_string(),
+            fields: vec![("attacker".to_string(), RecordedValue::Int(attacker))],
+        };
+        let mut replay = EventReplay::new(&[
+            record(40, "player_death", 4),
+            record(41, "round_start", 0),
+            record(45, "player_death", 9),
+        ]);
+        let stats = replay.run(&manager);
+
+        // Post hooks read copies made by the replay engine
+        assert_eq!(*attackers.lock(), vec![4, 9]);
+        assert_eq!((stats.events, stats.blocked, stats.ticks), (3, 1, 5));
+        assert!(manager.engine().is_none());
+        assert_eq!(stack_depth(), 0);
+    }
+
+    #[test]
+    fn test_filtered_handlers_share_reads() {
+        let manager = EventManager::new();
+        let big_hits = Arc::new(AtomicUsize::new(0));
+        let by_attacker = Arc::new(AtomicUsize::new(0));
+        let unfiltered = Arc::new(AtomicUsize::new(0));
+        manager.add_filtered_handler(
+            "player_hurt",
+            false,
+            &EventFilter::new().int_range("dmg_health", 100..),
+            counting_handler(&big_hits),
+        );
+        manager.add_filtered_handler(
+            "player_hurt",
+            false,
+            &EventFilter::new()
+                .int_eq("attacker", 3)
+                .int_range("dmg_health", 1..),
+            counting_handler(&by_attacker),
+        );
+        manager.add_handler("player_hurt", false, counting_handler(&unfiltered));
+
+        for (attacker, damage) in [(3, 27), (5, 120), (3, 100)] {
+            let mut event = ReplayEvent::new("player_hurt", 4);
+            event.set_int("attacker", attacker);
+            event.set_int("dmg_health", damage);
+            fire(&manager, &mut event);
+            // dmg_health and attacker, each read once
+            assert_eq!(event.reads(), 2);
+        }
+
+        assert_eq!(big_hits.load(Ordering::Relaxed), 2);
+        assert_eq!(by_attacker.load(Ordering::Relaxed), 2);
+        assert_eq!(unfiltered.load(Ordering::Relaxed), 3);
+        assert_eq!(
+            manager.hooks.read()[&hash_str("player_hurt")]
+                .filter_fields
+                .len(),
+            2
+        );
+    }
+
+    #[test]
+    fn test_batched_delivery_once_per_frame() {
+        let manager = EventManager::new();
+        let batches = Arc::new(parking_lot::Mutex::new(Vec::new()));
+        for field in ["userid", "weapon"] {
+            let seen = batches.clone();
+            manager.add_batch_handler(
+                "weapon_fire",
+                &[EventField::int("userid"), EventField::string(field)],
+                BatchHandler {
+                    callback: Box::new(move |batch| {
+                        let events: Vec<_> = batch
+                            .iter()
+                            .map(|e| {
+                                (
+                                    e.get_int("userid", -1),
+                                    e.get_string("weapon", "").to_string(),
+                                )
+                            })
+                            .collect();
+                        seen.lock().push(events);
+                    }),
+                    profile: ProfileHandle::new(ProfileKind::Event, "events::manager::tests"),
+                },
+            );
+        }
+
+        manager.flush_batches();
+        assert!(batches.lock().is_empty());
+
+        for userid in 1..=3 {
+            let mut event = ReplayEvent::new("weapon_fire", 6);
+            event.set_int("userid", userid);
+            event.set_string("weapon", "ak47");
+            fire(&manager, &mut event);
+        }
+        assert!(batches.lock().is_empty());
+
+        manager.flush_batches();
+        let expected: Vec<_> = (1..=3).map(|id| (id, "ak47".to_string())).collect();
+        assert_eq!(*batches.lock(), vec![expected.clone(), expected]);
+
+        // Delivered batches are not repeated
+        manager.flush_batches();
+        assert_eq!(batches.lock().len(), 2);
+        assert_eq!(&*manager.batched.read().clone(), &[hash_str("weapon_fire")]);
+    }
+}
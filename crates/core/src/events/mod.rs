@@ -6,12 +6,13 @@
 //!
 //! ```text
 //! IGameEventManager2 → FireEvent hook → Event dispatcher → Rust callbacks
+//!                                   ↘ recorder → event log → EventReplay
 //! ```
 //!
 //! # Example
 //!
 //! ```ignore
-//! use cs2rust_core::events::{register_event, HookResult, GameEventRef};
+//! use cs2rust_core::events::{register_event, register_event_snapshot, EventField, HookResult, GameEventRef};
 //!
 //! // Register a handler for player_death events
 //! register_event("player_death", false, |event, info| {
@@ -21,6 +22,35 @@
 //!     HookResult::Continue
 //! });
 //!
+//! // Filters are checked by the dispatcher, so this handler only runs for
+//! // big hits:
+//! register_event_filtered(
+//!     "player_hurt",
+//!     false,
+//!     EventFilter::new().int_range("dmg_health", 100..),
+//!     |event, _info| HookResult::Continue,
+//! );
+//!
+//! // Post hooks that only read a few fields can take a snapshot of them
+//! // instead of an engine copy of the event:
+//! register_event_snapshot("player_hurt", &[EventField::int("dmg_health")], |event, _info| {
+//!     tracing::debug!("{} damage", event.get_int("dmg_health", 0));
+//!     HookResult::Continue
+//! });
+//!
+//! // Subscribers that don't need every event right away can take them in
+//! // one batch per frame:
+//! register_event_batched("weapon_fire", &[EventField::int("userid")], |batch| {
+//!     tracing::debug!("{} shots this frame", batch.len());
+//! });
+//!
+//! // Plugins can fire events of their own; pooled names skip CreateEvent
+//! // on the firing path:
+//! reserve_events("round_announce_warmup", 4);
+//! if let Some(event) = create_event("round_announce_warmup") {
+//!     event.set_int("userid", 3).fire(false);
+//! }
+//!
 //! // Or use typed events for better ergonomics:
 //! use cs2rust_core::events::typed::{EventPlayerDeath, register_typed_event};
 //!
@@ -32,21 +62,45 @@
 //! });
 //! ```
 
+mod batch;
+mod create;
+mod definitions;
+mod filter;
+mod key;
 mod manager;
 mod raw;
+pub mod record;
+mod replay;
+mod snapshot;
 pub mod typed;
 mod types;
 
-pub use manager::{register_event, set_game_event_manager, unregister_event, EventManager, EVENTS};
+pub use batch::{BatchCallback, BatchedEvent, EventBatch};
+pub use create::{create_event, reserve_events, EventBuilder, MAX_POOLED_EVENTS};
+pub use definitions::{
+    event_definitions, event_exists, parse_definitions, EventDefinition, EventDefinitions,
+    EventKeyDefinition,
+};
+pub use filter::EventFilter;
+pub use key::{EventValue, GameEventKey};
+pub use manager::{
+    register_event, register_event_batched, register_event_filtered, register_event_snapshot,
+    set_game_event_manager, unregister_event, EventManager, EVENTS,
+};
 pub use raw::GameEventRef;
+pub use replay::{EventReplay, ReplayStats};
+pub use snapshot::{EventField, EventFieldKind, EventSnapshot, SnapshotCallback};
 pub use types::{EventCallback, EventInfo, HookResult};
 
+/// Derive macro for [`GameEvent`] (see [`cs2rust_macros::GameEvent`])
+pub use cs2rust_macros::GameEvent;
+
 // Re-export common typed events
 pub use typed::{
-    register_typed_event, EventBombDefused, EventBombExploded, EventBombPlanted,
-    EventPlayerConnect, EventPlayerDeath, EventPlayerDisconnect, EventPlayerHurt, EventPlayerSpawn,
-    EventPlayerTeam, EventRoundEnd, EventRoundFreezeEnd, EventRoundStart, EventWeaponFire,
-    GameEvent,
+    register_typed_event, register_typed_event_view, EventBombDefused, EventBombExploded,
+    EventBombPlanted, EventPlayerConnect, EventPlayerDeath, EventPlayerDisconnect, EventPlayerHurt,
+    EventPlayerSpawn, EventPlayerTeam, EventRoundEnd, EventRoundFreezeEnd, EventRoundStart,
+    EventWeaponFire, GameEvent, LazyGameEvent,
 };
 
 /// Initialize the event system
@@ -57,9 +111,23 @@ pub fn init() -> Result<(), crate::hooks::HookError> {
     manager::init_event_hooks()
 }
 
+/// End-of-frame work: deliver this frame's batched events and top up the
+/// event pools (called at the end of every GameFrame)
+pub(crate) fn frame_end() {
+    EVENTS.flush_batches();
+    create::refill_pools();
+}
+
+/// Register the event system's server commands
+pub(crate) fn register_commands() {
+    record::register_commands();
+}
+
 /// Shutdown the event system
 ///
 /// Called during plugin unload. Removes all hooks and cleans up.
 pub fn shutdown() {
+    record::stop_recording();
+    create::release_pools();
     manager::shutdown_event_hooks();
 }
@@ -5,6 +5,8 @@
 use cs2rust_sdk::IGameEvent;
 use std::ffi::{c_char, c_void, CStr, CString};
 
+use crate::schema::hash::fnv1a_32;
+
 /// VTable indices for IGameEvent methods (Linux)
 mod vtable {
     pub const GET_NAME: usize = 1;
@@ -73,6 +75,25 @@ impl GameEventRef {
         }
     }
 
+    /// Get the FNV-1a hash of the event name
+    ///
+    /// Hashes the engine's name bytes directly, without UTF-8 validation
+    /// or allocation. Matches [`hash_str`](crate::schema::hash::hash_str)
+    /// of [`get_name`](Self::get_name).
+    pub fn name_hash(&self) -> u32 {
+        unsafe {
+            let vtable = *(self.ptr as *const *const *const c_void);
+            let get_name_fn: extern "C" fn(*mut IGameEvent) -> *const c_char =
+                std::mem::transmute(*vtable.add(vtable::GET_NAME));
+            let name_ptr = get_name_fn(self.ptr);
+            if name_ptr.is_null() {
+                fnv1a_32(b"")
+            } else {
+                fnv1a_32(CStr::from_ptr(name_ptr).to_bytes())
+            }
+        }
+    }
+
     /// Get the event ID
     pub fn get_id(&self) -> i32 {
         unsafe {
@@ -105,57 +126,73 @@ impl GameEventRef {
 
     /// Get a boolean value from the event
     pub fn get_bool(&self, key: &str, default: bool) -> bool {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return default,
-        };
+        match CString::new(key) {
+            Ok(c_key) => self.get_bool_c(&c_key, default),
+            Err(_) => default,
+        }
+    }
+
+    /// [`get_bool`](Self::get_bool) with a pre-built key
+    pub(crate) fn get_bool_c(&self, key: &CStr, default: bool) -> bool {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let get_bool_fn: extern "C" fn(*mut IGameEvent, *const c_char, bool) -> bool =
                 std::mem::transmute(*vtable.add(vtable::GET_BOOL));
-            get_bool_fn(self.ptr, c_key.as_ptr(), default)
+            get_bool_fn(self.ptr, key.as_ptr(), default)
         }
     }
 
     /// Get an integer value from the event
     pub fn get_int(&self, key: &str, default: i32) -> i32 {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return default,
-        };
+        match CString::new(key) {
+            Ok(c_key) => self.get_int_c(&c_key, default),
+            Err(_) => default,
+        }
+    }
+
+    /// [`get_int`](Self::get_int) with a pre-built key
+    pub(crate) fn get_int_c(&self, key: &CStr, default: i32) -> i32 {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let get_int_fn: extern "C" fn(*mut IGameEvent, *const c_char, i32) -> i32 =
                 std::mem::transmute(*vtable.add(vtable::GET_INT));
-            get_int_fn(self.ptr, c_key.as_ptr(), default)
+            get_int_fn(self.ptr, key.as_ptr(), default)
         }
     }
 
     /// Get a 64-bit unsigned integer value from the event
     pub fn get_uint64(&self, key: &str, default: u64) -> u64 {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return default,
-        };
+        match CString::new(key) {
+            Ok(c_key) => self.get_uint64_c(&c_key, default),
+            Err(_) => default,
+        }
+    }
+
+    /// [`get_uint64`](Self::get_uint64) with a pre-built key
+    pub(crate) fn get_uint64_c(&self, key: &CStr, default: u64) -> u64 {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let get_uint64_fn: extern "C" fn(*mut IGameEvent, *const c_char, u64) -> u64 =
                 std::mem::transmute(*vtable.add(vtable::GET_UINT64));
-            get_uint64_fn(self.ptr, c_key.as_ptr(), default)
+            get_uint64_fn(self.ptr, key.as_ptr(), default)
         }
     }
 
     /// Get a float value from the event
     pub fn get_float(&self, key: &str, default: f32) -> f32 {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return default,
-        };
+        match CString::new(key) {
+            Ok(c_key) => self.get_float_c(&c_key, default),
+            Err(_) => default,
+        }
+    }
+
+    /// [`get_float`](Self::get_float) with a pre-built key
+    pub(crate) fn get_float_c(&self, key: &CStr, default: f32) -> f32 {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let get_float_fn: extern "C" fn(*mut IGameEvent, *const c_char, f32) -> f32 =
                 std::mem::transmute(*vtable.add(vtable::GET_FLOAT));
-            get_float_fn(self.ptr, c_key.as_ptr(), default)
+            get_float_fn(self.ptr, key.as_ptr(), default)
         }
     }
 
@@ -188,6 +225,29 @@ impl GameEventRef {
         }
     }
 
+    /// Borrow a string value from the event without copying it
+    ///
+    /// Returns `None` if the key is missing, empty or not valid UTF-8.
+    pub(crate) fn get_str_c(&self, key: &CStr) -> Option<&str> {
+        unsafe {
+            let vtable = *(self.ptr as *const *const *const c_void);
+            let get_string_fn: extern "C" fn(
+                *mut IGameEvent,
+                *const c_char,
+                *const c_char,
+            ) -> *const c_char = std::mem::transmute(*vtable.add(vtable::GET_STRING));
+            let result = get_string_fn(self.ptr, key.as_ptr(), c"".as_ptr());
+            if result.is_null() {
+                None
+            } else {
+                CStr::from_ptr(result)
+                    .to_str()
+                    .ok()
+                    .filter(|s| !s.is_empty())
+            }
+        }
+    }
+
     /// Get a pointer value from the event
     pub fn get_ptr(&self, key: &str) -> *mut c_void {
         let c_key = match CString::new(key) {
@@ -204,75 +264,86 @@ impl GameEventRef {
 
     /// Set a boolean value on the event
     pub fn set_bool(&self, key: &str, value: bool) {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return,
-        };
+        if let Ok(c_key) = CString::new(key) {
+            self.set_bool_c(&c_key, value);
+        }
+    }
+
+    /// [`set_bool`](Self::set_bool) with a pre-built key
+    pub(crate) fn set_bool_c(&self, key: &CStr, value: bool) {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let set_bool_fn: extern "C" fn(*mut IGameEvent, *const c_char, bool) =
                 std::mem::transmute(*vtable.add(vtable::SET_BOOL));
-            set_bool_fn(self.ptr, c_key.as_ptr(), value);
+            set_bool_fn(self.ptr, key.as_ptr(), value);
         }
     }
 
     /// Set an integer value on the event
     pub fn set_int(&self, key: &str, value: i32) {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return,
-        };
+        if let Ok(c_key) = CString::new(key) {
+            self.set_int_c(&c_key, value);
+        }
+    }
+
+    /// [`set_int`](Self::set_int) with a pre-built key
+    pub(crate) fn set_int_c(&self, key: &CStr, value: i32) {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let set_int_fn: extern "C" fn(*mut IGameEvent, *const c_char, i32) =
                 std::mem::transmute(*vtable.add(vtable::SET_INT));
-            set_int_fn(self.ptr, c_key.as_ptr(), value);
+            set_int_fn(self.ptr, key.as_ptr(), value);
         }
     }
 
     /// Set a 64-bit unsigned integer value on the event
     pub fn set_uint64(&self, key: &str, value: u64) {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return,
-        };
+        if let Ok(c_key) = CString::new(key) {
+            self.set_uint64_c(&c_key, value);
+        }
+    }
+
+    /// [`set_uint64`](Self::set_uint64) with a pre-built key
+    pub(crate) fn set_uint64_c(&self, key: &CStr, value: u64) {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let set_uint64_fn: extern "C" fn(*mut IGameEvent, *const c_char, u64) =
                 std::mem::transmute(*vtable.add(vtable::SET_UINT64));
-            set_uint64_fn(self.ptr, c_key.as_ptr(), value);
+            set_uint64_fn(self.ptr, key.as_ptr(), value);
         }
     }
 
     /// Set a float value on the event
     pub fn set_float(&self, key: &str, value: f32) {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return,
-        };
+        if let Ok(c_key) = CString::new(key) {
+            self.set_float_c(&c_key, value);
+        }
+    }
+
+    /// [`set_float`](Self::set_float) with a pre-built key
+    pub(crate) fn set_float_c(&self, key: &CStr, value: f32) {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let set_float_fn: extern "C" fn(*mut IGameEvent, *const c_char, f32) =
                 std::mem::transmute(*vtable.add(vtable::SET_FLOAT));
-            set_float_fn(self.ptr, c_key.as_ptr(), value);
+            set_float_fn(self.ptr, key.as_ptr(), value);
         }
     }
 
     /// Set a string value on the event
     pub fn set_string(&self, key: &str, value: &str) {
-        let c_key = match CString::new(key) {
-            Ok(s) => s,
-            Err(_) => return,
-        };
-        let c_value = match CString::new(value) {
-            Ok(s) => s,
-            Err(_) => return,
-        };
+        if let (Ok(c_key), Ok(c_value)) = (CString::new(key), CString::new(value)) {
+            self.set_string_c(&c_key, &c_value);
+        }
+    }
+
+    /// [`set_string`](Self::set_string) with a pre-built key and value
+    pub(crate) fn set_string_c(&self, key: &CStr, value: &CStr) {
         unsafe {
             let vtable = *(self.ptr as *const *const *const c_void);
             let set_string_fn: extern "C" fn(*mut IGameEvent, *const c_char, *const c_char) =
                 std::mem::transmute(*vtable.add(vtable::SET_STRING));
-            set_string_fn(self.ptr, c_key.as_ptr(), c_value.as_ptr());
+            set_string_fn(self.ptr, key.as_ptr(), value.as_ptr());
         }
     }
 
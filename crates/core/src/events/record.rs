@@ -0,0 +1,628 @@
+//! Event recorder
+//!
+//! While a recording is active, every event seen by the `FireEvent` detour
+//! is written to a compact binary log, which
+//! [`EventReplay`](super::EventReplay) feeds back through the dispatcher
+//! offline to measure handlers on real match traffic.
+//!
+//! `IGameEvent` can't list its keys, so the recorder saves the keys it
+//! knows for each event: those of the built-in typed events, and any added
+//! with [`describe_event`]. Other events are recorded with their name and
+//! id only.
+//!
+//! # Format
+//!
+//! Integers are LEB128 varints unless noted, signed ones zigzag-encoded.
+//!
+//! ```text
+//! log     = "CSREVLOG" version:u16le record*
+//! record  = tick id:svarint dont_broadcast:u8 name:str-ref count field*
+//! field   = key:str-ref kind:u8 value
+//! value   = u8 (bool) | svarint (int) | varint (uint64) | f32le (float)
+//!         | len bytes (string)
+//! str-ref = index [len bytes]
+//! ```
+//!
+//! Event names and keys are interned: a `str-ref` whose index is the next
+//! unused one is followed by the string, later uses only write the index.
+
+use std::collections::HashMap;
+use std::ffi::{CStr, CString};
+use std::fs::File;
+use std::io::{self, BufWriter, Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, LazyLock};
+
+use parking_lot::{Mutex, RwLock};
+
+use cs2rust_sdk::IGameEvent;
+
+use super::definitions::EventDefinitions;
+use super::raw::GameEventRef;
+use super::snapshot::{EventField, EventFieldKind};
+use crate::commands::{register_server_command, CommandInfo, CommandResult};
+use crate::entities::PlayerController;
+
+/// Magic bytes at the start of an event log
+const MAGIC: &[u8; 8] = b"CSREVLOG";
+
+/// Current log format version
+const VERSION: u16 = 1;
+
+/// Write buffer size for recordings
+const WRITE_BUFFER: usize = 64 * 1024;
+
+/// Kind bytes in the log
+mod kind {
+    pub const BOOL: u8 = 0;
+    pub const INT: u8 = 1;
+    pub const UINT64: u8 = 2;
+    pub const FLOAT: u8 = 3;
+    pub const STRING: u8 = 4;
+}
+
+/// A recorded field value
+#[derive(Debug, Clone, PartialEq)]
+pub enum RecordedValue {
+    Bool(bool),
+    Int(i32),
+    Uint64(u64),
+    Float(f32),
+    String(String),
+}
+
+/// One fired event
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct RecordedEvent {
+    /// Server frame the event fired on
+    pub tick: u64,
+    /// Engine event id
+    pub id: i32,
+    /// `dont_broadcast` as passed to `FireEvent`
+    pub dont_broadcast: bool,
+    /// Event name
+    pub name: String,
+    /// Known keys and their values
+    pub fields: Vec<(String, RecordedValue)>,
+}
+
+/// Writes events in the log format
+pub struct EventLogWriter<W: Write> {
+    out: W,
+    /// Interned names and keys by index
+    strings: HashMap<String, u32>,
+    /// Encoded record, reused between events
+    buf: Vec<u8>,
+}
+
+impl<W: Write> EventLogWriter<W> {
+    /// Start a log, writing its header
+    pub fn new(mut out: W) -> io::Result<Self> {
+        out.write_all(MAGIC)?;
+        out.write_all(&VERSION.to_le_bytes())?;
+        Ok(Self {
+            out,
+            strings: HashMap::new(),
+            buf: Vec::with_capacity(256),
+        })
+    }
+
+    /// Append an event
+    pub fn write_event(&mut self, event: &RecordedEvent) -> io::Result<()> {
+        let buf = &mut self.buf;
+        buf.clear();
+        put_varint(buf, event.tick);
+        put_varint(buf, zigzag(event.id));
+        buf.push(event.dont_broadcast as u8);
+        put_str_ref(buf, &mut self.strings, &event.name);
+        put_varint(buf, event.fields.len() as u64);
+
+        for (key, value) in &event.fields {
+            put_str_ref(buf, &mut self.strings, key);
+            match value {
+                RecordedValue::Bool(v) => buf.extend_from_slice(&[kind::BOOL, *v as u8]),
+                RecordedValue::Int(v) => {
+                    buf.push(kind::INT);
+                    put_varint(buf, zigzag(*v));
+                }
+                RecordedValue::Uint64(v) => {
+                    buf.push(kind::UINT64);
+                    put_varint(buf, *v);
+                }
+                RecordedValue::Float(v) => {
+                    buf.push(kind::FLOAT);
+                    buf.extend_from_slice(&v.to_le_bytes());
+                }
+                RecordedValue::String(v) => {
+                    buf.push(kind::STRING);
+                    put_bytes(buf, v.as_bytes());
+                }
+            }
+        }
+
+        self.out.write_all(&self.buf)
+    }
+
+    /// Flush and return the output
+    pub fn finish(mut self) -> io::Result<W> {
+        self.out.flush()?;
+        Ok(self.out)
+    }
+}
+
+fn zigzag(value: i32) -> u64 {
+    ((value << 1) ^ (value >> 31)) as u32 as u64
+}
+
+fn unzigzag(value: u64) -> i32 {
+    let value = value as u32;
+    ((value >> 1) as i32) ^ -((value & 1) as i32)
+}
+
+fn put_varint(buf: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        buf.push(value as u8 | 0x80);
+        value >>= 7;
+    }
+    buf.push(value as u8);
+}
+
+fn put_bytes(buf: &mut Vec<u8>, bytes: &[u8]) {
+    put_varint(buf, bytes.len() as u64);
+    buf.extend_from_slice(bytes);
+}
+
+fn put_str_ref(buf: &mut Vec<u8>, strings: &mut HashMap<String, u32>, s: &str) {
+    if let Some(&index) = strings.get(s) {
+        put_varint(buf, index as u64);
+        return;
+    }
+    let index = strings.len() as u32;
+    strings.insert(s.to_string(), index);
+    put_varint(buf, index as u64);
+    put_bytes(buf, s.as_bytes());
+}
+
+/// Reads a log from memory
+struct Decoder<'a> {
+    data: &'a [u8],
+    strings: Vec<String>,
+}
+
+fn invalid(message: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, message)
+}
+
+impl<'a> Decoder<'a> {
+    fn bytes(&mut self, len: usize) -> io::Result<&'a [u8]> {
+        if self.data.len() < len {
+            return Err(io::ErrorKind::UnexpectedEof.into());
+        }
+        let (bytes, rest) = self.data.split_at(len);
+        self.data = rest;
+        Ok(bytes)
+    }
+
+    fn u8(&mut self) -> io::Result<u8> {
+        Ok(self.bytes(1)?[0])
+    }
+
+    fn varint(&mut self) -> io::Result<u64> {
+        let mut value = 0u64;
+        for shift in (0..64).step_by(7) {
+            let byte = self.u8()?;
+            value |= ((byte & 0x7f) as u64) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(value);
+            }
+        }
+        Err(invalid("varint too long"))
+    }
+
+    fn string(&mut self) -> io::Result<String> {
+        let len = self.varint()? as usize;
+        String::from_utf8(self.bytes(len)?.to_vec()).map_err(|_| invalid("string is not UTF-8"))
+    }
+
+    fn str_ref(&mut self) -> io::Result<String> {
+        let index = self.varint()? as usize;
+        if index == self.strings.len() {
+            let s = self.string()?;
+            self.strings.push(s);
+        }
+        self.strings
+            .get(index)
+            .cloned()
+            .ok_or_else(|| invalid("string index out of range"))
+    }
+
+    fn event(&mut self) -> io::Result<RecordedEvent> {
+        let tick = self.varint()?;
+        let id = unzigzag(self.varint()?);
+        let dont_broadcast = self.u8()? != 0;
+        let name = self.str_ref()?;
+        let count = self.varint()? as usize;
+
+        let mut fields = Vec::with_capacity(count.min(64));
+        for _ in 0..count {
+            let key = self.str_ref()?;
+            let value = match self.u8()? {
+                kind::BOOL => RecordedValue::Bool(self.u8()? != 0),
+                kind::INT => RecordedValue::Int(unzigzag(self.varint()?)),
+                kind::UINT64 => RecordedValue::Uint64(self.varint()?),
+                kind::FLOAT => {
+                    let bytes = self.bytes(4)?;
+                    RecordedValue::Float(f32::from_le_bytes(bytes.try_into().unwrap()))
+                }
+                kind::STRING => RecordedValue::String(self.string()?),
+                _ => return Err(invalid("unknown value kind")),
+            };
+            fields.push((key, value));
+        }
+
+        Ok(RecordedEvent {
+            tick,
+            id,
+            dont_broadcast,
+            name,
+            fields,
+        })
+    }
+}
+
+/// Read every event of a log
+pub fn read_event_log(mut input: impl Read) -> io::Result<Vec<RecordedEvent>> {
+    let mut data = Vec::new();
+    input.read_to_end(&mut data)?;
+
+    let mut decoder = Decoder {
+        data: &data,
+        strings: Vec::new(),
+    };
+    if decoder.bytes(MAGIC.len())? != MAGIC {
+        return Err(invalid("not an event log"));
+    }
+    let version = u16::from_le_bytes(decoder.bytes(2)?.try_into().unwrap());
+    if version != VERSION {
+        return Err(invalid("unsupported event log version"));
+    }
+
+    let mut events = Vec::new();
+    while !decoder.data.is_empty() {
+        events.push(decoder.event()?);
+    }
+    Ok(events)
+}
+
+/// Read every event of a log file
+pub fn load_event_log(path: &Path) -> io::Result<Vec<RecordedEvent>> {
+    read_event_log(File::open(path)?)
+}
+
+/// A key the recorder reads
+struct RecordKey {
+    key: CString,
+    kind: EventFieldKind,
+}
+
+impl RecordKey {
+    fn name(&self) -> &str {
+        self.key.to_str().unwrap_or("")
+    }
+
+    fn read(&self, event: &GameEventRef) -> RecordedValue {
+        let key: &CStr = &self.key;
+        match self.kind {
+            EventFieldKind::Bool => RecordedValue::Bool(event.get_bool_c(key, false)),
+            EventFieldKind::Int => RecordedValue::Int(event.get_int_c(key, 0)),
+            EventFieldKind::Uint64 => RecordedValue::Uint64(event.get_uint64_c(key, 0)),
+            EventFieldKind::Float => RecordedValue::Float(event.get_float_c(key, 0.0)),
+            EventFieldKind::String => {
+                RecordedValue::String(event.get_str_c(key).unwrap_or("").to_string())
+            }
+        }
+    }
+}
+
+/// Keys recorded per event name
+static DESCRIPTORS: LazyLock<RwLock<HashMap<String, Arc<[RecordKey]>>>> = LazyLock::new(|| {
+    let descriptors = super::typed::BUILTIN_EVENTS
+        .iter()
+        .map(|(name, fields)| (name.to_string(), record_keys(fields)))
+        .collect();
+    RwLock::new(descriptors)
+});
+
+fn record_keys(fields: &[EventField]) -> Arc<[RecordKey]> {
+    fields
+        .iter()
+        .filter_map(|field| {
+            Some(RecordKey {
+                key: CString::new(field.name).ok()?,
+                kind: field.kind,
+            })
+        })
+        .collect()
+}
+
+/// Set the keys recorded for an event
+///
+/// Replaces any keys known for it, including those of built-in typed
+/// events.
+///
+/// # Example
+///
+/// ```ignore
+/// describe_event("bomb_beginplant", &[EventField::int("userid"), EventField::int("site")]);
+/// ```
+pub fn describe_event(name: &str, fields: &[EventField]) {
+    DESCRIPTORS
+        .write()
+        .insert(name.to_string(), record_keys(fields));
+}
+
+/// Record every key of the game's event definitions
+///
+/// Called when definitions are (re)loaded. Definitions replace keys set
+/// with [`describe_event`] for the same event.
+pub(super) fn describe_events(definitions: &EventDefinitions) {
+    let mut descriptors = DESCRIPTORS.write();
+    for definition in definitions.iter() {
+        let keys = definition
+            .keys()
+            .iter()
+            .map(|key| RecordKey {
+                key: key.c_name().to_owned(),
+                kind: key.kind(),
+            })
+            .collect();
+        descriptors.insert(definition.name().to_string(), keys);
+    }
+}
+
+/// An active recording
+struct Recorder {
+    writer: EventLogWriter<BufWriter<File>>,
+    /// Event being encoded, reused between events
+    scratch: RecordedEvent,
+    events: u64,
+    path: PathBuf,
+}
+
+/// Whether the detour should record events
+static RECORDING: AtomicBool = AtomicBool::new(false);
+
+static RECORDER: Mutex<Option<Recorder>> = Mutex::new(None);
+
+/// Errors starting a recording
+#[derive(Debug, thiserror::Error)]
+pub enum RecordError {
+    /// A recording is already running
+    #[error("an event recording is already in progress")]
+    Busy,
+
+    /// The output file could not be created
+    #[error("failed to create event log: {0}")]
+    Io(#[from] io::Error),
+}
+
+/// Check whether a recording is active
+#[inline]
+pub fn is_recording() -> bool {
+    RECORDING.load(Ordering::Relaxed)
+}
+
+/// Start recording events to `path`
+pub fn start_recording(path: &Path) -> Result<(), RecordError> {
+    let mut recorder = RECORDER.lock();
+    if recorder.is_some() {
+        return Err(RecordError::Busy);
+    }
+
+    if let Some(parent) = path.parent() {
+        std::fs::create_dir_all(parent)?;
+    }
+    let file = BufWriter::with_capacity(WRITE_BUFFER, File::create(path)?);
+
+    *recorder = Some(Recorder {
+        writer: EventLogWriter::new(file)?,
+        scratch: RecordedEvent::default(),
+        events: 0,
+        path: path.to_path_buf(),
+    });
+    RECORDING.store(true, Ordering::Release);
+    tracing::info!("Event recording started: {}", path.display());
+    Ok(())
+}
+
+/// Stop the current recording and flush the log
+///
+/// Returns the number of events written, or `None` if nothing was
+/// recording.
+pub fn stop_recording() -> Option<u64> {
+    RECORDING.store(false, Ordering::Release);
+    let recorder = RECORDER.lock().take()?;
+
+    match recorder.writer.finish() {
+        Ok(_) => tracing::info!(
+            "Event log written to {} ({} events)",
+            recorder.path.display(),
+            recorder.events
+        ),
+        Err(e) => tracing::error!(
+            "Failed to flush event log {}: {}",
+            recorder.path.display(),
+            e
+        ),
+    }
+    Some(recorder.events)
+}
+
+/// Default output path: `<cs2rust>/recordings/events_<unix time>.csrev`
+pub fn default_recording_path() -> PathBuf {
+    let secs = std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|d| d.as_secs())
+        .unwrap_or(0);
+    let dir = crate::config::cs2rust_base_dir()
+        .map(|base| base.join("recordings"))
+        .unwrap_or_else(|_| PathBuf::from("."));
+    dir.join(format!("events_{}.csrev", secs))
+}
+
+/// Record an event about to fire (called from the `FireEvent` detour)
+pub(super) fn record_event(event: *mut IGameEvent, dont_broadcast: bool) {
+    let Some(event) = (unsafe { GameEventRef::from_ptr(event) }) else {
+        return;
+    };
+
+    let mut guard = RECORDER.lock();
+    let Some(recorder) = guard.as_mut() else {
+        return;
+    };
+
+    let name = event.get_name();
+    let keys = DESCRIPTORS.read().get(name).cloned();
+
+    let scratch = &mut recorder.scratch;
+    scratch.tick = crate::hooks::frame_count();
+    scratch.id = event.get_id();
+    scratch.dont_broadcast = dont_broadcast;
+    scratch.name.clear();
+    scratch.name.push_str(name);
+
+    let keys = keys.as_deref().unwrap_or(&[]);
+    scratch.fields.truncate(keys.len());
+    for (index, key) in keys.iter().enumerate() {
+        let value = key.read(&event);
+        match scratch.fields.get_mut(index) {
+            Some(slot) => {
+                slot.0.clear();
+                slot.0.push_str(key.name());
+                slot.1 = value;
+            }
+            None => scratch.fields.push((key.name().to_string(), value)),
+        }
+    }
+
+    if let Err(e) = recorder.writer.write_event(&recorder.scratch) {
+        tracing::error!("Event recording stopped: {}", e);
+        drop(guard);
+        stop_recording();
+        return;
+    }
+    recorder.events += 1;
+}
+
+/// Register the `csr_event_record` server command
+pub(crate) fn register_commands() {
+    register_server_command(
+        "csr_event_record",
+        "Record fired events for offline replay (usage: csr_event_record [file] | stop)",
+        handle_record,
+    );
+}
+
+fn handle_record(_player: Option<&PlayerController>, info: &CommandInfo) -> CommandResult {
+    if info.arg(1) == "stop" {
+        match stop_recording() {
+            Some(events) => info.reply(&format!("Event recording stopped ({} events).", events)),
+            None => info.reply("No event recording in progress."),
+        }
+        return CommandResult::Handled;
+    }
+
+    // File names are relative to <cs2rust>/recordings and can't leave it
+    let path = match info.arg(1) {
+        "" => default_recording_path(),
+        name => match crate::config::data_file_path("recordings", name) {
+            Some(path) => path,
+            None => {
+                info.reply("The recording file must be a relative path without '..'");
+                return CommandResult::Handled;
+            }
+        },
+    };
+
+    match start_recording(&path) {
+        Ok(()) => info.reply(&format!("Recording events to {}", path.display())),
+        Err(e) => info.reply(&format!("Failed to start event recording: {}", e)),
+    }
+
+    CommandResult::Handled
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEvent;
+
+    fn death(tick: u64, attacker: i32) -> RecordedEvent {
+        RecordedEvent {
+            tick,
+            id: 23,
+            dont_broadcast: false,
+            name: "player_death".to_string(),
+            fields: vec![
+                ("attacker".to_string(), RecordedValue::Int(attacker)),
+                ("headshot".to_string(), RecordedValue::Bool(true)),
+                (
+                    "weapon".to_string(),
+                    RecordedValue::String("ak47".to_string()),
+                ),
+                ("distance".to_string(), RecordedValue::Float(-2.5)),
+                ("xuid".to_string(), RecordedValue::Uint64(u64::MAX)),
+            ],
+        }
+    }
+
+    #[test]
+    fn test_log_round_trip() {
+        let events = vec![
+            death(100, -1),
+            RecordedEvent {
+                tick: 101,
+                id: -1,
+                dont_broadcast: true,
+                name: "round_start".to_string(),
+                fields: Vec::new(),
+            },
+            death(102, i32::MIN),
+        ];
+
+        let mut writer = EventLogWriter::new(Vec::new()).unwrap();
+        for event in &events {
+            writer.write_event(event).unwrap();
+        }
+        let bytes = writer.finish().unwrap();
+
+        assert_eq!(read_event_log(bytes.as_slice()).unwrap(), events);
+        // Names and keys are only written the first time
+        let first = bytes.windows(8).position(|w| w == b"attacker").unwrap();
+        assert!(!bytes[first + 8..].windows(8).any(|w| w == b"attacker"));
+
+        assert!(read_event_log(&bytes[..bytes.len() - 1]).is_err());
+        assert!(read_event_log(&b"CSREVLOG\x09\x00"[..]).is_err());
+    }
+
+    #[test]
+    fn test_record_keys_read_event() {
+        let keys = record_keys(&[EventField::int("userid"), EventField::string("weapon")]);
+        let mut event = ReplayEvent::new("weapon_fire", 5);
+        event.set_int("userid", 3);
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+
+        let values: Vec<_> = keys
+            .iter()
+            .map(|k| (k.name(), k.read(&event_ref)))
+            .collect();
+        assert_eq!(
+            values,
+            vec![
+                ("userid", RecordedValue::Int(3)),
+                ("weapon", RecordedValue::String(String::new())),
+            ]
+        );
+    }
+}
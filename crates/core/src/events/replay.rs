@@ -0,0 +1,451 @@
+//! Offline event replay
+//!
+//! [`ReplayEvent`] lays out a fake vtable matching the indices in
+//! `raw::vtable`, and [`ReplayEngine`] stands in for `IGameEventManager2`'s
+//! event lifetime methods, so the real `GameEventRef` and
+//! [`EventManager`] code paths run without the engine. Tests use the events
+//! directly; [`EventReplay`] builds one per record of an event log and fires
+//! them through a manager in recorded order, the way `fire_event_detour`
+//! does on a server.
+
+use std::cell::Cell;
+use std::ffi::{c_char, c_void, CStr, CString};
+use std::path::Path;
+use std::sync::LazyLock;
+use std::time::{Duration, Instant};
+
+use cs2rust_sdk::{IGameEvent, IGameEventManager2};
+
+use super::manager::EventManager;
+use super::record::{load_event_log, RecordedEvent, RecordedValue};
+
+/// Number of vtable slots in the fakes
+const VTABLE_SLOTS: usize = 32;
+
+/// Vtable pointer table
+struct ReplayVTable([*const c_void; VTABLE_SLOTS]);
+
+// SAFETY: the table only holds function pointers
+unsafe impl Send for ReplayVTable {}
+unsafe impl Sync for ReplayVTable {}
+
+static EVENT_VTABLE: LazyLock<ReplayVTable> = LazyLock::new(|| {
+    let mut slots = [unsupported as *const c_void; VTABLE_SLOTS];
+    slots[1] = get_name as *const c_void;
+    slots[2] = get_id as *const c_void;
+    slots[3] = is_reliable as *const c_void;
+    slots[4] = is_local as *const c_void;
+    slots[6] = get_bool as *const c_void;
+    slots[7] = get_int as *const c_void;
+    slots[8] = get_uint64 as *const c_void;
+    slots[9] = get_float as *const c_void;
+    slots[10] = get_string as *const c_void;
+    slots[19] = set_bool as *const c_void;
+    slots[20] = set_int as *const c_void;
+    slots[21] = set_uint64 as *const c_void;
+    slots[22] = set_float as *const c_void;
+    slots[23] = set_string as *const c_void;
+    ReplayVTable(slots)
+});
+
+static ENGINE_VTABLE: LazyLock<ReplayVTable> = LazyLock::new(|| {
+    let mut slots = [unsupported as *const c_void; VTABLE_SLOTS];
+    slots[6] = create_event as *const c_void;
+    slots[7] = fire_event as *const c_void;
+    slots[9] = duplicate_event as *const c_void;
+    slots[10] = free_event as *const c_void;
+    ReplayVTable(slots)
+});
+
+/// A value stored on a replay event
+#[derive(Clone)]
+enum ReplayValue {
+    Bool(bool),
+    Int(i32),
+    Uint64(u64),
+    Float(f32),
+    String(CString),
+}
+
+/// A fake game event
+#[derive(Clone)]
+#[repr(C)]
+pub(crate) struct ReplayEvent {
+    vtable: *const *const c_void,
+    name: CString,
+    id: i32,
+    fields: Vec<(CString, ReplayValue)>,
+    reads: Cell<usize>,
+    /// Made by the engine (and owned by whoever frees it)
+    owned: bool,
+}
+
+impl ReplayEvent {
+    /// Create an event with the given name and engine id
+    pub fn new(name: &str, id: i32) -> Box<Self> {
+        Box::new(Self {
+            vtable: EVENT_VTABLE.0.as_ptr(),
+            name: CString::new(name).unwrap_or_default(),
+            id,
+            fields: Vec::new(),
+            reads: Cell::new(0),
+            owned: false,
+        })
+    }
+
+    /// Create an event holding a recorded event's fields
+    pub fn from_record(record: &RecordedEvent) -> Box<Self> {
+        let mut event = Self::new(&record.name, record.id);
+        for (key, value) in &record.fields {
+            let value = match value {
+                RecordedValue::Bool(v) => ReplayValue::Bool(*v),
+                RecordedValue::Int(v) => ReplayValue::Int(*v),
+                RecordedValue::Uint64(v) => ReplayValue::Uint64(*v),
+                RecordedValue::Float(v) => ReplayValue::Float(*v),
+                RecordedValue::String(v) => {
+                    ReplayValue::String(CString::new(v.as_str()).unwrap_or_default())
+                }
+            };
+            event.set(key, value);
+        }
+        event
+    }
+
+    fn set(&mut self, key: &str, value: ReplayValue) {
+        let key = CString::new(key).unwrap_or_default();
+        self.fields.retain(|(k, _)| *k != key);
+        self.fields.push((key, value));
+    }
+
+    fn set_c(&mut self, key: *const c_char, value: ReplayValue) {
+        let key = unsafe { CStr::from_ptr(key) };
+        match self.fields.iter_mut().find(|(k, _)| k.as_c_str() == key) {
+            Some((_, slot)) => *slot = value,
+            None => self.fields.push((key.to_owned(), value)),
+        }
+    }
+
+    fn get(&self, key: *const c_char) -> Option<&ReplayValue> {
+        self.reads.set(self.reads.get() + 1);
+        let key = unsafe { CStr::from_ptr(key) };
+        self.fields
+            .iter()
+            .find(|(k, _)| k.as_c_str() == key)
+            .map(|(_, v)| v)
+    }
+
+    /// Pointer usable wherever the engine passes an `IGameEvent*`
+    pub fn as_ptr(&mut self) -> *mut IGameEvent {
+        self as *mut Self as *mut IGameEvent
+    }
+}
+
+#[cfg(test)]
+impl ReplayEvent {
+    /// Number of field getter calls so far
+    pub fn reads(&self) -> usize {
+        self.reads.get()
+    }
+
+    /// Set a boolean field
+    pub fn set_bool(&mut self, key: &str, value: bool) {
+        self.set(key, ReplayValue::Bool(value));
+    }
+
+    /// Set an integer field
+    pub fn set_int(&mut self, key: &str, value: i32) {
+        self.set(key, ReplayValue::Int(value));
+    }
+
+    /// Set a 64-bit unsigned integer field
+    pub fn set_uint64(&mut self, key: &str, value: u64) {
+        self.set(key, ReplayValue::Uint64(value));
+    }
+
+    /// Set a float field
+    pub fn set_float(&mut self, key: &str, value: f32) {
+        self.set(key, ReplayValue::Float(value));
+    }
+
+    /// Set a string field
+    pub fn set_string(&mut self, key: &str, value: &str) {
+        self.set(
+            key,
+            ReplayValue::String(CString::new(value).unwrap_or_default()),
+        );
+    }
+}
+
+extern "C" fn unsupported() {
+    panic!("replay vtable method not implemented");
+}
+
+extern "C" fn get_name(this: *mut ReplayEvent) -> *const c_char {
+    unsafe { (*this).name.as_ptr() }
+}
+
+extern "C" fn get_id(this: *mut ReplayEvent) -> i32 {
+    unsafe { (*this).id }
+}
+
+extern "C" fn is_reliable(_: *mut ReplayEvent) -> bool {
+    true
+}
+
+extern "C" fn is_local(_: *mut ReplayEvent) -> bool {
+    false
+}
+
+extern "C" fn get_bool(this: *mut ReplayEvent, key: *const c_char, default: bool) -> bool {
+    match unsafe { (*this).get(key) } {
+        Some(ReplayValue::Bool(v)) => *v,
+        _ => default,
+    }
+}
+
+extern "C" fn get_int(this: *mut ReplayEvent, key: *const c_char, default: i32) -> i32 {
+    match unsafe { (*this).get(key) } {
+        Some(ReplayValue::Int(v)) => *v,
+        _ => default,
+    }
+}
+
+extern "C" fn get_uint64(this: *mut ReplayEvent, key: *const c_char, default: u64) -> u64 {
+    match unsafe { (*this).get(key) } {
+        Some(ReplayValue::Uint64(v)) => *v,
+        _ => default,
+    }
+}
+
+extern "C" fn get_float(this: *mut ReplayEvent, key: *const c_char, default: f32) -> f32 {
+    match unsafe { (*this).get(key) } {
+        Some(ReplayValue::Float(v)) => *v,
+        _ => default,
+    }
+}
+
+extern "C" fn get_string(
+    this: *mut ReplayEvent,
+    key: *const c_char,
+    default: *const c_char,
+) -> *const c_char {
+    match unsafe { (*this).get(key) } {
+        Some(ReplayValue::String(v)) => v.as_ptr(),
+        _ => default,
+    }
+}
+
+extern "C" fn set_bool(this: *mut ReplayEvent, key: *const c_char, value: bool) {
+    unsafe { (*this).set_c(key, ReplayValue::Bool(value)) }
+}
+
+extern "C" fn set_int(this: *mut ReplayEvent, key: *const c_char, value: i32) {
+    unsafe { (*this).set_c(key, ReplayValue::Int(value)) }
+}
+
+extern "C" fn set_uint64(this: *mut ReplayEvent, key: *const c_char, value: u64) {
+    unsafe { (*this).set_c(key, ReplayValue::Uint64(value)) }
+}
+
+extern "C" fn set_float(this: *mut ReplayEvent, key: *const c_char, value: f32) {
+    unsafe { (*this).set_c(key, ReplayValue::Float(value)) }
+}
+
+extern "C" fn set_string(this: *mut ReplayEvent, key: *const c_char, value: *const c_char) {
+    let value = unsafe { CStr::from_ptr(value) }.to_owned();
+    unsafe { (*this).set_c(key, ReplayValue::String(value)) }
+}
+
+/// A fake game event manager
+///
+/// Duplicates are heap copies of the [`ReplayEvent`] and created events are
+/// blank ones; both are freed by `FreeEvent` or `FireEvent`. Freeing an
+/// event the engine didn't make does nothing, since replayed events belong
+/// to the [`EventReplay`].
+#[repr(C)]
+pub(crate) struct ReplayEngine {
+    vtable: *const *const c_void,
+    created: Cell<usize>,
+    fired: Cell<usize>,
+    freed: Cell<usize>,
+}
+
+impl ReplayEngine {
+    pub fn new() -> Self {
+        Self {
+            vtable: ENGINE_VTABLE.0.as_ptr(),
+            created: Cell::new(0),
+            fired: Cell::new(0),
+            freed: Cell::new(0),
+        }
+    }
+
+    /// Pointer usable wherever the engine passes an `IGameEventManager2*`
+    pub fn as_ptr(&mut self) -> *mut IGameEventManager2 {
+        self as *mut Self as *mut IGameEventManager2
+    }
+}
+
+#[cfg(test)]
+impl ReplayEngine {
+    /// Number of `CreateEvent` calls so far
+    pub fn created(&self) -> usize {
+        self.created.get()
+    }
+
+    /// Number of `FireEvent` calls so far
+    pub fn fired(&self) -> usize {
+        self.fired.get()
+    }
+
+    /// Number of engine-made events freed so far
+    pub fn freed(&self) -> usize {
+        self.freed.get()
+    }
+}
+
+extern "C" fn create_event(
+    this: *mut ReplayEngine,
+    name: *const c_char,
+    _force: bool,
+    _cookie: *mut i32,
+) -> *mut ReplayEvent {
+    let name = unsafe { CStr::from_ptr(name) }.to_string_lossy();
+    let mut event = ReplayEvent::new(&name, -1);
+    event.owned = true;
+    unsafe { (*this).created.set((*this).created.get() + 1) };
+    Box::into_raw(event)
+}
+
+extern "C" fn fire_event(this: *mut ReplayEngine, event: *mut ReplayEvent, _: bool) -> bool {
+    unsafe { (*this).fired.set((*this).fired.get() + 1) };
+    free_event(this, event);
+    true
+}
+
+extern "C" fn duplicate_event(_: *mut ReplayEngine, event: *mut ReplayEvent) -> *mut ReplayEvent {
+    let mut copy = Box::new(unsafe { (*event).clone() });
+    copy.owned = true;
+    Box::into_raw(copy)
+}
+
+extern "C" fn free_event(this: *mut ReplayEngine, event: *mut ReplayEvent) {
+    if unsafe { (*event).owned } {
+        unsafe { (*this).freed.set((*this).freed.get() + 1) };
+        drop(unsafe { Box::from_raw(event) });
+    }
+}
+
+/// One event of a replay
+struct ReplayedEvent {
+    tick: u64,
+    dont_broadcast: bool,
+    event: Box<ReplayEvent>,
+}
+
+/// Result of one [`EventReplay::run`]
+#[derive(Debug, Clone, Copy)]
+pub struct ReplayStats {
+    /// Events fired
+    pub events: usize,
+    /// Events a pre hook blocked
+    pub blocked: usize,
+    /// Server ticks covered by the log
+    pub ticks: u64,
+    /// Wall time spent dispatching
+    pub elapsed: Duration,
+}
+
+/// Recorded events ready to be fired through an [`EventManager`]
+///
+/// Events are built once, so [`run`](Self::run) measures dispatch and the
+/// handlers only. Changes pre hooks make to an event are kept for the next
+/// run, as they would be on the engine's event until it is freed.
+///
+/// # Example
+///
+/// ```ignore
+/// let mut replay = EventReplay::load(Path::new("match.csrev"))?;
+/// let stats = replay.run(&EVENTS);
+/// println!("{} events in {:?}", stats.events, stats.elapsed);
+/// ```
+pub struct EventReplay {
+    events: Vec<ReplayedEvent>,
+}
+
+impl EventReplay {
+    /// Build a replay from recorded events
+    pub fn new(records: &[RecordedEvent]) -> Self {
+        Self {
+            events: records
+                .iter()
+                .map(|record| ReplayedEvent {
+                    tick: record.tick,
+                    dont_broadcast: record.dont_broadcast,
+                    event: ReplayEvent::from_record(record),
+                })
+                .collect(),
+        }
+    }
+
+    /// Load an event log written by the recorder
+    pub fn load(path: &Path) -> std::io::Result<Self> {
+        Ok(Self::new(&load_event_log(path)?))
+    }
+
+    /// Number of events in the replay
+    pub fn len(&self) -> usize {
+        self.events.len()
+    }
+
+    /// Check if the replay has no events
+    pub fn is_empty(&self) -> bool {
+        self.events.is_empty()
+    }
+
+    /// Fire every event through `manager` in recorded order
+    ///
+    /// Batched subscribers are flushed whenever the recorded tick changes,
+    /// as they would be at the end of each GameFrame.
+    ///
+    /// `manager` duplicates and frees events through a [`ReplayEngine`]
+    /// for the duration of the run, so this must not run while the engine
+    /// fires events through the same manager.
+    pub fn run(&mut self, manager: &EventManager) -> ReplayStats {
+        let mut engine = ReplayEngine::new();
+        let mut blocked = 0;
+
+        let start = Instant::now();
+        manager.with_engine(engine.as_ptr(), || {
+            let mut tick = self.events.first().map(|e| e.tick);
+            for replayed in &mut self.events {
+                if tick != Some(replayed.tick) {
+                    manager.flush_batches();
+                    tick = Some(replayed.tick);
+                }
+                let event = replayed.event.as_ptr();
+                let (should_continue, dont_broadcast) =
+                    manager.on_fire_event(event, replayed.dont_broadcast);
+                if should_continue {
+                    manager.on_fire_event_post(event, dont_broadcast);
+                } else {
+                    blocked += 1;
+                }
+            }
+            manager.flush_batches();
+        });
+        let elapsed = start.elapsed();
+
+        let ticks = match (self.events.first(), self.events.last()) {
+            (Some(first), Some(last)) => last.tick.saturating_sub(first.tick),
+            _ => 0,
+        };
+
+        ReplayStats {
+            events: self.events.len(),
+            blocked,
+            ticks,
+            elapsed,
+        }
+    }
+}
@@ -0,0 +1,277 @@
+//! Captured event fields for post hooks
+//!
+//! A post hook registered with [`register_event`](super::register_event)
+//! reads an engine copy of the event made with `DuplicateEvent` before the
+//! original fires, because the engine frees the event inside `FireEvent`.
+//! Snapshot hooks declare the fields they read instead. Those fields are
+//! captured from the live event into a pooled [`EventSnapshot`], so events
+//! whose post hooks are all snapshot hooks are never duplicated.
+
+use std::ffi::{CStr, CString};
+
+use super::raw::GameEventRef;
+use super::types::{EventInfo, HookResult};
+
+/// Value type of an event field
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum EventFieldKind {
+    /// Read with `GetBool`
+    Bool,
+    /// Read with `GetInt`
+    Int,
+    /// Read with `GetUint64`
+    Uint64,
+    /// Read with `GetFloat`
+    Float,
+    /// Read with `GetString`
+    String,
+}
+
+/// A field a snapshot hook reads
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct EventField {
+    /// Key name in the event descriptor
+    pub name: &'static str,
+    /// Value type
+    pub kind: EventFieldKind,
+}
+
+impl EventField {
+    /// Boolean field
+    pub const fn bool(name: &'static str) -> Self {
+        Self {
+            name,
+            kind: EventFieldKind::Bool,
+        }
+    }
+
+    /// Integer field
+    pub const fn int(name: &'static str) -> Self {
+        Self {
+            name,
+            kind: EventFieldKind::Int,
+        }
+    }
+
+    /// 64-bit unsigned integer field
+    pub const fn uint64(name: &'static str) -> Self {
+        Self {
+            name,
+            kind: EventFieldKind::Uint64,
+        }
+    }
+
+    /// Float field
+    pub const fn float(name: &'static str) -> Self {
+        Self {
+            name,
+            kind: EventFieldKind::Float,
+        }
+    }
+
+    /// String field
+    pub const fn string(name: &'static str) -> Self {
+        Self {
+            name,
+            kind: EventFieldKind::String,
+        }
+    }
+}
+
+/// A declared field with its key pre-built for vtable calls
+#[derive(Clone)]
+pub(super) struct CapturedField {
+    field: EventField,
+    key: CString,
+}
+
+impl CapturedField {
+    /// Build the key, or `None` if the name contains a NUL byte
+    pub(super) fn new(field: EventField) -> Option<Self> {
+        let key = CString::new(field.name).ok()?;
+        Some(Self { field, key })
+    }
+
+    /// The declared field
+    pub(super) fn field(&self) -> EventField {
+        self.field
+    }
+
+    /// The field's key
+    pub(super) fn key(&self) -> &CStr {
+        &self.key
+    }
+}
+
+/// A captured field value
+#[derive(Debug, Clone, PartialEq)]
+enum FieldValue {
+    Bool(bool),
+    Int(i32),
+    Uint64(u64),
+    Float(f32),
+    /// `None` if the key was missing or empty
+    String(Option<String>),
+}
+
+/// Field values captured from an event before it fired
+///
+/// Getters mirror [`GameEventRef`]'s and return `default` for fields that
+/// were not declared (or were declared with a different type).
+#[derive(Debug, Default)]
+pub struct EventSnapshot {
+    fields: Vec<(EventField, FieldValue)>,
+}
+
+impl EventSnapshot {
+    /// Capture `fields` from `event`, reusing this snapshot's buffers
+    pub(super) fn capture(&mut self, event: &GameEventRef, fields: &[CapturedField]) {
+        self.fields.truncate(fields.len());
+
+        for (index, captured) in fields.iter().enumerate() {
+            let key = captured.key.as_c_str();
+            let value = match captured.field.kind {
+                EventFieldKind::Bool => FieldValue::Bool(event.get_bool_c(key, false)),
+                EventFieldKind::Int => FieldValue::Int(event.get_int_c(key, 0)),
+                EventFieldKind::Uint64 => FieldValue::Uint64(event.get_uint64_c(key, 0)),
+                EventFieldKind::Float => FieldValue::Float(event.get_float_c(key, 0.0)),
+                EventFieldKind::String => {
+                    // Reuse the previous string allocation in this slot
+                    let buffer = match self.fields.get_mut(index) {
+                        Some((_, FieldValue::String(slot))) => slot.take(),
+                        _ => None,
+                    };
+                    let value = event.get_str_c(key).map(|s| {
+                        let mut buffer = buffer.unwrap_or_default();
+                        buffer.clear();
+                        buffer.push_str(s);
+                        buffer
+                    });
+                    FieldValue::String(value)
+                }
+            };
+
+            match self.fields.get_mut(index) {
+                Some(slot) => *slot = (captured.field, value),
+                None => self.fields.push((captured.field, value)),
+            }
+        }
+    }
+
+    fn value(&self, key: &str, kind: EventFieldKind) -> Option<&FieldValue> {
+        self.fields
+            .iter()
+            .find(|(field, _)| field.kind == kind && field.name == key)
+            .map(|(_, value)| value)
+    }
+
+    /// Get a captured boolean value
+    pub fn get_bool(&self, key: &str, default: bool) -> bool {
+        match self.value(key, EventFieldKind::Bool) {
+            Some(FieldValue::Bool(value)) => *value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured integer value
+    pub fn get_int(&self, key: &str, default: i32) -> i32 {
+        match self.value(key, EventFieldKind::Int) {
+            Some(FieldValue::Int(value)) => *value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured 64-bit unsigned integer value
+    pub fn get_uint64(&self, key: &str, default: u64) -> u64 {
+        match self.value(key, EventFieldKind::Uint64) {
+            Some(FieldValue::Uint64(value)) => *value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured float value
+    pub fn get_float(&self, key: &str, default: f32) -> f32 {
+        match self.value(key, EventFieldKind::Float) {
+            Some(FieldValue::Float(value)) => *value,
+            _ => default,
+        }
+    }
+
+    /// Get a captured string value
+    pub fn get_string<'a>(&'a self, key: &str, default: &'a str) -> &'a str {
+        match self.value(key, EventFieldKind::String) {
+            Some(FieldValue::String(Some(value))) => value,
+            _ => default,
+        }
+    }
+}
+
+/// Type alias for snapshot post-hook callbacks
+pub type SnapshotCallback = Box<dyn Fn(&EventSnapshot, &mut EventInfo) -> HookResult + Send + Sync>;
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEvent;
+
+    fn captured(fields: &[EventField]) -> Vec<CapturedField> {
+        fields
+            .iter()
+            .filter_map(|f| CapturedField::new(*f))
+            .collect()
+    }
+
+    #[test]
+    fn test_capture_declared_fields() {
+        let mut event = ReplayEvent::new("player_hurt", 1);
+        event.set_int("dmg_health", 27);
+        event.set_bool("headshot", true);
+        event.set_string("weapon", "ak47");
+        event.set_uint64("xuid", 76561198000000000);
+        event.set_float("distance", 3.5);
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+
+        let fields = captured(&[
+            EventField::int("dmg_health"),
+            EventField::bool("headshot"),
+            EventField::string("weapon"),
+            EventField::uint64("xuid"),
+            EventField::float("distance"),
+            EventField::float("armor"),
+        ]);
+        let mut snapshot = EventSnapshot::default();
+        snapshot.capture(&event_ref, &fields);
+
+        assert_eq!(snapshot.get_int("dmg_health", -1), 27);
+        assert!(snapshot.get_bool("headshot", false));
+        assert_eq!(snapshot.get_string("weapon", ""), "ak47");
+        assert_eq!(snapshot.get_uint64("xuid", 0), 76561198000000000);
+        assert_eq!(snapshot.get_float("distance", 0.0), 3.5);
+        // Declared but missing keys read as the type's zero value
+        assert_eq!(snapshot.get_float("armor", 1.5), 0.0);
+        // Undeclared or mistyped keys fall back to the default
+        assert_eq!(snapshot.get_int("health", -1), -1);
+        assert_eq!(snapshot.get_string("dmg_health", "none"), "none");
+    }
+
+    #[test]
+    fn test_recapture_reuses_snapshot() {
+        let fields = captured(&[EventField::string("weapon")]);
+        let mut snapshot = EventSnapshot::default();
+
+        let mut first = ReplayEvent::new("weapon_fire", 1);
+        first.set_string("weapon", "deagle");
+        snapshot.capture(
+            &unsafe { GameEventRef::from_ptr(first.as_ptr()) }.unwrap(),
+            &fields,
+        );
+        assert_eq!(snapshot.get_string("weapon", ""), "deagle");
+
+        let mut second = ReplayEvent::new("weapon_fire", 1);
+        snapshot.capture(
+            &unsafe { GameEventRef::from_ptr(second.as_ptr()) }.unwrap(),
+            &fields,
+        );
+        assert_eq!(snapshot.get_string("weapon", "none"), "none");
+    }
+}
@@ -1,26 +1,56 @@
 //! Typed game event structures
 //!
 //! Provides strongly-typed wrappers around common game events.
+//!
+//! Events implement [`GameEvent`] with `#[derive(GameEvent)]`, which reads
+//! each field through a compile-time [`GameEventKey`](super::GameEventKey)
+//! instead of building a key string per field.
+
+use cs2rust_macros::GameEvent;
 
 use super::raw::GameEventRef;
+use super::snapshot::EventField;
 
 /// Trait for typed game events
 pub trait GameEvent: Sized {
     /// The event name (e.g., "player_death")
     const NAME: &'static str;
 
+    /// Fields read by [`from_raw`](Self::from_raw)
+    ///
+    /// Used by the event recorder to know which keys to save.
+    const FIELDS: &'static [EventField] = &[];
+
     /// Create from a raw event reference
     fn from_raw(event: &GameEventRef) -> Self;
 }
 
+/// Typed events with a lazy view
+///
+/// The view reads a field from the engine the first time its accessor is
+/// called and memoizes it, so handlers that only look at one or two fields
+/// of a wide event don't decode the rest. Generated by
+/// `#[derive(GameEvent)]` as `<Event>View`.
+pub trait LazyGameEvent: GameEvent {
+    /// View type borrowing the raw event
+    type View<'a>;
+
+    /// Create a view over a raw event
+    fn view(event: &GameEventRef) -> Self::View<'_>;
+}
+
 /// Player death event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "player_death")]
 pub struct EventPlayerDeath {
     /// User ID of the player who died
+    #[game_event(default = -1)]
     pub userid: i32,
     /// User ID of the attacker
+    #[game_event(default = -1)]
     pub attacker: i32,
     /// User ID of the assister (-1 if none)
+    #[game_event(default = -1)]
     pub assister: i32,
     /// Was it a headshot?
     pub headshot: bool,
@@ -42,33 +72,15 @@ pub struct EventPlayerDeath {
     pub revenge: i32,
 }
 
-impl GameEvent for EventPlayerDeath {
-    const NAME: &'static str = "player_death";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            attacker: event.get_int("attacker", -1),
-            assister: event.get_int("assister", -1),
-            headshot: event.get_bool("headshot", false),
-            weapon: event.get_string("weapon", ""),
-            attackerblind: event.get_bool("attackerblind", false),
-            distance: event.get_float("distance", 0.0),
-            noscope: event.get_bool("noscope", false),
-            thrusmoke: event.get_bool("thrusmoke", false),
-            penetrated: event.get_int("penetrated", 0),
-            dominated: event.get_int("dominated", 0),
-            revenge: event.get_int("revenge", 0),
-        }
-    }
-}
-
 /// Player hurt event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "player_hurt")]
 pub struct EventPlayerHurt {
     /// User ID of the player who was hurt
+    #[game_event(default = -1)]
     pub userid: i32,
     /// User ID of the attacker
+    #[game_event(default = -1)]
     pub attacker: i32,
     /// Remaining health
     pub health: i32,
@@ -84,42 +96,18 @@ pub struct EventPlayerHurt {
     pub hitgroup: i32,
 }
 
-impl GameEvent for EventPlayerHurt {
-    const NAME: &'static str = "player_hurt";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            attacker: event.get_int("attacker", -1),
-            health: event.get_int("health", 0),
-            armor: event.get_int("armor", 0),
-            weapon: event.get_string("weapon", ""),
-            dmg_health: event.get_int("dmg_health", 0),
-            dmg_armor: event.get_int("dmg_armor", 0),
-            hitgroup: event.get_int("hitgroup", 0),
-        }
-    }
-}
-
 /// Player spawn event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "player_spawn")]
 pub struct EventPlayerSpawn {
     /// User ID of the player who spawned
+    #[game_event(default = -1)]
     pub userid: i32,
 }
 
-impl GameEvent for EventPlayerSpawn {
-    const NAME: &'static str = "player_spawn";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-        }
-    }
-}
-
 /// Round start event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "round_start")]
 pub struct EventRoundStart {
     /// Time limit for the round
     pub timelimit: i32,
@@ -129,20 +117,9 @@ pub struct EventRoundStart {
     pub objective: String,
 }
 
-impl GameEvent for EventRoundStart {
-    const NAME: &'static str = "round_start";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            timelimit: event.get_int("timelimit", 0),
-            fraglimit: event.get_int("fraglimit", 0),
-            objective: event.get_string("objective", ""),
-        }
-    }
-}
-
 /// Round end event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "round_end")]
 pub struct EventRoundEnd {
     /// Winning team
     pub winner: i32,
@@ -154,97 +131,52 @@ pub struct EventRoundEnd {
     pub match_end: bool,
 }
 
-impl GameEvent for EventRoundEnd {
-    const NAME: &'static str = "round_end";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            winner: event.get_int("winner", 0),
-            reason: event.get_int("reason", 0),
-            message: event.get_string("message", ""),
-            match_end: event.get_bool("match_end", false),
-        }
-    }
-}
-
 /// Round freeze end event (buy time ended)
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "round_freeze_end")]
 pub struct EventRoundFreezeEnd;
 
-impl GameEvent for EventRoundFreezeEnd {
-    const NAME: &'static str = "round_freeze_end";
-
-    fn from_raw(_event: &GameEventRef) -> Self {
-        Self
-    }
-}
-
 /// Bomb planted event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "bomb_planted")]
 pub struct EventBombPlanted {
     /// User ID of the player who planted
+    #[game_event(default = -1)]
     pub userid: i32,
     /// Bombsite (A=0, B=1)
     pub site: i32,
 }
 
-impl GameEvent for EventBombPlanted {
-    const NAME: &'static str = "bomb_planted";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            site: event.get_int("site", 0),
-        }
-    }
-}
-
 /// Bomb defused event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "bomb_defused")]
 pub struct EventBombDefused {
     /// User ID of the player who defused
+    #[game_event(default = -1)]
     pub userid: i32,
     /// Bombsite (A=0, B=1)
     pub site: i32,
 }
 
-impl GameEvent for EventBombDefused {
-    const NAME: &'static str = "bomb_defused";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            site: event.get_int("site", 0),
-        }
-    }
-}
-
 /// Bomb exploded event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "bomb_exploded")]
 pub struct EventBombExploded {
     /// User ID of the player who planted
+    #[game_event(default = -1)]
     pub userid: i32,
     /// Bombsite (A=0, B=1)
     pub site: i32,
 }
 
-impl GameEvent for EventBombExploded {
-    const NAME: &'static str = "bomb_exploded";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            site: event.get_int("site", 0),
-        }
-    }
-}
-
 /// Player connect event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "player_connect")]
 pub struct EventPlayerConnect {
     /// Player name
     pub name: String,
     /// User ID
+    #[game_event(default = -1)]
     pub userid: i32,
     /// Network ID (Steam ID string)
     pub networkid: String,
@@ -252,23 +184,12 @@ pub struct EventPlayerConnect {
     pub bot: bool,
 }
 
-impl GameEvent for EventPlayerConnect {
-    const NAME: &'static str = "player_connect";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            name: event.get_string("name", ""),
-            userid: event.get_int("userid", -1),
-            networkid: event.get_string("networkid", ""),
-            bot: event.get_bool("bot", false),
-        }
-    }
-}
-
 /// Player disconnect event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "player_disconnect")]
 pub struct EventPlayerDisconnect {
     /// User ID
+    #[game_event(default = -1)]
     pub userid: i32,
     /// Disconnect reason
     pub reason: i32,
@@ -280,24 +201,12 @@ pub struct EventPlayerDisconnect {
     pub bot: bool,
 }
 
-impl GameEvent for EventPlayerDisconnect {
-    const NAME: &'static str = "player_disconnect";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            reason: event.get_int("reason", 0),
-            name: event.get_string("name", ""),
-            networkid: event.get_string("networkid", ""),
-            bot: event.get_bool("bot", false),
-        }
-    }
-}
-
 /// Player team change event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "player_team")]
 pub struct EventPlayerTeam {
     /// User ID
+    #[game_event(default = -1)]
     pub userid: i32,
     /// New team
     pub team: i32,
@@ -311,25 +220,12 @@ pub struct EventPlayerTeam {
     pub isbot: bool,
 }
 
-impl GameEvent for EventPlayerTeam {
-    const NAME: &'static str = "player_team";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            team: event.get_int("team", 0),
-            oldteam: event.get_int("oldteam", 0),
-            disconnect: event.get_bool("disconnect", false),
-            silent: event.get_bool("silent", false),
-            isbot: event.get_bool("isbot", false),
-        }
-    }
-}
-
 /// Weapon fire event
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, GameEvent)]
+#[game_event(name = "weapon_fire")]
 pub struct EventWeaponFire {
     /// User ID
+    #[game_event(default = -1)]
     pub userid: i32,
     /// Weapon name
     pub weapon: String,
@@ -337,17 +233,22 @@ pub struct EventWeaponFire {
     pub silenced: bool,
 }
 
-impl GameEvent for EventWeaponFire {
-    const NAME: &'static str = "weapon_fire";
-
-    fn from_raw(event: &GameEventRef) -> Self {
-        Self {
-            userid: event.get_int("userid", -1),
-            weapon: event.get_string("weapon", ""),
-            silenced: event.get_bool("silenced", false),
-        }
-    }
-}
+/// Names and fields of the built-in typed events
+pub(super) const BUILTIN_EVENTS: &[(&str, &[EventField])] = &[
+    (EventPlayerDeath::NAME, EventPlayerDeath::FIELDS),
+    (EventPlayerHurt::NAME, EventPlayerHurt::FIELDS),
+    (EventPlayerSpawn::NAME, EventPlayerSpawn::FIELDS),
+    (EventRoundStart::NAME, EventRoundStart::FIELDS),
+    (EventRoundEnd::NAME, EventRoundEnd::FIELDS),
+    (EventRoundFreezeEnd::NAME, EventRoundFreezeEnd::FIELDS),
+    (EventBombPlanted::NAME, EventBombPlanted::FIELDS),
+    (EventBombDefused::NAME, EventBombDefused::FIELDS),
+    (EventBombExploded::NAME, EventBombExploded::FIELDS),
+    (EventPlayerConnect::NAME, EventPlayerConnect::FIELDS),
+    (EventPlayerDisconnect::NAME, EventPlayerDisconnect::FIELDS),
+    (EventPlayerTeam::NAME, EventPlayerTeam::FIELDS),
+    (EventWeaponFire::NAME, EventWeaponFire::FIELDS),
+];
 
 /// Helper function to register a typed event handler
 pub fn register_typed_event<E, F>(post: bool, callback: F)
@@ -360,3 +261,69 @@ where
         callback(typed, info)
     });
 }
+
+/// Register a typed event handler that receives a lazy view
+///
+/// Fields are only read from the engine when the handler asks for them.
+///
+/// # Example
+///
+/// ```ignore
+/// register_typed_event_view::<EventPlayerDeath, _>(true, |event, _info| {
+///     record_kill(event.attacker());
+///     HookResult::Continue
+/// });
+/// ```
+pub fn register_typed_event_view<E, F>(post: bool, callback: F)
+where
+    E: LazyGameEvent,
+    F: for<'a> Fn(&E::View<'a>, &mut super::EventInfo) -> super::HookResult + Send + Sync + 'static,
+{
+    super::register_event(E::NAME, post, move |event, info| {
+        callback(&E::view(event), info)
+    });
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::replay::ReplayEvent;
+
+    #[test]
+    fn test_derived_from_raw() {
+        let mut event = ReplayEvent::new("player_death", 1);
+        event.set_int("userid", 3);
+        event.set_bool("headshot", true);
+        event.set_string("weapon", "ak47");
+        event.set_float("distance", 12.5);
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+
+        let death = EventPlayerDeath::from_raw(&event_ref);
+        assert_eq!(death.userid, 3);
+        assert_eq!(death.attacker, -1);
+        assert!(death.headshot);
+        assert_eq!(death.weapon, "ak47");
+        assert_eq!(death.distance, 12.5);
+        assert_eq!(death.penetrated, 0);
+        assert_eq!(EventPlayerDeath::NAME, "player_death");
+        assert_eq!(EventPlayerDeath::FIELDS.len(), 12);
+        assert_eq!(EventPlayerDeath::FIELDS[4], EventField::string("weapon"));
+    }
+
+    #[test]
+    fn test_view_reads_fields_once() {
+        let mut event = ReplayEvent::new("player_death", 1);
+        event.set_int("attacker", 8);
+        event.set_string("weapon", "awp");
+        let event_ref = unsafe { GameEventRef::from_ptr(event.as_ptr()) }.unwrap();
+
+        let view = EventPlayerDeath::view(&event_ref);
+        assert_eq!(event.reads(), 0);
+        assert_eq!(view.attacker(), 8);
+        assert_eq!(view.attacker(), 8);
+        assert_eq!(event.reads(), 1);
+        assert_eq!(view.weapon(), "awp");
+        assert_eq!(view.userid(), -1);
+        assert_eq!(event.reads(), 3);
+    }
+}
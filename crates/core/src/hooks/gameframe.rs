@@ -1,6 +1,20 @@
 //! GameFrame hook handler
 //!
 //! Called every server tick by SourceHook via C++ bridge.
+//!
+//! # Frame Phases
+//!
+//! Each tick exposes three hook points, each with its own callback registry:
+//!
+//! - **Pre-simulation** - `GameFrame` pre-hook, before the engine simulates the tick
+//!   ([`register_pre_gameframe_callback`])
+//! - **Post-simulation** - `GameFrame` post-hook, after simulation. Queued tasks,
+//!   async tasks and timers run here ([`register_gameframe_callback`])
+//! - **Pre-world-update** - `IServerGameDLL::PreWorldUpdate`, called before the world
+//!   update that networks entity state. Batch entity writes here
+//!   ([`register_pre_world_update_callback`])
+//!
+//! Every callback is timed by the [`profiler`](crate::profiler).
 
 use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::LazyLock;
@@ -8,20 +22,55 @@ use std::sync::LazyLock;
 use parking_lot::RwLock;
 use slotmap::{new_key_type, SlotMap};
 
+use crate::profiler::{self, ProfileHandle, ProfileKind};
 use crate::tasks;
 use crate::timers;
 
 new_key_type! {
-    /// Key for registered GameFrame callbacks
+    /// Key for registered GameFrame (post-simulation) callbacks
     pub struct GameFrameKey;
+
+    /// Key for registered pre-simulation GameFrame callbacks
+    pub struct PreGameFrameKey;
+
+    /// Key for registered PreWorldUpdate callbacks
+    pub struct PreWorldUpdateKey;
 }
 
 /// Callback type for GameFrame listeners
 pub type GameFrameCallback = Box<dyn Fn(bool, bool, bool) + Send + Sync>;
 
+/// Callback type for PreWorldUpdate listeners
+pub type PreWorldUpdateCallback = Box<dyn Fn(bool) + Send + Sync>;
+
+/// A registered callback and its profile entry
+struct FrameCallback<C> {
+    callback: C,
+    profile: ProfileHandle,
+}
+
+impl<C> FrameCallback<C> {
+    fn new<F>(kind: ProfileKind, callback: C) -> Self {
+        Self {
+            callback,
+            profile: ProfileHandle::for_type::<F>(kind),
+        }
+    }
+}
+
 /// GameFrame callback registry
 struct GameFrameRegistry {
-    callbacks: SlotMap<GameFrameKey, GameFrameCallback>,
+    callbacks: SlotMap<GameFrameKey, FrameCallback<GameFrameCallback>>,
+}
+
+/// Pre-simulation GameFrame callback registry
+struct PreGameFrameRegistry {
+    callbacks: SlotMap<PreGameFrameKey, FrameCallback<GameFrameCallback>>,
+}
+
+/// PreWorldUpdate callback registry
+struct PreWorldUpdateRegistry {
+    callbacks: SlotMap<PreWorldUpdateKey, FrameCallback<PreWorldUpdateCallback>>,
 }
 
 static REGISTRY: LazyLock<RwLock<GameFrameRegistry>> = LazyLock::new(|| {
@@ -30,6 +79,42 @@ static REGISTRY: LazyLock<RwLock<GameFrameRegistry>> = LazyLock::new(|| {
     })
 });
 
+static PRE_REGISTRY: LazyLock<RwLock<PreGameFrameRegistry>> = LazyLock::new(|| {
+    RwLock::new(PreGameFrameRegistry {
+        callbacks: SlotMap::with_key(),
+    })
+});
+
+static PRE_WORLD_UPDATE_REGISTRY: LazyLock<RwLock<PreWorldUpdateRegistry>> =
+    LazyLock::new(|| {
+        RwLock::new(PreWorldUpdateRegistry {
+            callbacks: SlotMap::with_key(),
+        })
+    });
+
+/// Profile entries for the frame pipeline stages
+struct FrameStages {
+    pre: ProfileHandle,
+    world_update: ProfileHandle,
+    post: ProfileHandle,
+    tasks: ProfileHandle,
+    async_tasks: ProfileHandle,
+    timers: ProfileHandle,
+    events: ProfileHandle,
+    commands: ProfileHandle,
+}
+
+static STAGES: LazyLock<FrameStages> = LazyLock::new(|| FrameStages {
+    pre: ProfileHandle::new(ProfileKind::Core, "GameFrame (pre)"),
+    world_update: ProfileHandle::new(ProfileKind::Core, "PreWorldUpdate"),
+    post: ProfileHandle::new(ProfileKind::Core, "GameFrame"),
+    tasks: ProfileHandle::new(ProfileKind::Core, "process_queued_tasks"),
+    async_tasks: ProfileHandle::new(ProfileKind::Core, "process_async_tasks"),
+    timers: ProfileHandle::new(ProfileKind::Core, "timers::process"),
+    events: ProfileHandle::new(ProfileKind::Core, "events::frame_end"),
+    commands: ProfileHandle::new(ProfileKind::Core, "commands::frame_end"),
+});
+
 /// Frame counter (increments every GameFrame call)
 static FRAME_COUNT: AtomicU64 = AtomicU64::new(0);
 
@@ -38,6 +123,8 @@ static LAST_FRAME_TIME_NS: AtomicU64 = AtomicU64::new(0);
 
 /// Register a callback to be called every GameFrame
 ///
+/// Runs in the post-simulation phase, after queued tasks, async tasks and timers.
+///
 /// # Arguments
 /// * `callback` - Function called with (simulating, first_tick, last_tick)
 ///
@@ -47,7 +134,9 @@ pub fn register_gameframe_callback<F>(callback: F) -> GameFrameKey
 where
     F: Fn(bool, bool, bool) + Send + Sync + 'static,
 {
-    REGISTRY.write().callbacks.insert(Box::new(callback))
+    let entry: FrameCallback<GameFrameCallback> =
+        FrameCallback::new::<F>(ProfileKind::GameFrame, Box::new(callback));
+    REGISTRY.write().callbacks.insert(entry)
 }
 
 /// Unregister a GameFrame callback
@@ -58,6 +147,61 @@ pub fn unregister_gameframe_callback(key: GameFrameKey) -> bool {
     REGISTRY.write().callbacks.remove(key).is_some()
 }
 
+/// Register a callback to be called every GameFrame before simulation
+///
+/// # Arguments
+/// * `callback` - Function called with (simulating, first_tick, last_tick)
+///
+/// # Returns
+/// A key that can be used to unregister the callback
+pub fn register_pre_gameframe_callback<F>(callback: F) -> PreGameFrameKey
+where
+    F: Fn(bool, bool, bool) + Send + Sync + 'static,
+{
+    let entry: FrameCallback<GameFrameCallback> =
+        FrameCallback::new::<F>(ProfileKind::PreGameFrame, Box::new(callback));
+    PRE_REGISTRY.write().callbacks.insert(entry)
+}
+
+/// Unregister a pre-simulation GameFrame callback
+///
+/// # Returns
+/// `true` if the callback was found and removed
+pub fn unregister_pre_gameframe_callback(key: PreGameFrameKey) -> bool {
+    PRE_REGISTRY.write().callbacks.remove(key).is_some()
+}
+
+/// Register a callback to be called every PreWorldUpdate
+///
+/// This is the place to batch entity writes so they land right before the
+/// engine networks entity state, instead of mid-simulation.
+///
+/// # Arguments
+/// * `callback` - Function called with `simulating`
+///
+/// # Returns
+/// A key that can be used to unregister the callback
+pub fn register_pre_world_update_callback<F>(callback: F) -> PreWorldUpdateKey
+where
+    F: Fn(bool) + Send + Sync + 'static,
+{
+    let entry: FrameCallback<PreWorldUpdateCallback> =
+        FrameCallback::new::<F>(ProfileKind::PreWorldUpdate, Box::new(callback));
+    PRE_WORLD_UPDATE_REGISTRY.write().callbacks.insert(entry)
+}
+
+/// Unregister a PreWorldUpdate callback
+///
+/// # Returns
+/// `true` if the callback was found and removed
+pub fn unregister_pre_world_update_callback(key: PreWorldUpdateKey) -> bool {
+    PRE_WORLD_UPDATE_REGISTRY
+        .write()
+        .callbacks
+        .remove(key)
+        .is_some()
+}
+
 /// Get the current frame count
 pub fn frame_count() -> u64 {
     FRAME_COUNT.load(Ordering::Relaxed)
@@ -68,7 +212,35 @@ pub fn last_frame_time_ns() -> u64 {
     LAST_FRAME_TIME_NS.load(Ordering::Relaxed)
 }
 
-/// Called from C++ bridge every server tick
+/// Called from C++ bridge every server tick before simulation (GameFrame pre-hook)
+///
+/// # Arguments
+/// * `simulating` - True if the game is actively simulating (not paused)
+/// * `first_tick` - True if this is the first tick of a frame
+/// * `last_tick` - True if this is the last tick of a frame
+pub fn on_game_frame_pre(simulating: bool, first_tick: bool, last_tick: bool) {
+    let _stage = STAGES.pre.scope();
+    let registry = PRE_REGISTRY.read();
+    for (_, entry) in registry.callbacks.iter() {
+        let _scope = entry.profile.scope();
+        (entry.callback)(simulating, first_tick, last_tick);
+    }
+}
+
+/// Called from C++ bridge every server tick before the world update
+///
+/// # Arguments
+/// * `simulating` - True if the game is actively simulating (not paused)
+pub fn on_pre_world_update(simulating: bool) {
+    let _stage = STAGES.world_update.scope();
+    let registry = PRE_WORLD_UPDATE_REGISTRY.read();
+    for (_, entry) in registry.callbacks.iter() {
+        let _scope = entry.profile.scope();
+        (entry.callback)(simulating);
+    }
+}
+
+/// Called from C++ bridge every server tick after simulation (GameFrame post-hook)
 ///
 /// # Arguments
 /// * `simulating` - True if the game is actively simulating (not paused)
@@ -76,27 +248,56 @@ pub fn last_frame_time_ns() -> u64 {
 /// * `last_tick` - True if this is the last tick of a frame
 pub fn on_game_frame(simulating: bool, first_tick: bool, last_tick: bool) {
     let start = std::time::Instant::now();
+    let stage = STAGES.post.scope();
 
     // Increment frame counter
     FRAME_COUNT.fetch_add(1, Ordering::Relaxed);
 
     // Process queued tasks from other threads
-    let tasks_processed = tasks::process_queued_tasks();
+    let tasks_processed = {
+        let _stage = STAGES.tasks.scope();
+        tasks::process_queued_tasks()
+    };
     if tasks_processed > 0 {
         tracing::trace!("Processed {} queued tasks", tasks_processed);
     }
 
+    // Poll woken async tasks (after queued tasks, which may wake them)
+    {
+        let _stage = STAGES.async_tasks.scope();
+        tasks::process_async_tasks();
+    }
+
     // Process timers
-    timers::process();
+    {
+        let _stage = STAGES.timers.scope();
+        timers::process();
+    }
 
     // Fire registered callbacks
     {
         let registry = REGISTRY.read();
-        for (_, callback) in registry.callbacks.iter() {
-            callback(simulating, first_tick, last_tick);
+        for (_, entry) in registry.callbacks.iter() {
+            let _scope = entry.profile.scope();
+            (entry.callback)(simulating, first_tick, last_tick);
         }
     }
 
+    // Deliver events batched during the frame and refill event pools
+    {
+        let _stage = STAGES.events.scope();
+        crate::events::frame_end();
+    }
+
+    // Send prints queued during the frame
+    {
+        let _stage = STAGES.commands.scope();
+        crate::commands::frame_end();
+    }
+
+    drop(stage);
+    profiler::frame_end();
+
     // Record frame time for monitoring
     let elapsed = start.elapsed().as_nanos() as u64;
     LAST_FRAME_TIME_NS.store(elapsed, Ordering::Relaxed);
@@ -110,3 +311,47 @@ pub fn on_game_frame(simulating: bool, first_tick: bool, last_tick: bool) {
         );
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::AtomicUsize;
+    use std::sync::Arc;
+
+    #[test]
+    fn test_phase_registries_are_separate() {
+        let pre_calls = Arc::new(AtomicUsize::new(0));
+        let world_calls = Arc::new(AtomicUsize::new(0));
+
+        let pre = {
+            let calls = pre_calls.clone();
+            register_pre_gameframe_callback(move |_, _, _| {
+                calls.fetch_add(1, Ordering::Relaxed);
+            })
+        };
+        let world = {
+            let calls = world_calls.clone();
+            register_pre_world_update_callback(move |simulating| {
+                assert!(simulating);
+                calls.fetch_add(1, Ordering::Relaxed);
+            })
+        };
+
+        on_game_frame_pre(true, true, true);
+        assert_eq!(pre_calls.load(Ordering::Relaxed), 1);
+        assert_eq!(world_calls.load(Ordering::Relaxed), 0);
+
+        on_pre_world_update(true);
+        assert_eq!(pre_calls.load(Ordering::Relaxed), 1);
+        assert_eq!(world_calls.load(Ordering::Relaxed), 1);
+
+        assert!(unregister_pre_gameframe_callback(pre));
+        assert!(unregister_pre_world_update_callback(world));
+        assert!(!unregister_pre_world_update_callback(world));
+
+        on_game_frame_pre(true, true, true);
+        on_pre_world_update(true);
+        assert_eq!(pre_calls.load(Ordering::Relaxed), 1);
+        assert_eq!(world_calls.load(Ordering::Relaxed), 1);
+    }
+}
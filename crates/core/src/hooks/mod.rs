@@ -18,8 +18,11 @@ pub mod vtable;
 
 // Re-export GameFrame types
 pub use gameframe::{
-    frame_count, last_frame_time_ns, on_game_frame, register_gameframe_callback,
-    unregister_gameframe_callback, GameFrameKey,
+    frame_count, last_frame_time_ns, on_game_frame, on_game_frame_pre, on_pre_world_update,
+    register_gameframe_callback, register_pre_gameframe_callback,
+    register_pre_world_update_callback, unregister_gameframe_callback,
+    unregister_pre_gameframe_callback, unregister_pre_world_update_callback, GameFrameKey,
+    PreGameFrameKey, PreWorldUpdateKey,
 };
 
 // Re-export hook types
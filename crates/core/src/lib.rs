@@ -26,7 +26,9 @@ pub mod events;
 pub mod gamedata;
 pub mod hooks;
 pub mod listeners;
+pub mod logging;
 pub mod permissions;
+pub mod profiler;
 pub mod schema;
 pub mod tasks;
 pub mod timers;
@@ -37,7 +39,11 @@ pub use commands::{
     CommandKey, CommandResult,
 };
 pub use events::{register_event, unregister_event, EventInfo, GameEventRef, HookResult};
-pub use hooks::{frame_count, register_gameframe_callback, unregister_gameframe_callback};
+pub use hooks::{
+    frame_count, register_gameframe_callback, register_pre_gameframe_callback,
+    register_pre_world_update_callback, unregister_gameframe_callback,
+    unregister_pre_gameframe_callback, unregister_pre_world_update_callback,
+};
 pub use hooks::{
     hook, hook_mid, hook_vtable, hook_vtable_direct, HookError, HookKey, HookManager,
     InlineHookKey, MidHookContext, MidHookKey, VTableHookKey,
@@ -87,6 +93,9 @@ pub use cs2rust_macros::{console_command, SchemaClass};
 /// Called from the FFI layer when Metamod unloads the plugin.
 pub fn shutdown() {
     info!("CS2Rust shutting down...");
+
+    // Drop pending async tasks and join the blocking threads
+    tasks::shutdown_executor();
 }
 
 #[cfg(test)]
@@ -135,6 +135,9 @@ pub fn fire_client_disconnect(slot: i32) {
     for (_, callback) in registry.callbacks.iter() {
         callback(slot);
     }
+
+    // Callbacks could still look the player up, forget the slot after them
+    crate::entities::player::forget_player_slot(slot);
 }
 
 // === OnClientPutInServer ===
@@ -184,4 +184,7 @@ pub unsafe fn fire_entity_deleted(entity_ptr: *mut c_void) {
             callback(EntityRef::from_entity_instance(entity_ptr).unwrap());
         }
     }
+
+    // Drop it from the player slot table before the pointer dangles
+    crate::entities::player::forget_player_controller(entity_ptr);
 }
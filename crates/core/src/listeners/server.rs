@@ -141,6 +141,9 @@ pub fn fire_map_end() {
     // Clean up timers with STOP_ON_MAPCHANGE flag
     crate::timers::remove_mapchange_timers();
 
+    // Controllers are recreated on the next map
+    crate::entities::player::clear_player_slots();
+
     let registry = MAP_END_REGISTRY.read();
     for (_, callback) in registry.callbacks.iter() {
         callback();
@@ -0,0 +1,151 @@
+//! Logging setup and hot-path tracing policy
+//!
+//! The global subscriber is a `fmt` layer behind a reloadable [`EnvFilter`]
+//! whose directives come from [`CoreConfig`]. Changing the filter rebuilds
+//! tracing's per-callsite interest cache, so disabled events on the frame
+//! path cost a single cached check.
+//!
+//! # Policy
+//!
+//! - Per-tick paths (`GameFrame`, task queue, timers, event dispatch) do not
+//!   create spans. Their timing comes from the [`profiler`](crate::profiler).
+//! - Levels above a compile-time ceiling can be removed entirely with the
+//!   `max_level_*` / `release_max_level_*` features of this crate, which
+//!   forward to the matching `tracing` features. The plugin crate has the
+//!   same features, so `cargo build -p cs2rust-plugin --features
+//!   release_max_level_info` works too.
+//! - Everything else is filtered at runtime: `csr_log <directives>` sets a
+//!   filter, `csr_log reload` re-reads `core.toml`.
+
+use std::sync::OnceLock;
+
+use parking_lot::Mutex;
+use tracing_subscriber::layer::SubscriberExt;
+use tracing_subscriber::util::SubscriberInitExt;
+use tracing_subscriber::{fmt, reload, EnvFilter, Registry};
+
+use crate::commands::{register_server_command, CommandInfo, CommandResult};
+use crate::config::{ConfigError, CoreConfig};
+use crate::entities::PlayerController;
+
+/// Logging errors
+#[derive(Debug, thiserror::Error)]
+pub enum LoggingError {
+    /// [`init`] has not installed the subscriber
+    #[error("logging has not been initialized")]
+    NotInitialized,
+
+    /// The filter directives did not parse
+    #[error("invalid log filter '{0}'")]
+    InvalidFilter(String),
+
+    /// The subscriber rejected the new filter
+    #[error("failed to reload log filter: {0}")]
+    Reload(String),
+
+    /// `core.toml` could not be loaded
+    #[error(transparent)]
+    Config(#[from] ConfigError),
+}
+
+/// Handle used to swap the filter at runtime
+static FILTER_HANDLE: OnceLock<reload::Handle<EnvFilter, Registry>> = OnceLock::new();
+
+/// Directives of the active filter
+static CURRENT_FILTER: Mutex<String> = Mutex::new(String::new());
+
+/// Install the global subscriber using the config's filter
+///
+/// Invalid directives fall back to `info`. Does nothing if a global
+/// subscriber is already installed.
+pub fn init(config: &CoreConfig) {
+    let directives = config.log_directives();
+    let (filter, directives) = match EnvFilter::try_new(directives) {
+        Ok(filter) => (filter, directives),
+        Err(_) => (EnvFilter::new("info"), "info"),
+    };
+
+    let (filter_layer, handle) = reload::Layer::new(filter);
+    let installed = tracing_subscriber::registry()
+        .with(filter_layer)
+        .with(fmt::layer())
+        .try_init()
+        .is_ok();
+
+    if installed {
+        let _ = FILTER_HANDLE.set(handle);
+        *CURRENT_FILTER.lock() = directives.to_string();
+        if directives != config.log_directives() {
+            tracing::warn!(
+                "Invalid log filter '{}' in core config, using 'info'",
+                config.log_directives()
+            );
+        }
+    }
+}
+
+/// Switch an installed subscriber to the config's filter
+///
+/// Used when logging was installed with defaults before `core.toml` was
+/// read. Invalid directives keep the current filter.
+pub fn apply_config(config: &CoreConfig) {
+    match set_filter(config.log_directives()) {
+        Ok(()) | Err(LoggingError::NotInitialized) => {}
+        Err(e) => tracing::warn!("{} in core config, keeping '{}'", e, current_filter()),
+    }
+}
+
+/// Replace the active filter
+pub fn set_filter(directives: &str) -> Result<(), LoggingError> {
+    let handle = FILTER_HANDLE.get().ok_or(LoggingError::NotInitialized)?;
+    let filter = EnvFilter::try_new(directives)
+        .map_err(|_| LoggingError::InvalidFilter(directives.to_string()))?;
+
+    handle
+        .reload(filter)
+        .map_err(|e| LoggingError::Reload(e.to_string()))?;
+    *CURRENT_FILTER.lock() = directives.to_string();
+    Ok(())
+}
+
+/// Directives of the active filter (empty before [`init`])
+pub fn current_filter() -> String {
+    CURRENT_FILTER.lock().clone()
+}
+
+/// Re-read `core.toml` and apply its filter
+pub fn reload_from_config() -> Result<String, LoggingError> {
+    let config = CoreConfig::load()?;
+    set_filter(config.log_directives())?;
+    Ok(config.log_directives().to_string())
+}
+
+/// Register the `csr_log` server command
+pub(crate) fn register_commands() {
+    register_server_command(
+        "csr_log",
+        "Show or change the log filter (usage: csr_log [directives|reload])",
+        handle_log,
+    );
+}
+
+fn handle_log(_player: Option<&PlayerController>, info: &CommandInfo) -> CommandResult {
+    let result = match info.arg(1) {
+        "" => {
+            info.reply(&format!("Log filter: {}", current_filter()));
+            return CommandResult::Handled;
+        }
+        "reload" => reload_from_config(),
+        _ => {
+            let directives = info.arg_string();
+            set_filter(&directives).map(|()| directives)
+        }
+    };
+
+    match result {
+        Ok(directives) => info.reply(&format!("Log filter set to: {}", directives)),
+        Err(e) => info.reply(&format!("Failed to set log filter: {}", e)),
+    }
+
+    CommandResult::Handled
+}
@@ -0,0 +1,79 @@
+//! Cheap timestamp source for the profiler
+//!
+//! On x86_64 samples are taken with `rdtsc`, which is several times cheaper
+//! than `Instant::now` (a vDSO call). Histograms store raw ticks; ticks are
+//! converted to nanoseconds only when a report is built, using a ratio
+//! measured against `Instant` since the clock was first used. Other
+//! architectures fall back to `Instant` with one tick per nanosecond.
+
+use std::sync::LazyLock;
+use std::time::Instant;
+
+/// Reference point for tick/nanosecond calibration
+struct Anchor {
+    instant: Instant,
+    ticks: u64,
+}
+
+static ANCHOR: LazyLock<Anchor> = LazyLock::new(|| Anchor {
+    instant: Instant::now(),
+    ticks: raw_ticks(),
+});
+
+#[cfg(target_arch = "x86_64")]
+#[inline(always)]
+fn raw_ticks() -> u64 {
+    // SAFETY: rdtsc is available on every x86_64 CPU
+    unsafe { std::arch::x86_64::_rdtsc() }
+}
+
+#[cfg(not(target_arch = "x86_64"))]
+#[inline(always)]
+fn raw_ticks() -> u64 {
+    static START: LazyLock<Instant> = LazyLock::new(Instant::now);
+    START.elapsed().as_nanos() as u64
+}
+
+/// Initialize the calibration anchor
+///
+/// Called when the first profile entry is created, so the anchor predates
+/// any recorded sample.
+pub fn init() {
+    LazyLock::force(&ANCHOR);
+}
+
+/// Current timestamp in ticks
+#[inline(always)]
+pub fn now() -> u64 {
+    raw_ticks()
+}
+
+/// Nanoseconds per tick, measured since the anchor
+///
+/// Returns 1.0 until enough time has passed for a meaningful measurement.
+pub fn ns_per_tick() -> f64 {
+    if cfg!(not(target_arch = "x86_64")) {
+        return 1.0;
+    }
+
+    let elapsed_ns = ANCHOR.instant.elapsed().as_nanos() as f64;
+    let elapsed_ticks = raw_ticks().wrapping_sub(ANCHOR.ticks) as f64;
+    if elapsed_ns < 1_000_000.0 || elapsed_ticks <= 0.0 {
+        return 1.0;
+    }
+    elapsed_ns / elapsed_ticks
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_ticks_advance() {
+        init();
+        let start = now();
+        std::thread::sleep(std::time::Duration::from_millis(2));
+        let elapsed = now().wrapping_sub(start) as f64 * ns_per_tick();
+        assert!(elapsed >= 1_000_000.0, "elapsed {}ns", elapsed);
+    }
+}
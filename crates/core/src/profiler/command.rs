@@ -0,0 +1,111 @@
+//! `csr_profile` and `csr_trace` server commands
+
+use super::trace::{self, MAX_TRACE_FRAMES};
+use super::{format_ns, is_enabled, reset, set_enabled, snapshot};
+use crate::commands::{register_server_command, CommandInfo, CommandResult};
+use crate::entities::PlayerController;
+
+/// Number of entries shown when no count is given
+const DEFAULT_TOP: usize = 10;
+
+/// Register `csr_profile` and `csr_trace`
+pub(super) fn register() {
+    register_server_command(
+        "csr_profile",
+        "Show the slowest callbacks (usage: csr_profile [count|reset|on|off])",
+        handle_profile,
+    );
+    register_server_command(
+        "csr_trace",
+        "Record frames to a Chrome trace file (usage: csr_trace <frames> [file] | stop)",
+        handle_trace,
+    );
+}
+
+fn handle_profile(_player: Option<&PlayerController>, info: &CommandInfo) -> CommandResult {
+    match info.arg(1) {
+        "reset" => {
+            reset();
+            info.reply("Profiler data cleared.");
+            return CommandResult::Handled;
+        }
+        "on" | "off" => {
+            set_enabled(info.arg(1) == "on");
+            info.reply(&format!("Profiler recording {}.", info.arg(1)));
+            return CommandResult::Handled;
+        }
+        _ => {}
+    }
+
+    let top = info.arg(1).parse().unwrap_or(DEFAULT_TOP);
+    let stats = snapshot();
+
+    if stats.is_empty() {
+        info.reply(if is_enabled() {
+            "No samples recorded in the current window."
+        } else {
+            "Profiler recording is off (csr_profile on)."
+        });
+        return CommandResult::Handled;
+    }
+
+    info.reply(&format!(
+        "{:<12} {:>8} {:>10} {:>10} {:>10} {:>10}  name",
+        "kind", "calls", "total", "p50", "p99", "max"
+    ));
+    for entry in stats.iter().take(top) {
+        info.reply(&format!(
+            "{:<12} {:>8} {:>10} {:>10} {:>10} {:>10}  {}",
+            entry.kind.as_str(),
+            entry.count,
+            format_ns(entry.total_ns),
+            format_ns(entry.p50_ns),
+            format_ns(entry.p99_ns),
+            format_ns(entry.max_ns),
+            entry.name
+        ));
+    }
+
+    if stats.len() > top {
+        info.reply(&format!("... {} more entries", stats.len() - top));
+    }
+
+    CommandResult::Handled
+}
+
+fn handle_trace(_player: Option<&PlayerController>, info: &CommandInfo) -> CommandResult {
+    if info.arg(1) == "stop" {
+        if trace::stop() {
+            info.reply("Trace recording stopped.");
+        } else {
+            info.reply("No trace recording in progress.");
+        }
+        return CommandResult::Handled;
+    }
+
+    let Ok(frames) = info.arg(1).parse::<u64>() else {
+        info.reply(&format!(
+            "Usage: csr_trace <frames 1-{}> [file] | stop",
+            MAX_TRACE_FRAMES
+        ));
+        return CommandResult::Handled;
+    };
+
+    let path = match info.arg(2) {
+        "" => trace::default_trace_path(),
+        name => match crate::config::data_file_path("traces", name) {
+            Some(path) => path,
+            None => {
+                info.reply("The trace file must be a relative path without '..'");
+                return CommandResult::Handled;
+            }
+        },
+    };
+
+    match trace::start(frames, &path) {
+        Ok(()) => info.reply(&format!("Recording {} frames to {}", frames, path.display())),
+        Err(e) => info.reply(&format!("Failed to start trace: {}", e)),
+    }
+
+    CommandResult::Handled
+}
@@ -0,0 +1,55 @@
+//! No-op profiler (`profiler` feature disabled)
+//!
+//! Mirrors the enabled API with zero-sized types so call sites compile
+//! unchanged and optimize away.
+
+use super::{ProfileKind, ProfileStats};
+
+/// Zero-sized stand-in for a profile handle
+#[derive(Clone, Copy, Default)]
+pub struct ProfileHandle;
+
+impl ProfileHandle {
+    /// No-op
+    #[inline(always)]
+    pub fn new(_kind: ProfileKind, _name: &str) -> Self {
+        Self
+    }
+
+    /// No-op
+    #[inline(always)]
+    pub fn for_type<F: ?Sized>(_kind: ProfileKind) -> Self {
+        Self
+    }
+
+    /// No-op
+    #[inline(always)]
+    pub fn scope(&self) -> ProfileScope {
+        ProfileScope
+    }
+}
+
+/// Zero-sized stand-in for a timing guard
+pub struct ProfileScope;
+
+/// No-op
+#[inline(always)]
+pub fn task_profile<F: 'static>() -> ProfileHandle {
+    ProfileHandle
+}
+
+/// No-op
+pub fn set_enabled(_enabled: bool) {}
+
+/// Always false without the `profiler` feature
+pub fn is_enabled() -> bool {
+    false
+}
+
+/// Always empty without the `profiler` feature
+pub fn snapshot() -> Vec<ProfileStats> {
+    Vec::new()
+}
+
+/// No-op
+pub fn reset() {}
@@ -0,0 +1,244 @@
+//! Profiler implementation (`profiler` feature enabled)
+
+use std::any::TypeId;
+use std::cell::RefCell;
+use std::collections::HashMap;
+use std::hash::{BuildHasherDefault, Hasher};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::LazyLock;
+
+use parking_lot::RwLock;
+
+use super::clock;
+use super::histogram::{Histogram, FRAMES_PER_SLICE};
+use super::trace;
+use super::{ProfileKind, ProfileStats};
+
+/// Runtime recording toggle
+static ENABLED: AtomicBool = AtomicBool::new(true);
+
+/// All profile entries, deduplicated by (kind, name)
+///
+/// Entries are never removed, so they are leaked and handed out as
+/// `&'static` references. Their number is bounded by the number of distinct
+/// callback names.
+static ENTRIES: LazyLock<RwLock<HashMap<(ProfileKind, String), &'static ProfileEntry>>> =
+    LazyLock::new(|| RwLock::new(HashMap::new()));
+
+/// Hasher for `TypeId`s, which are already hashes
+///
+/// `TypeId` hashes itself with a single `write_u64`, so a lookup costs one
+/// probe instead of a SipHash round.
+#[derive(Default)]
+struct TypeIdHasher(u64);
+
+impl Hasher for TypeIdHasher {
+    fn finish(&self) -> u64 {
+        self.0
+    }
+
+    fn write(&mut self, bytes: &[u8]) {
+        for &byte in bytes {
+            self.0 = (self.0 << 8) | byte as u64;
+        }
+    }
+
+    fn write_u64(&mut self, hash: u64) {
+        self.0 = hash;
+    }
+}
+
+thread_local! {
+    /// Task profile handles keyed by closure type
+    static TASK_HANDLES: RefCell<HashMap<TypeId, ProfileHandle, BuildHasherDefault<TypeIdHasher>>> =
+        RefCell::new(HashMap::default());
+}
+
+/// Profile data for one named callback
+pub(super) struct ProfileEntry {
+    pub kind: ProfileKind,
+    pub name: String,
+    histogram: Histogram,
+}
+
+/// Current window epoch
+#[inline]
+fn current_epoch() -> u64 {
+    crate::hooks::frame_count() / FRAMES_PER_SLICE
+}
+
+/// Handle to a callback's profile entry
+#[derive(Clone, Copy)]
+pub struct ProfileHandle(&'static ProfileEntry);
+
+impl ProfileHandle {
+    /// Get or create the profile entry for `kind` and `name`
+    pub fn new(kind: ProfileKind, name: &str) -> Self {
+        clock::init();
+
+        if let Some(entry) = ENTRIES.read().get(&(kind, name.to_string())) {
+            return Self(entry);
+        }
+
+        let entry = *ENTRIES
+            .write()
+            .entry((kind, name.to_string()))
+            .or_insert_with(|| {
+                Box::leak(Box::new(ProfileEntry {
+                    kind,
+                    name: name.to_string(),
+                    histogram: Histogram::new(),
+                }))
+            });
+        Self(entry)
+    }
+
+    /// Get or create the profile entry named after the callback type `F`
+    pub fn for_type<F: ?Sized>(kind: ProfileKind) -> Self {
+        Self::new(kind, std::any::type_name::<F>())
+    }
+
+    /// Start timing a call; the sample is recorded when the scope drops
+    #[inline]
+    pub fn scope(&self) -> ProfileScope {
+        let active = if ENABLED.load(Ordering::Relaxed) || trace::is_recording() {
+            Some((self.0, clock::now()))
+        } else {
+            None
+        };
+        ProfileScope { active }
+    }
+}
+
+/// Timing guard returned by [`ProfileHandle::scope`]
+pub struct ProfileScope {
+    active: Option<(&'static ProfileEntry, u64)>,
+}
+
+impl Drop for ProfileScope {
+    #[inline]
+    fn drop(&mut self) {
+        if let Some((entry, start)) = self.active.take() {
+            let elapsed = clock::now().wrapping_sub(start);
+            if ENABLED.load(Ordering::Relaxed) {
+                entry.histogram.record(current_epoch(), elapsed);
+            }
+            if trace::is_recording() {
+                trace::record(entry, start, elapsed);
+            }
+        }
+    }
+}
+
+/// Get the profile handle for a task closure type `F`
+///
+/// [`Task::new`](crate::tasks::Task::new) calls this once and keeps the
+/// handle, so running a task needs no lookup. Handles are cached per thread
+/// by `TypeId`, so the registry (and its lock) is only consulted the first
+/// time a thread creates a given task type. After that, a lookup is one
+/// uncontended probe of a thread-local table. Rust statics are not
+/// instantiated per generic type, so a `static` in `Task::new` can't hold
+/// the handle.
+pub fn task_profile<F: 'static>() -> ProfileHandle {
+    TASK_HANDLES
+        .try_with(|handles| {
+            if let Some(&handle) = handles.borrow().get(&TypeId::of::<F>()) {
+                return handle;
+            }
+            let handle = ProfileHandle::for_type::<F>(ProfileKind::Task);
+            handles.borrow_mut().insert(TypeId::of::<F>(), handle);
+            handle
+        })
+        // Thread-locals are being torn down
+        .unwrap_or_else(|_| ProfileHandle::for_type::<F>(ProfileKind::Task))
+}
+
+/// Enable or disable recording at runtime
+pub fn set_enabled(enabled: bool) {
+    ENABLED.store(enabled, Ordering::Relaxed);
+}
+
+/// Check whether recording is enabled
+pub fn is_enabled() -> bool {
+    ENABLED.load(Ordering::Relaxed)
+}
+
+/// Collect stats for every entry with samples in the current window
+///
+/// Sorted by total time, highest first.
+pub fn snapshot() -> Vec<ProfileStats> {
+    let epoch = current_epoch();
+    let ns_per_tick = clock::ns_per_tick();
+    let to_ns = |ticks: u64| (ticks as f64 * ns_per_tick) as u64;
+    let entries = ENTRIES.read();
+
+    let mut stats: Vec<ProfileStats> = entries
+        .values()
+        .filter_map(|entry| {
+            let summary = entry.histogram.summary(epoch);
+            (summary.count > 0).then(|| ProfileStats {
+                kind: entry.kind,
+                name: entry.name.clone(),
+                count: summary.count,
+                total_ns: to_ns(summary.total),
+                p50_ns: to_ns(summary.p50),
+                p99_ns: to_ns(summary.p99),
+                max_ns: to_ns(summary.max),
+            })
+        })
+        .collect();
+
+    stats.sort_by(|a, b| b.total_ns.cmp(&a.total_ns));
+    stats
+}
+
+/// Clear all recorded samples
+pub fn reset() {
+    for entry in ENTRIES.read().values() {
+        entry.histogram.reset();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::tasks::Task;
+
+    #[test]
+    fn test_handles_are_deduplicated() {
+        let a = ProfileHandle::new(ProfileKind::Command, "csr_profiler_dedup");
+        let b = ProfileHandle::new(ProfileKind::Command, "csr_profiler_dedup");
+        let c = ProfileHandle::new(ProfileKind::Timer, "csr_profiler_dedup");
+
+        assert!(std::ptr::eq(a.0, b.0));
+        assert!(!std::ptr::eq(a.0, c.0));
+    }
+
+    #[test]
+    fn test_scope_records_sample() {
+        let handle = ProfileHandle::new(ProfileKind::Event, "profiler_scope_test");
+        {
+            let _scope = handle.scope();
+            std::thread::sleep(std::time::Duration::from_millis(1));
+        }
+
+        let stats = snapshot()
+            .into_iter()
+            .find(|s| s.name == "profiler_scope_test")
+            .expect("entry should have samples");
+        assert_eq!(stats.kind, ProfileKind::Event);
+        assert_eq!(stats.count, 1);
+        assert!(stats.max_ns >= 1_000_000);
+    }
+
+    #[test]
+    fn test_task_profile_uses_closure_type() {
+        let make = || Task::new(|| {});
+        let (first, second) = (make(), make());
+        let other = Task::new(|| {});
+        assert!(std::ptr::eq(first.profile().0, second.profile().0));
+        assert!(!std::ptr::eq(first.profile().0, other.profile().0));
+        assert_eq!(first.profile().0.name, first.name());
+        assert!(first.name().contains("test_task_profile_uses_closure_type"));
+    }
+}
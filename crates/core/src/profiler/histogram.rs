@@ -0,0 +1,247 @@
+//! Lock-free log-linear latency histogram with a rolling window
+//!
+//! Values are bucketed HDR-style: exact below 8, then 8 sub-buckets per
+//! power of two (~12.5% relative error). Units are whatever the caller
+//! records (the profiler uses clock ticks). The window is split into slices of
+//! [`FRAMES_PER_SLICE`] frames; a slice is reset lazily the first time it is
+//! written in a new epoch, so recording never takes a lock.
+
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+
+/// Sub-buckets per power of two (log2)
+const SUB_BUCKET_BITS: u32 = 3;
+
+/// Sub-buckets per power of two
+const SUB_BUCKETS: usize = 1 << SUB_BUCKET_BITS;
+
+/// Largest recorded value; larger samples are clamped
+const MAX_VALUE: u64 = (1 << 40) - 1;
+
+/// Number of buckets needed to cover `0..=MAX_VALUE`
+pub const BUCKET_COUNT: usize = bucket_index(MAX_VALUE) + 1;
+
+/// Frames covered by one window slice
+pub const FRAMES_PER_SLICE: u64 = 256;
+
+/// Number of slices in the rolling window
+pub const WINDOW_SLICES: usize = 4;
+
+/// Map a value to its bucket index
+pub const fn bucket_index(value: u64) -> usize {
+    if value < SUB_BUCKETS as u64 {
+        return value as usize;
+    }
+
+    let msb = 63 - value.leading_zeros();
+    let shift = msb - SUB_BUCKET_BITS;
+    let sub = (value >> shift) as usize & (SUB_BUCKETS - 1);
+    (shift as usize + 1) * SUB_BUCKETS + sub
+}
+
+/// Smallest value that maps to `index`
+pub const fn bucket_lower_bound(index: usize) -> u64 {
+    if index < SUB_BUCKETS {
+        return index as u64;
+    }
+
+    let shift = index / SUB_BUCKETS - 1;
+    ((SUB_BUCKETS + index % SUB_BUCKETS) as u64) << shift
+}
+
+/// Largest value that maps to `index`
+pub const fn bucket_upper_bound(index: usize) -> u64 {
+    bucket_lower_bound(index + 1) - 1
+}
+
+/// One slice of the rolling window
+struct Slice {
+    /// Window epoch this slice currently holds
+    epoch: AtomicU64,
+    total: AtomicU64,
+    max: AtomicU64,
+    buckets: [AtomicU32; BUCKET_COUNT],
+}
+
+impl Slice {
+    fn new() -> Self {
+        Self {
+            epoch: AtomicU64::new(0),
+            total: AtomicU64::new(0),
+            max: AtomicU64::new(0),
+            buckets: std::array::from_fn(|_| AtomicU32::new(0)),
+        }
+    }
+
+    fn clear(&self) {
+        self.total.store(0, Ordering::Relaxed);
+        self.max.store(0, Ordering::Relaxed);
+        for bucket in &self.buckets {
+            bucket.store(0, Ordering::Relaxed);
+        }
+    }
+}
+
+/// Aggregated view of the window
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct Summary {
+    /// Number of samples
+    pub count: u64,
+    /// Sum of all samples
+    pub total: u64,
+    /// Median (bucket upper bound)
+    pub p50: u64,
+    /// 99th percentile (bucket upper bound)
+    pub p99: u64,
+    /// Largest sample
+    pub max: u64,
+}
+
+/// Rolling-window latency histogram
+pub struct Histogram {
+    slices: [Slice; WINDOW_SLICES],
+}
+
+impl Histogram {
+    /// Create an empty histogram
+    pub fn new() -> Self {
+        Self {
+            slices: std::array::from_fn(|_| Slice::new()),
+        }
+    }
+
+    /// Record a sample for the given window epoch
+    ///
+    /// Samples recorded concurrently with a slice rotation may be lost;
+    /// that is acceptable for profiling data.
+    #[inline]
+    pub fn record(&self, epoch: u64, value: u64) {
+        let slice = &self.slices[(epoch % WINDOW_SLICES as u64) as usize];
+
+        let seen = slice.epoch.load(Ordering::Acquire);
+        if seen != epoch
+            && slice
+                .epoch
+                .compare_exchange(seen, epoch, Ordering::AcqRel, Ordering::Acquire)
+                .is_ok()
+        {
+            slice.clear();
+        }
+
+        let value = value.min(MAX_VALUE);
+        slice.buckets[bucket_index(value)].fetch_add(1, Ordering::Relaxed);
+        slice.total.fetch_add(value, Ordering::Relaxed);
+
+        // Skip the read-modify-write in the common case of a non-maximum sample
+        if value > slice.max.load(Ordering::Relaxed) {
+            slice.max.fetch_max(value, Ordering::Relaxed);
+        }
+    }
+
+    /// Summarize all slices that are still inside the window ending at `epoch`
+    pub fn summary(&self, epoch: u64) -> Summary {
+        let mut buckets = [0u64; BUCKET_COUNT];
+        let mut summary = Summary::default();
+
+        for slice in &self.slices {
+            let slice_epoch = slice.epoch.load(Ordering::Acquire);
+            if slice_epoch > epoch || epoch - slice_epoch >= WINDOW_SLICES as u64 {
+                continue;
+            }
+
+            summary.total += slice.total.load(Ordering::Relaxed);
+            summary.max = summary.max.max(slice.max.load(Ordering::Relaxed));
+            for (sum, bucket) in buckets.iter_mut().zip(&slice.buckets) {
+                *sum += bucket.load(Ordering::Relaxed) as u64;
+            }
+        }
+
+        summary.count = buckets.iter().sum();
+        summary.p50 = percentile(&buckets, summary.count, 0.50).min(summary.max);
+        summary.p99 = percentile(&buckets, summary.count, 0.99).min(summary.max);
+        summary
+    }
+
+    /// Clear every slice
+    pub fn reset(&self) {
+        for slice in &self.slices {
+            slice.clear();
+        }
+    }
+}
+
+impl Default for Histogram {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Upper bound of the bucket containing the `q` quantile
+fn percentile(buckets: &[u64; BUCKET_COUNT], samples: u64, q: f64) -> u64 {
+    if samples == 0 {
+        return 0;
+    }
+
+    let target = ((samples as f64 * q).ceil() as u64).max(1);
+    let mut seen = 0;
+    for (index, &count) in buckets.iter().enumerate() {
+        seen += count;
+        if seen >= target {
+            return bucket_upper_bound(index);
+        }
+    }
+
+    MAX_VALUE
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_bucket_bounds_contain_value() {
+        for value in (0..4096).chain([1 << 20, 123_456_789, MAX_VALUE]) {
+            let index = bucket_index(value);
+            assert!(index < BUCKET_COUNT);
+            assert!(bucket_lower_bound(index) <= value, "value {}", value);
+            assert!(bucket_upper_bound(index) >= value, "value {}", value);
+        }
+    }
+
+    #[test]
+    fn test_bucket_relative_error() {
+        for index in SUB_BUCKETS..BUCKET_COUNT - 1 {
+            let lower = bucket_lower_bound(index);
+            let width = bucket_upper_bound(index) - lower + 1;
+            assert!(width * SUB_BUCKETS as u64 <= lower, "bucket {}", index);
+        }
+    }
+
+    #[test]
+    fn test_percentiles() {
+        let histogram = Histogram::new();
+        for value in 1..=100 {
+            histogram.record(0, value * 1000);
+        }
+
+        let summary = histogram.summary(0);
+        assert_eq!(summary.count, 100);
+        assert_eq!(summary.max, 100_000);
+        assert!((50_000..=56_250).contains(&summary.p50), "{:?}", summary);
+        assert!((99_000..=100_000).contains(&summary.p99), "{:?}", summary);
+    }
+
+    #[test]
+    fn test_window_rolls_over() {
+        let histogram = Histogram::new();
+        histogram.record(0, 5_000_000);
+        histogram.record(1, 10);
+
+        assert_eq!(histogram.summary(1).max, 5_000_000);
+
+        // Epoch 0 falls out of the window, and its slice is reused by epoch 4
+        histogram.record(WINDOW_SLICES as u64, 20);
+        let summary = histogram.summary(WINDOW_SLICES as u64);
+        assert_eq!(summary.count, 2);
+        assert_eq!(summary.max, 20);
+    }
+}
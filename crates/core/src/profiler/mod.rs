@@ -0,0 +1,162 @@
+//! Per-callback frame profiler
+//!
+//! Every GameFrame callback, timer, queued task, event handler and command
+//! carries a [`ProfileHandle`] naming it and pointing at a lock-free latency
+//! histogram. Each invocation records its wall time into a rolling window of
+//! roughly the last thousand frames, from which p50/p99/max are reported.
+//!
+//! Handles are deduplicated by kind and name, so a closure type registered
+//! several times reports as one entry.
+//!
+//! # Usage
+//!
+//! ```text
+//! csr_profile            - top 10 entries by total time in the window
+//! csr_profile 25         - top 25 entries
+//! csr_profile reset      - clear all histograms
+//! csr_profile on|off     - toggle recording at runtime
+//! ```
+//!
+//! # Frame traces
+//!
+//! The same scopes feed [`trace`], which records whole frame timelines to a
+//! Chrome trace file for `chrome://tracing` or Perfetto:
+//!
+//! ```text
+//! csr_trace 300           - record the next 300 frames
+//! csr_trace 300 <file>    - record to <cs2rust>/traces/<file>
+//! csr_trace stop          - stop early
+//! ```
+//!
+//! # Feature flag
+//!
+//! Profiling is controlled by the `profiler` Cargo feature (on by default).
+//! Without it, handles and scopes are zero-sized no-ops and `csr_profile`
+//! is not registered.
+
+#[cfg(feature = "profiler")]
+mod clock;
+#[cfg(feature = "profiler")]
+mod command;
+#[cfg(feature = "profiler")]
+mod enabled;
+#[cfg(feature = "profiler")]
+mod histogram;
+#[cfg(feature = "profiler")]
+pub mod trace;
+
+#[cfg(not(feature = "profiler"))]
+mod disabled;
+
+use std::fmt;
+
+#[cfg(feature = "profiler")]
+pub use enabled::{
+    is_enabled, reset, set_enabled, snapshot, task_profile, ProfileHandle, ProfileScope,
+};
+
+#[cfg(not(feature = "profiler"))]
+pub use disabled::{
+    is_enabled, reset, set_enabled, snapshot, task_profile, ProfileHandle, ProfileScope,
+};
+
+/// What kind of callback a profile entry measures
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub enum ProfileKind {
+    /// Pre-simulation GameFrame callback
+    PreGameFrame,
+    /// Post-simulation GameFrame callback
+    GameFrame,
+    /// PreWorldUpdate callback
+    PreWorldUpdate,
+    /// Timer callback
+    Timer,
+    /// Queued main thread task
+    Task,
+    /// Game event handler
+    Event,
+    /// Console or chat command
+    Command,
+    /// Framework pipeline stage (task drain, timers, FireEvent, dispatch)
+    Core,
+}
+
+impl ProfileKind {
+    /// Short label used in reports
+    pub fn as_str(&self) -> &'static str {
+        match self {
+            Self::PreGameFrame => "frame_pre",
+            Self::GameFrame => "frame",
+            Self::PreWorldUpdate => "world_update",
+            Self::Timer => "timer",
+            Self::Task => "task",
+            Self::Event => "event",
+            Self::Command => "command",
+            Self::Core => "core",
+        }
+    }
+}
+
+impl fmt::Display for ProfileKind {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(self.as_str())
+    }
+}
+
+/// Rolling-window statistics for one profile entry
+#[derive(Debug, Clone)]
+pub struct ProfileStats {
+    /// Callback kind
+    pub kind: ProfileKind,
+    /// Callback name
+    pub name: String,
+    /// Calls in the window
+    pub count: u64,
+    /// Total time spent in the window
+    pub total_ns: u64,
+    /// Median call time
+    pub p50_ns: u64,
+    /// 99th percentile call time
+    pub p99_ns: u64,
+    /// Slowest call in the window
+    pub max_ns: u64,
+}
+
+/// Register the `csr_profile` and `csr_trace` server commands
+///
+/// Called from [`crate::commands::init`]. Does nothing when the `profiler`
+/// feature is disabled.
+pub(crate) fn register_commands() {
+    #[cfg(feature = "profiler")]
+    command::register();
+}
+
+/// Mark the end of a GameFrame (counts down trace recordings)
+#[inline]
+pub(crate) fn frame_end() {
+    #[cfg(feature = "profiler")]
+    trace::frame_end();
+}
+
+/// Format a duration in nanoseconds for reports
+pub fn format_ns(ns: u64) -> String {
+    if ns >= 1_000_000 {
+        format!("{:.2}ms", ns as f64 / 1_000_000.0)
+    } else if ns >= 1_000 {
+        format!("{:.1}us", ns as f64 / 1_000.0)
+    } else {
+        format!("{}ns", ns)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_format_ns() {
+        assert_eq!(format_ns(850), "850ns");
+        assert_eq!(format_ns(12_340), "12.3us");
+        assert_eq!(format_ns(2_500_000), "2.50ms");
+    }
+}
@@ -0,0 +1,390 @@
+//! Chrome trace / Perfetto export of frame timelines
+//!
+//! While a recording is active, every profiled scope pushes a complete
+//! event into a bounded lock-free ring. A background writer thread drains
+//! the ring into a JSON file in the Trace Event Format, which loads in
+//! `chrome://tracing` and <https://ui.perfetto.dev>. The game thread never
+//! touches the file, and memory is bounded by [`RING_CAPACITY`]: if the
+//! writer falls behind, events are dropped and counted instead of queued.
+//!
+//! Recordings stop by themselves after the requested number of frames.
+
+use std::cell::Cell;
+use std::fs::File;
+use std::io::{self, BufWriter, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+use std::sync::LazyLock;
+use std::thread::{self, JoinHandle};
+use std::time::Duration;
+
+use crossbeam_channel::{bounded, Receiver, RecvTimeoutError, Sender};
+use parking_lot::Mutex;
+
+use super::clock;
+use super::enabled::ProfileEntry;
+
+/// Maximum events buffered between the game thread and the writer
+pub const RING_CAPACITY: usize = 1 << 16;
+
+/// Maximum number of frames in one recording
+pub const MAX_TRACE_FRAMES: u64 = 100_000;
+
+/// How often the writer checks whether the recording has stopped
+const WRITER_POLL: Duration = Duration::from_millis(50);
+
+/// One completed scope
+struct TraceEvent {
+    entry: &'static ProfileEntry,
+    thread: u32,
+    start: u64,
+    duration: u64,
+}
+
+/// Ring between recording threads and the writer
+struct TraceRing {
+    sender: Sender<TraceEvent>,
+    receiver: Receiver<TraceEvent>,
+}
+
+static RING: LazyLock<TraceRing> = LazyLock::new(|| {
+    let (sender, receiver) = bounded(RING_CAPACITY);
+    TraceRing { sender, receiver }
+});
+
+/// Whether scopes should be pushed to the ring
+static RECORDING: AtomicBool = AtomicBool::new(false);
+
+/// Frames left in the current recording
+static FRAMES_LEFT: AtomicU64 = AtomicU64::new(0);
+
+/// Events dropped because the ring was full
+static DROPPED: AtomicU64 = AtomicU64::new(0);
+
+/// Writer thread of the current (or last) recording
+static WRITER: Mutex<Option<JoinHandle<()>>> = Mutex::new(None);
+
+/// Names of threads that have recorded events, by trace thread id
+static THREAD_NAMES: Mutex<Vec<(u32, String)>> = Mutex::new(Vec::new());
+
+static NEXT_THREAD_ID: AtomicU32 = AtomicU32::new(1);
+
+thread_local! {
+    /// Small trace thread id (0 = not assigned yet)
+    static THREAD_ID: Cell<u32> = const { Cell::new(0) };
+}
+
+/// Errors starting a recording
+#[derive(Debug, thiserror::Error)]
+pub enum TraceError {
+    /// A recording is already running or still being written
+    #[error("a trace recording is already in progress")]
+    Busy,
+
+    /// Frame count outside `1..=MAX_TRACE_FRAMES`
+    #[error("frame count must be between 1 and {MAX_TRACE_FRAMES}")]
+    InvalidFrameCount,
+
+    /// The output file could not be created
+    #[error("failed to create trace file: {0}")]
+    Io(#[from] io::Error),
+}
+
+/// Check whether a recording is active
+#[inline]
+pub fn is_recording() -> bool {
+    RECORDING.load(Ordering::Relaxed)
+}
+
+/// Small id for the current thread, assigned on first use
+fn thread_id() -> u32 {
+    THREAD_ID.with(|id| {
+        if id.get() == 0 {
+            let new_id = NEXT_THREAD_ID.fetch_add(1, Ordering::Relaxed);
+            let name = thread::current()
+                .name()
+                .map(str::to_string)
+                .unwrap_or_else(|| format!("thread {}", new_id));
+            THREAD_NAMES.lock().push((new_id, name));
+            id.set(new_id);
+        }
+        id.get()
+    })
+}
+
+/// Push a completed scope to the ring (never blocks)
+pub(super) fn record(entry: &'static ProfileEntry, start: u64, duration: u64) {
+    let event = TraceEvent {
+        entry,
+        thread: thread_id(),
+        start,
+        duration,
+    };
+    if RING.sender.try_send(event).is_err() {
+        DROPPED.fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+/// Start recording `frames` frames to `path`
+///
+/// The file is created up front so path errors are reported immediately.
+pub fn start(frames: u64, path: &Path) -> Result<(), TraceError> {
+    if !(1..=MAX_TRACE_FRAMES).contains(&frames) {
+        return Err(TraceError::InvalidFrameCount);
+    }
+
+    let mut writer = WRITER.lock();
+    if is_recording() || writer.as_ref().is_some_and(|w| !w.is_finished()) {
+        return Err(TraceError::Busy);
+    }
+
+    if let Some(parent) = path.parent() {
+        std::fs::create_dir_all(parent)?;
+    }
+    let file = File::create(path)?;
+
+    // Discard events left over from scopes that straddled the last stop
+    while RING.receiver.try_recv().is_ok() {}
+    DROPPED.store(0, Ordering::Relaxed);
+
+    let origin = clock::now();
+    let path = path.to_path_buf();
+    *writer = Some(
+        thread::Builder::new()
+            .name("cs2rust-trace".to_string())
+            .spawn(move || run_writer(file, path, origin))?,
+    );
+
+    FRAMES_LEFT.store(frames, Ordering::Relaxed);
+    RECORDING.store(true, Ordering::Release);
+    tracing::info!("Trace recording started ({} frames)", frames);
+    Ok(())
+}
+
+/// Stop the current recording early
+///
+/// Returns false if nothing was recording.
+pub fn stop() -> bool {
+    FRAMES_LEFT.store(0, Ordering::Relaxed);
+    RECORDING.swap(false, Ordering::AcqRel)
+}
+
+/// Count down the current recording (called at the end of every GameFrame)
+pub(crate) fn frame_end() {
+    if is_recording() && FRAMES_LEFT.fetch_sub(1, Ordering::Relaxed) <= 1 {
+        stop();
+    }
+}
+
+/// Default output path: `<cs2rust>/traces/frame_trace_<unix time>.json`
+pub fn default_trace_path() -> PathBuf {
+    let secs = std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|d| d.as_secs())
+        .unwrap_or(0);
+    let dir = crate::config::cs2rust_base_dir()
+        .map(|base| base.join("traces"))
+        .unwrap_or_else(|_| PathBuf::from("."));
+    dir.join(format!("frame_trace_{}.json", secs))
+}
+
+/// Writer thread body
+fn run_writer(file: File, path: PathBuf, origin: u64) {
+    match write_trace(BufWriter::new(file), origin) {
+        Ok(count) => tracing::info!(
+            "Trace written to {:?} ({} events, {} dropped)",
+            path,
+            count,
+            DROPPED.load(Ordering::Relaxed)
+        ),
+        Err(e) => {
+            RECORDING.store(false, Ordering::Release);
+            tracing::error!("Failed to write trace to {:?}: {}", path, e);
+        }
+    }
+}
+
+/// Drain the ring into `out` until the recording stops
+///
+/// Returns the number of events written.
+fn write_trace<W: Write>(mut out: W, origin: u64) -> io::Result<usize> {
+    let mut count = 0;
+    out.write_all(b"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n")?;
+
+    loop {
+        match RING.receiver.recv_timeout(WRITER_POLL) {
+            Ok(event) => {
+                if write_event(&mut out, &event, origin, count == 0)? {
+                    count += 1;
+                }
+            }
+            Err(RecvTimeoutError::Timeout) if !is_recording() => break,
+            Err(RecvTimeoutError::Timeout) => {}
+            Err(RecvTimeoutError::Disconnected) => break,
+        }
+    }
+
+    // Events that were already queued when the recording stopped
+    while let Ok(event) = RING.receiver.try_recv() {
+        if write_event(&mut out, &event, origin, count == 0)? {
+            count += 1;
+        }
+    }
+
+    for (id, name) in THREAD_NAMES.lock().iter() {
+        if count > 0 {
+            out.write_all(b",\n")?;
+        }
+        write!(
+            out,
+            "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":{}}}}}",
+            id,
+            json_string(name)
+        )?;
+        count += 1;
+    }
+
+    out.write_all(b"\n]}\n")?;
+    out.flush()?;
+    Ok(count)
+}
+
+/// Clip an event to the recording: `(ticks since origin, duration)`
+///
+/// Scopes already open when the recording started (such as the
+/// `csr_trace` command that started it) are cut to start at the origin.
+/// Returns `None` for events that ended before it.
+fn clip_to_origin(start: u64, duration: u64, origin: u64) -> Option<(u64, u64)> {
+    let end = start.saturating_add(duration);
+    if end < origin {
+        return None;
+    }
+    let start = start.max(origin);
+    Some((start - origin, end - start))
+}
+
+/// Write one complete ("X") event
+///
+/// Returns false if the event was skipped (it ended before the recording).
+fn write_event<W: Write>(
+    out: &mut W,
+    event: &TraceEvent,
+    origin: u64,
+    first: bool,
+) -> io::Result<bool> {
+    let Some((ts, duration)) = clip_to_origin(event.start, event.duration, origin) else {
+        return Ok(false);
+    };
+    let ns_per_tick = clock::ns_per_tick();
+    let ts_us = ts as f64 * ns_per_tick / 1000.0;
+    let dur_us = duration as f64 * ns_per_tick / 1000.0;
+
+    if !first {
+        out.write_all(b",\n")?;
+    }
+    write!(
+        out,
+        "{{\"name\":{},\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3},\"dur\":{:.3},\"pid\":1,\"tid\":{}}}",
+        json_string(&event.entry.name),
+        event.entry.kind.as_str(),
+        ts_us,
+        dur_us,
+        event.thread
+    )?;
+    Ok(true)
+}
+
+/// Quote and escape a string for JSON
+fn json_string(s: &str) -> String {
+    serde_json::to_string(s).unwrap_or_else(|_| "\"?\"".to_string())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::profiler::{ProfileHandle, ProfileKind};
+
+    /// Recordings are global; tests that start one take turns
+    static RECORDING_TEST: Mutex<()> = Mutex::new(());
+
+    /// Stop after `frames` frames and parse the written file
+    fn finish_recording(frames: u64, path: &Path) -> Vec<serde_json::Value> {
+        for _ in 0..frames {
+            frame_end();
+        }
+        assert!(!is_recording());
+        WRITER.lock().take().unwrap().join().unwrap();
+
+        let content = std::fs::read_to_string(path).unwrap();
+        std::fs::remove_file(path).ok();
+        let json: serde_json::Value = serde_json::from_str(&content).unwrap();
+        json["traceEvents"].as_array().unwrap().clone()
+    }
+
+    #[test]
+    fn test_trace_file_is_valid_json() {
+        let _guard = RECORDING_TEST.lock();
+        let path = std::env::temp_dir().join(format!("cs2rust_trace_{}.json", std::process::id()));
+        let handle = ProfileHandle::new(ProfileKind::Core, "trace \"test\" scope");
+
+        start(2, &path).unwrap();
+        assert!(matches!(start(2, &path), Err(TraceError::Busy)));
+        {
+            let _scope = handle.scope();
+        }
+        frame_end();
+        assert!(is_recording());
+
+        let events = finish_recording(1, &path);
+        assert!(events
+            .iter()
+            .any(|e| e["name"] == "trace \"test\" scope" && e["ph"] == "X" && e["cat"] == "core"));
+    }
+
+    #[test]
+    fn test_scope_open_before_start() {
+        let _guard = RECORDING_TEST.lock();
+        let path =
+            std::env::temp_dir().join(format!("cs2rust_trace_open_{}.json", std::process::id()));
+        let handle = ProfileHandle::new(ProfileKind::Core, "trace straddling scope");
+
+        crate::profiler::set_enabled(true);
+        let opened = std::time::Instant::now();
+        let scope = handle.scope();
+        std::thread::sleep(Duration::from_millis(2));
+        start(1, &path).unwrap();
+        std::thread::sleep(Duration::from_millis(1));
+        drop(scope);
+        let total_us = opened.elapsed().as_secs_f64() * 1e6;
+
+        let events = finish_recording(1, &path);
+        let event = events
+            .iter()
+            .find(|e| e["name"] == "trace straddling scope")
+            .unwrap();
+        // Starts at the origin and only covers the recorded part
+        assert_eq!(event["ts"].as_f64(), Some(0.0));
+        let dur_us = event["dur"].as_f64().unwrap();
+        assert!(
+            dur_us >= 900.0 && dur_us < total_us - 1000.0,
+            "dur {dur_us} of {total_us}"
+        );
+
+        // Ended before the recording: skipped
+        assert_eq!(clip_to_origin(10, 20, 1_000), None);
+        assert_eq!(clip_to_origin(990, 20, 1_000), Some((0, 10)));
+    }
+
+    #[test]
+    fn test_invalid_frame_count() {
+        let path = std::env::temp_dir().join("cs2rust_trace_invalid.json");
+        assert!(matches!(
+            start(0, &path),
+            Err(TraceError::InvalidFrameCount)
+        ));
+        assert!(matches!(
+            start(MAX_TRACE_FRAMES + 1, &path),
+            Err(TraceError::InvalidFrameCount)
+        ));
+    }
+}
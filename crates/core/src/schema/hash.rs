@@ -32,6 +32,41 @@ pub const fn fnv1a_64(data: &[u8]) -> u64 {
     hash
 }
 
+/// FNV-1a 32-bit hash of ASCII-lowercased bytes
+///
+/// Matches [`fnv1a_32`] of the lowercased input, so names can be looked up
+/// case-insensitively without lowercasing them into a new string.
+pub const fn fnv1a_32_lowercase(data: &[u8]) -> u32 {
+    const FNV_OFFSET_BASIS: u32 = 0x811c9dc5;
+    const FNV_PRIME: u32 = 0x01000193;
+
+    let mut hash = FNV_OFFSET_BASIS;
+    let mut i = 0;
+    while i < data.len() {
+        hash ^= data[i].to_ascii_lowercase() as u32;
+        hash = hash.wrapping_mul(FNV_PRIME);
+        i += 1;
+    }
+    hash
+}
+
+/// FNV-1a 64-bit hash of ASCII-lowercased bytes
+///
+/// Matches [`fnv1a_64`] of the lowercased input.
+pub const fn fnv1a_64_lowercase(data: &[u8]) -> u64 {
+    const FNV_OFFSET_BASIS: u64 = 0xcbf29ce484222325;
+    const FNV_PRIME: u64 = 0x00000100000001B3;
+
+    let mut hash = FNV_OFFSET_BASIS;
+    let mut i = 0;
+    while i < data.len() {
+        hash ^= data[i].to_ascii_lowercase() as u64;
+        hash = hash.wrapping_mul(FNV_PRIME);
+        i += 1;
+    }
+    hash
+}
+
 /// Combined class+field hash for cache key
 ///
 /// Uses 32-bit hashes for class and field, combined into a 64-bit key.
@@ -66,6 +101,13 @@ mod tests {
         assert_eq!(fnv1a_32(b"foobar"), 0xbf9cf968);
     }
 
+    #[test]
+    fn test_fnv1a_32_lowercase() {
+        assert_eq!(fnv1a_32_lowercase(b"FooBar"), fnv1a_32(b"foobar"));
+        assert_eq!(fnv1a_32_lowercase(b"csr_PING"), fnv1a_32(b"csr_ping"));
+        assert_eq!(fnv1a_64_lowercase(b"csr_PING"), fnv1a_64(b"csr_ping"));
+    }
+
     #[test]
     fn test_combined_hash_unique() {
         // Different class/field combinations should produce different hashes
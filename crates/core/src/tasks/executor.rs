@@ -0,0 +1,471 @@
+//! Frame-driven executor for async tasks
+//!
+//! Futures spawned with [`spawn`] are polled on the main thread from the
+//! GameFrame hook, right after queued tasks. A task is only polled again
+//! once it's been woken, so a task waiting on background work costs
+//! nothing per frame. Wakers may be used from any thread.
+//!
+//! Two helpers cover the common waits:
+//!
+//! - [`next_frame`] yields until the next frame (spread a scan over ticks)
+//! - [`run_blocking`] runs a closure on a small pool of background
+//!   threads and resolves with its result (file reads, database queries)
+//!
+//! A task that panics while polled is dropped, and a [`run_blocking`]
+//! closure that panics resolves its future with a [`BlockingPanic`], so
+//! neither unwinds into the GameFrame hook or leaves a task waiting forever.
+//!
+//! [`shutdown_executor`] drops every pending task and joins the pool's
+//! threads; it runs when the plugin unloads.
+//!
+//! ```ignore
+//! use cs2rust_core::tasks::{next_frame, run_blocking, spawn};
+//!
+//! spawn(async {
+//!     let bans = run_blocking(|| std::fs::read_to_string("bans.txt")).await;
+//!     // Err if the closure panicked
+//!     next_frame().await;
+//!     // back on the main thread, a frame later
+//! });
+//! ```
+
+use std::any::Any;
+use std::future::Future;
+use std::mem;
+use std::panic::{self, AssertUnwindSafe};
+use std::pin::Pin;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, LazyLock};
+use std::task::{Context, Poll, Wake, Waker};
+use std::thread::JoinHandle;
+
+use crossbeam_channel::{unbounded, Sender};
+use parking_lot::Mutex;
+use slotmap::{new_key_type, SlotMap};
+
+new_key_type! {
+    /// Key for a spawned async task
+    pub struct AsyncTaskKey;
+}
+
+type BoxFuture = Pin<Box<dyn Future<Output = ()> + Send>>;
+
+/// Wakes one task by queueing its key for the next poll
+struct TaskWaker {
+    key: AsyncTaskKey,
+    /// Already in the woken list (avoids duplicates)
+    queued: AtomicBool,
+}
+
+impl Wake for TaskWaker {
+    fn wake(self: Arc<Self>) {
+        self.wake_by_ref();
+    }
+
+    fn wake_by_ref(self: &Arc<Self>) {
+        if !self.queued.swap(true, Ordering::AcqRel) {
+            EXECUTOR.woken.lock().push(self.key);
+        }
+    }
+}
+
+struct AsyncTask {
+    /// `None` while the task is being polled
+    future: Option<BoxFuture>,
+    waker: Arc<TaskWaker>,
+}
+
+struct Executor {
+    tasks: Mutex<SlotMap<AsyncTaskKey, AsyncTask>>,
+    /// Tasks to poll next frame
+    woken: Mutex<Vec<AsyncTaskKey>>,
+    /// Spare list swapped with `woken` each frame
+    polling: Mutex<Vec<AsyncTaskKey>>,
+}
+
+static EXECUTOR: LazyLock<Executor> = LazyLock::new(|| Executor {
+    tasks: Mutex::new(SlotMap::with_key()),
+    woken: Mutex::new(Vec::new()),
+    polling: Mutex::new(Vec::new()),
+});
+
+/// Spawn a future on the main thread
+///
+/// It's first polled on the next frame. Safe to call from any thread.
+pub fn spawn<F>(future: F) -> AsyncTaskKey
+where
+    F: Future<Output = ()> + Send + 'static,
+{
+    let key = EXECUTOR.tasks.lock().insert_with_key(|key| AsyncTask {
+        future: Some(Box::pin(future)),
+        waker: Arc::new(TaskWaker {
+            key,
+            queued: AtomicBool::new(false),
+        }),
+    });
+    let waker = EXECUTOR.tasks.lock()[key].waker.clone();
+    waker.wake_by_ref();
+    key
+}
+
+/// Drop a spawned task without polling it again
+///
+/// Returns false if the task already finished.
+pub fn cancel_async_task(key: AsyncTaskKey) -> bool {
+    EXECUTOR.tasks.lock().remove(key).is_some()
+}
+
+/// Drop every spawned task without polling it again
+///
+/// Returns the number of tasks dropped.
+pub fn cancel_all_async_tasks() -> usize {
+    let cancelled: Vec<AsyncTask> = EXECUTOR
+        .tasks
+        .lock()
+        .drain()
+        .map(|(_, task)| task)
+        .collect();
+    EXECUTOR.woken.lock().clear();
+    // Dropped outside the lock: a future's drop may cancel or spawn tasks
+    cancelled.len()
+}
+
+/// Poll every woken task once
+///
+/// Called from GameFrame hook on the main thread.
+/// Returns the number of tasks polled.
+pub fn process_async_tasks() -> usize {
+    let mut polling = mem::take(&mut *EXECUTOR.polling.lock());
+    mem::swap(&mut polling, &mut *EXECUTOR.woken.lock());
+
+    let mut count = 0;
+    for key in polling.drain(..) {
+        // Take the future out so it can spawn or wake tasks while polled
+        let (mut future, waker) = {
+            let mut tasks = EXECUTOR.tasks.lock();
+            let Some(task) = tasks.get_mut(key) else {
+                continue;
+            };
+            let Some(future) = task.future.take() else {
+                continue;
+            };
+            (future, task.waker.clone())
+        };
+        waker.queued.store(false, Ordering::Release);
+
+        let waker = Waker::from(waker);
+        let mut cx = Context::from_waker(&waker);
+        // A panicking task is finished; it must not unwind into GameFrame
+        let ready = match panic::catch_unwind(AssertUnwindSafe(|| future.as_mut().poll(&mut cx))) {
+            Ok(poll) => poll.is_ready(),
+            Err(payload) => {
+                tracing::error!("Async task panicked: {}", panic_message(&*payload));
+                true
+            }
+        };
+        count += 1;
+
+        let mut tasks = EXECUTOR.tasks.lock();
+        if ready {
+            tasks.remove(key);
+        } else if let Some(task) = tasks.get_mut(key) {
+            task.future = Some(future);
+        }
+    }
+
+    *EXECUTOR.polling.lock() = polling;
+    count
+}
+
+/// Text of a panic payload (`panic!` messages are `&str` or `String`)
+fn panic_message(payload: &(dyn Any + Send)) -> &str {
+    payload
+        .downcast_ref::<&str>()
+        .copied()
+        .or_else(|| payload.downcast_ref::<String>().map(String::as_str))
+        .unwrap_or("<non-string panic payload>")
+}
+
+/// Number of spawned tasks that haven't finished
+pub fn async_task_count() -> usize {
+    EXECUTOR.tasks.lock().len()
+}
+
+/// Future returned by [`next_frame`]
+#[derive(Debug, Default)]
+pub struct NextFrame {
+    yielded: bool,
+}
+
+impl Future for NextFrame {
+    type Output = ();
+
+    fn poll(mut self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<()> {
+        if self.yielded {
+            return Poll::Ready(());
+        }
+        self.yielded = true;
+        cx.waker().wake_by_ref();
+        Poll::Pending
+    }
+}
+
+/// Yield until the next frame
+pub fn next_frame() -> NextFrame {
+    NextFrame::default()
+}
+
+/// Threads running [`run_blocking`] closures
+///
+/// Closures beyond this many wait their turn, so a burst of calls can't
+/// start an unbounded number of threads.
+pub const BLOCKING_THREADS: usize = 4;
+
+type BlockingJob = Box<dyn FnOnce() + Send>;
+
+struct BlockingPool {
+    sender: Sender<BlockingJob>,
+    threads: Vec<JoinHandle<()>>,
+}
+
+impl BlockingPool {
+    fn start() -> Self {
+        let (sender, receiver) = unbounded::<BlockingJob>();
+        let threads = (0..BLOCKING_THREADS)
+            .filter_map(|i| {
+                let receiver = receiver.clone();
+                std::thread::Builder::new()
+                    .name(format!("cs2rust-blocking-{i}"))
+                    .spawn(move || {
+                        // Jobs catch their closure's panics themselves
+                        for job in receiver {
+                            job();
+                        }
+                    })
+                    .map_err(|e| tracing::error!("Failed to start blocking thread: {}", e))
+                    .ok()
+            })
+            .collect();
+        Self { sender, threads }
+    }
+}
+
+/// Started by the first [`run_blocking`] call
+static BLOCKING_POOL: Mutex<Option<BlockingPool>> = Mutex::new(None);
+
+/// A [`run_blocking`] closure panicked instead of returning
+#[derive(Debug, Clone, thiserror::Error)]
+#[error("run_blocking closure panicked: {message}")]
+pub struct BlockingPanic {
+    message: String,
+}
+
+impl BlockingPanic {
+    /// The panic message
+    pub fn message(&self) -> &str {
+        &self.message
+    }
+}
+
+/// Result slot shared with a [`run_blocking`] closure
+struct BlockingState<T> {
+    result: Option<Result<T, BlockingPanic>>,
+    waker: Option<Waker>,
+}
+
+/// Future returned by [`run_blocking`]
+pub struct Blocking<T> {
+    state: Arc<Mutex<BlockingState<T>>>,
+}
+
+impl<T> Future for Blocking<T> {
+    type Output = Result<T, BlockingPanic>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut state = self.state.lock();
+        match state.result.take() {
+            Some(result) => Poll::Ready(result),
+            None => {
+                state.waker = Some(cx.waker().clone());
+                Poll::Pending
+            }
+        }
+    }
+}
+
+/// Run a closure on a background thread and await its result
+///
+/// The closure must not touch game state; do that after the `.await`,
+/// back on the main thread. At most [`BLOCKING_THREADS`] closures run at
+/// once; a closure whose future is dropped before it starts is skipped.
+/// A closure that panics resolves its future with a [`BlockingPanic`].
+pub fn run_blocking<T, F>(f: F) -> Blocking<T>
+where
+    T: Send + 'static,
+    F: FnOnce() -> T + Send + 'static,
+{
+    let state = Arc::new(Mutex::new(BlockingState {
+        result: None,
+        waker: None,
+    }));
+
+    let shared = state.clone();
+    let job: BlockingJob = Box::new(move || {
+        // Nobody is waiting for it any more
+        if Arc::strong_count(&shared) == 1 {
+            return;
+        }
+        let result = panic::catch_unwind(AssertUnwindSafe(f)).map_err(|payload| BlockingPanic {
+            message: panic_message(&*payload).to_string(),
+        });
+        let waker = {
+            let mut state = shared.lock();
+            state.result = Some(result);
+            state.waker.take()
+        };
+        if let Some(waker) = waker {
+            waker.wake();
+        }
+    });
+
+    let mut pool = BLOCKING_POOL.lock();
+    let pool = pool.get_or_insert_with(BlockingPool::start);
+    if pool.threads.is_empty() || pool.sender.send(job).is_err() {
+        tracing::error!("No blocking threads, run_blocking future will never resolve");
+    }
+
+    Blocking { state }
+}
+
+/// Drop every pending async task and join the [`run_blocking`] threads
+///
+/// Closures already running are waited for. Called on plugin unload; a
+/// later [`run_blocking`] starts a new pool.
+pub fn shutdown_executor() {
+    let cancelled = cancel_all_async_tasks();
+    if cancelled > 0 {
+        tracing::debug!("Dropped {} pending async tasks", cancelled);
+    }
+
+    let Some(pool) = BLOCKING_POOL.lock().take() else {
+        return;
+    };
+    // Workers exit once the queue is empty and the sender is gone
+    drop(pool.sender);
+    for thread in pool.threads {
+        let _ = thread.join();
+    }
+}
+
+/// Held by tests that drive the shared executor; shutdown would drop the
+/// other tests' tasks
+#[cfg(test)]
+pub(crate) static EXECUTOR_TEST: Mutex<()> = Mutex::new(());
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::AtomicUsize;
+
+    #[test]
+    fn test_frame_executor() {
+        let _serial = EXECUTOR_TEST.lock();
+        let steps = Arc::new(AtomicUsize::new(0));
+
+        let s = steps.clone();
+        let key = spawn(async move {
+            s.fetch_add(1, Ordering::Relaxed);
+            next_frame().await;
+            s.fetch_add(1, Ordering::Relaxed);
+            let value = run_blocking(|| 40 + 2).await.unwrap();
+            s.fetch_add(value, Ordering::Relaxed);
+        });
+
+        // Spawned tasks wait for the next frame
+        assert_eq!(steps.load(Ordering::Relaxed), 0);
+
+        process_async_tasks();
+        assert_eq!(steps.load(Ordering::Relaxed), 1);
+
+        // Poll until the background thread wakes the task (other tests
+        // may share the executor, so only this task's effects are checked)
+        let start = std::time::Instant::now();
+        while steps.load(Ordering::Relaxed) != 44 {
+            assert!(start.elapsed() < std::time::Duration::from_secs(5));
+            process_async_tasks();
+            std::thread::yield_now();
+        }
+        assert!(!cancel_async_task(key));
+    }
+
+    #[test]
+    fn test_panics_are_contained() {
+        let _serial = EXECUTOR_TEST.lock();
+        let message = Arc::new(Mutex::new(None));
+
+        let seen = message.clone();
+        let waiter = spawn(async move {
+            let result = run_blocking(|| -> usize { panic!("query failed") }).await;
+            *seen.lock() = Some(result.unwrap_err().message().to_string());
+        });
+        let panicking = spawn(async {
+            next_frame().await;
+            panic!("handler bug");
+        });
+
+        let start = std::time::Instant::now();
+        while message.lock().is_none() {
+            assert!(start.elapsed() < std::time::Duration::from_secs(5));
+            process_async_tasks();
+            std::thread::yield_now();
+        }
+        assert_eq!(message.lock().as_deref(), Some("query failed"));
+        assert!(!cancel_async_task(waiter));
+        assert!(!cancel_async_task(panicking));
+    }
+
+    #[test]
+    fn test_shutdown() {
+        let _serial = EXECUTOR_TEST.lock();
+        let dropped = Arc::new(AtomicUsize::new(0));
+
+        struct CountDrop(Arc<AtomicUsize>);
+        impl Drop for CountDrop {
+            fn drop(&mut self) {
+                self.0.fetch_add(1, Ordering::Relaxed);
+            }
+        }
+
+        // More blocking calls than threads all resolve
+        let results = Arc::new(AtomicUsize::new(0));
+        for i in 0..BLOCKING_THREADS * 4 {
+            let results = results.clone();
+            spawn(async move {
+                let value = run_blocking(move || i + 1).await.unwrap();
+                results.fetch_add(value, Ordering::Relaxed);
+            });
+        }
+        let expected: usize = (1..=BLOCKING_THREADS * 4).sum();
+        let start = std::time::Instant::now();
+        while results.load(Ordering::Relaxed) != expected {
+            assert!(start.elapsed() < std::time::Duration::from_secs(5));
+            process_async_tasks();
+            std::thread::yield_now();
+        }
+
+        // Pending tasks are dropped without being polled
+        for _ in 0..3 {
+            let guard = CountDrop(dropped.clone());
+            spawn(async move {
+                let _guard = guard;
+                std::future::pending::<()>().await;
+            });
+        }
+        process_async_tasks();
+        shutdown_executor();
+        assert_eq!(dropped.load(Ordering::Relaxed), 3);
+        assert_eq!(async_task_count(), 0);
+        assert!(BLOCKING_POOL.lock().is_none());
+        assert_eq!(process_async_tasks(), 0);
+    }
+}
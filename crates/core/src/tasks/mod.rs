@@ -1,8 +1,17 @@
 //! Task queue system for main thread execution
 //!
 //! Allows background threads to queue work to execute on the main game thread.
-//! Tasks are processed each frame in the GameFrame hook.
+//! Tasks are processed each frame in the GameFrame hook, and so are async
+//! tasks spawned on the [`executor`].
 
+pub mod executor;
 pub mod queue;
+mod task;
 
+pub use executor::{
+    async_task_count, cancel_all_async_tasks, cancel_async_task, next_frame, process_async_tasks,
+    run_blocking, shutdown_executor, spawn, AsyncTaskKey, Blocking, BlockingPanic, NextFrame,
+    BLOCKING_THREADS,
+};
 pub use queue::*;
+pub use task::{Task, INLINE_TASK_ALIGN, INLINE_TASK_SIZE};
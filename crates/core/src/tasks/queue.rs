@@ -2,12 +2,15 @@
 //!
 //! Allows background threads to queue work to execute on the main game thread.
 //! Tasks are processed each frame in GameFrame hook.
+//!
+//! The queue is a bounded channel whose slots are preallocated up front, and
+//! each slot holds a [`Task`] with inline closure storage. Queueing a small
+//! closure therefore performs no heap allocation.
 
 use crossbeam_channel::{bounded, Receiver, Sender, TrySendError};
 use std::sync::LazyLock;
 
-/// A task to execute on the main thread
-pub type Task = Box<dyn FnOnce() + Send + 'static>;
+use super::task::Task;
 
 /// Capacity of the task queue per frame
 const QUEUE_CAPACITY: usize = 1024;
@@ -30,12 +33,11 @@ static TASK_QUEUE: LazyLock<TaskQueue> = LazyLock::new(|| {
 /// # Returns
 /// - `Ok(())` if the task was queued
 /// - `Err(())` if the queue is full (task is dropped)
-#[tracing::instrument(skip(task))]
 pub fn queue_task<F>(task: F) -> Result<(), ()>
 where
     F: FnOnce() + Send + 'static,
 {
-    match TASK_QUEUE.sender.try_send(Box::new(task)) {
+    match TASK_QUEUE.sender.try_send(Task::new(task)) {
         Ok(()) => Ok(()),
         Err(TrySendError::Full(_)) => {
             tracing::warn!("Task queue full, dropping task");
@@ -53,12 +55,11 @@ where
 /// # Warning
 /// Only call from background threads, never from the main thread
 /// (would deadlock if queue is full and waiting for frame to process)
-#[tracing::instrument(skip(task))]
 pub fn queue_task_blocking<F>(task: F)
 where
     F: FnOnce() + Send + 'static,
 {
-    if let Err(e) = TASK_QUEUE.sender.send(Box::new(task)) {
+    if let Err(e) = TASK_QUEUE.sender.send(Task::new(task)) {
         tracing::error!("Failed to queue task (blocking): {}", e);
     }
 }
@@ -67,13 +68,14 @@ where
 ///
 /// Called from GameFrame hook on the main thread.
 /// Returns the number of tasks processed.
-#[tracing::instrument]
 pub fn process_queued_tasks() -> usize {
     let mut count = 0;
 
     // Process up to QUEUE_CAPACITY tasks per frame
     while let Ok(task) = TASK_QUEUE.receiver.try_recv() {
-        task();
+        let profile = task.profile();
+        let _scope = profile.scope();
+        task.run();
         count += 1;
 
         if count >= QUEUE_CAPACITY {
@@ -0,0 +1,229 @@
+//! Type-erased main thread task with inline closure storage
+//!
+//! Small closures are stored directly inside the `Task` so queueing them
+//! does not allocate. Closures that don't fit fall back to a single `Box`.
+
+use std::marker::PhantomData;
+use std::mem::{self, ManuallyDrop, MaybeUninit};
+use std::ptr;
+
+use crate::profiler::{self, ProfileHandle};
+
+/// Maximum closure capture size (in bytes) stored inline without boxing
+pub const INLINE_TASK_SIZE: usize = 48;
+
+/// Maximum closure alignment stored inline without boxing
+pub const INLINE_TASK_ALIGN: usize = 16;
+
+/// Raw inline storage for a closure
+#[repr(C, align(16))]
+struct InlineStorage(MaybeUninit<[u8; INLINE_TASK_SIZE]>);
+
+impl InlineStorage {
+    fn as_mut_ptr(&mut self) -> *mut u8 {
+        self.0.as_mut_ptr() as *mut u8
+    }
+}
+
+/// Function table for a concrete closure type
+struct TaskVTable {
+    /// Move the closure out of storage and call it
+    call: unsafe fn(*mut u8),
+    /// Drop the closure in storage without calling it
+    drop: unsafe fn(*mut u8),
+    /// Type name of the closure, for diagnostics and profiling
+    name: fn() -> &'static str,
+    /// Whether the closure lives inline (false = boxed)
+    inline: bool,
+}
+
+/// Vtable provider for closures stored inline
+struct Inline<F>(PhantomData<F>);
+
+impl<F: FnOnce()> Inline<F> {
+    const VTABLE: TaskVTable = TaskVTable {
+        call: Self::call,
+        drop: Self::drop,
+        name: std::any::type_name::<F>,
+        inline: true,
+    };
+
+    unsafe fn call(storage: *mut u8) {
+        let f = ptr::read(storage as *mut F);
+        f();
+    }
+
+    unsafe fn drop(storage: *mut u8) {
+        ptr::drop_in_place(storage as *mut F);
+    }
+}
+
+/// Vtable provider for closures too large for inline storage
+struct Boxed<F>(PhantomData<F>);
+
+impl<F: FnOnce()> Boxed<F> {
+    const VTABLE: TaskVTable = TaskVTable {
+        call: Self::call,
+        drop: Self::drop,
+        name: std::any::type_name::<F>,
+        inline: false,
+    };
+
+    unsafe fn call(storage: *mut u8) {
+        let f = Box::from_raw(ptr::read(storage as *mut *mut F));
+        f();
+    }
+
+    unsafe fn drop(storage: *mut u8) {
+        drop(Box::from_raw(ptr::read(storage as *mut *mut F)));
+    }
+}
+
+/// A task to execute on the main thread
+///
+/// Closures up to [`INLINE_TASK_SIZE`] bytes (and [`INLINE_TASK_ALIGN`] alignment)
+/// are stored inline. Larger captures are boxed.
+pub struct Task {
+    storage: InlineStorage,
+    vtable: &'static TaskVTable,
+    /// Profile entry for the closure type, resolved when the task is created
+    profile: ProfileHandle,
+}
+
+// SAFETY: Task can only be constructed from closures that are Send
+unsafe impl Send for Task {}
+
+impl Task {
+    /// Create a new task from a closure
+    pub fn new<F>(f: F) -> Self
+    where
+        F: FnOnce() + Send + 'static,
+    {
+        let mut storage = InlineStorage(MaybeUninit::uninit());
+        let profile = profiler::task_profile::<F>();
+
+        if Self::fits_inline::<F>() {
+            // SAFETY: storage is large and aligned enough for F
+            unsafe { ptr::write(storage.as_mut_ptr() as *mut F, f) };
+            Self {
+                storage,
+                vtable: &Inline::<F>::VTABLE,
+                profile,
+            }
+        } else {
+            let boxed = Box::into_raw(Box::new(f));
+            // SAFETY: a thin pointer always fits in inline storage
+            unsafe { ptr::write(storage.as_mut_ptr() as *mut *mut F, boxed) };
+            Self {
+                storage,
+                vtable: &Boxed::<F>::VTABLE,
+                profile,
+            }
+        }
+    }
+
+    /// Check whether a closure type is stored inline
+    pub const fn fits_inline<F>() -> bool {
+        mem::size_of::<F>() <= INLINE_TASK_SIZE && mem::align_of::<F>() <= INLINE_TASK_ALIGN
+    }
+
+    /// Returns true if this task's closure is stored inline (no allocation)
+    pub fn is_inline(&self) -> bool {
+        self.vtable.inline
+    }
+
+    /// Type name of the task's closure
+    pub fn name(&self) -> &'static str {
+        (self.vtable.name)()
+    }
+
+    /// Profile entry for the task's closure type
+    pub(crate) fn profile(&self) -> ProfileHandle {
+        self.profile
+    }
+
+    /// Consume the task and run its closure
+    pub fn run(self) {
+        let mut this = ManuallyDrop::new(self);
+        // SAFETY: storage holds a live closure of the vtable's type; ManuallyDrop
+        // prevents the Drop impl from dropping it a second time.
+        unsafe { (this.vtable.call)(this.storage.as_mut_ptr()) }
+    }
+}
+
+impl Drop for Task {
+    fn drop(&mut self) {
+        // SAFETY: storage holds a live closure that has not been called
+        unsafe { (self.vtable.drop)(self.storage.as_mut_ptr()) }
+    }
+}
+
+impl<F> From<F> for Task
+where
+    F: FnOnce() + Send + 'static,
+{
+    fn from(f: F) -> Self {
+        Task::new(f)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::sync::Arc;
+
+    #[test]
+    fn test_small_closure_is_inline() {
+        let counter = Arc::new(AtomicUsize::new(0));
+        let c = counter.clone();
+        let task = Task::new(move || {
+            c.fetch_add(1, Ordering::Relaxed);
+        });
+
+        assert!(task.is_inline());
+        task.run();
+        assert_eq!(counter.load(Ordering::Relaxed), 1);
+    }
+
+    #[test]
+    fn test_large_closure_is_boxed() {
+        let counter = Arc::new(AtomicUsize::new(0));
+        let c = counter.clone();
+        let payload = [7u8; 128];
+        let task = Task::new(move || {
+            c.fetch_add(payload[0] as usize, Ordering::Relaxed);
+        });
+
+        assert!(!task.is_inline());
+        task.run();
+        assert_eq!(counter.load(Ordering::Relaxed), 7);
+    }
+
+    #[test]
+    fn test_drop_without_run_releases_captures() {
+        let shared = Arc::new(());
+
+        let inline = {
+            let s = shared.clone();
+            Task::new(move || drop(s))
+        };
+        let boxed = {
+            let s = shared.clone();
+            let payload = [0u8; 128];
+            Task::new(move || drop((s, payload)))
+        };
+        assert_eq!(Arc::strong_count(&shared), 3);
+
+        drop(inline);
+        drop(boxed);
+        assert_eq!(Arc::strong_count(&shared), 1);
+    }
+
+    #[test]
+    fn test_fits_inline() {
+        assert!(Task::fits_inline::<[u8; INLINE_TASK_SIZE]>());
+        assert!(!Task::fits_inline::<[u8; INLINE_TASK_SIZE + 1]>());
+        assert!(mem::size_of::<Task>() <= INLINE_TASK_SIZE + 16);
+    }
+}
@@ -136,6 +136,7 @@ pub(crate) fn process() {
             if now >= timer.next_fire {
                 // Execute the callback
                 let mut callback = timer.callback.lock();
+                let _scope = timer.profile.scope();
                 (*callback)();
 
                 // Mark one-shot timers for removal
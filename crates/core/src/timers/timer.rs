@@ -6,6 +6,8 @@ use bitflags::bitflags;
 use parking_lot::Mutex;
 use slotmap::new_key_type;
 
+use crate::profiler::{ProfileHandle, ProfileKind};
+
 new_key_type! {
     /// Key for registered timers
     pub struct TimerKey;
@@ -32,6 +34,8 @@ pub(crate) struct Timer {
     pub flags: TimerFlags,
     /// When this timer should next fire
     pub next_fire: Instant,
+    /// Profile entry for the callback
+    pub profile: ProfileHandle,
 }
 
 impl Timer {
@@ -45,6 +49,7 @@ impl Timer {
             callback: Mutex::new(Box::new(callback)),
             flags,
             next_fire: Instant::now() + interval,
+            profile: ProfileHandle::for_type::<F>(ProfileKind::Timer),
         }
     }
 }
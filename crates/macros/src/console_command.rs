@@ -4,13 +4,14 @@
 
 use proc_macro2::TokenStream;
 use quote::quote;
-use syn::{parse::Parse, parse::ParseStream, Ident, ItemFn, LitStr, Token};
+use syn::{parse::Parse, parse::ParseStream, Ident, ItemFn, Lit, LitStr, Token};
 
 /// Arguments to the console_command attribute
 ///
 /// Usage:
 /// - `#[console_command("csr_ping", "Respond with pong")]`
 /// - `#[console_command("css_ban", "Ban a player", permission = "@css/ban")]`
+/// - `#[console_command("csr_rtv", "Rock the vote", cooldown = 2.5)]`
 pub struct ConsoleCommandArgs {
     /// Command name (e.g., "csr_ping")
     pub name: LitStr,
@@ -18,6 +19,8 @@ pub struct ConsoleCommandArgs {
     pub description: LitStr,
     /// Required permission (e.g., "@css/ban")
     pub permission: Option<LitStr>,
+    /// Per-player cooldown in seconds (integer or float literal)
+    pub cooldown: Option<Lit>,
 }
 
 impl Parse for ConsoleCommandArgs {
@@ -26,23 +29,37 @@ impl Parse for ConsoleCommandArgs {
         input.parse::<Token![,]>()?;
         let description: LitStr = input.parse()?;
 
-        // Check for optional permission parameter
-        let permission = if input.peek(Token![,]) {
+        // Optional named parameters, in any order
+        let mut permission = None;
+        let mut cooldown = None;
+        while input.peek(Token![,]) {
             input.parse::<Token![,]>()?;
-            let ident: Ident = input.parse()?;
-            if ident != "permission" {
-                return Err(syn::Error::new(ident.span(), "expected `permission`"));
+            if input.is_empty() {
+                break;
             }
+            let ident: Ident = input.parse()?;
             input.parse::<Token![=]>()?;
-            Some(input.parse::<LitStr>()?)
-        } else {
-            None
-        };
+            if ident == "permission" {
+                permission = Some(input.parse::<LitStr>()?);
+            } else if ident == "cooldown" {
+                let lit: Lit = input.parse()?;
+                if !matches!(lit, Lit::Int(_) | Lit::Float(_)) {
+                    return Err(syn::Error::new(lit.span(), "expected a number of seconds"));
+                }
+                cooldown = Some(lit);
+            } else {
+                return Err(syn::Error::new(
+                    ident.span(),
+                    "expected `permission` or `cooldown`",
+                ));
+            }
+        }
 
         Ok(Self {
             name,
             description,
             permission,
+            cooldown,
         })
     }
 }
@@ -75,6 +92,29 @@ pub fn generate_console_command(args: ConsoleCommandArgs, func: ItemFn) -> Token
         None => quote! { None },
     };
 
+    // Commands with a cooldown register with their own rate limit
+    let register_call = match &args.cooldown {
+        Some(secs) => quote! {
+            ::cs2rust_core::commands::register_command_with_rate_limit(
+                #command_name,
+                #command_desc,
+                #permission_arg,
+                ::cs2rust_core::commands::RateLimit::cooldown(
+                    ::std::time::Duration::from_secs_f32(#secs as f32),
+                ),
+                #fn_name,
+            )
+        },
+        None => quote! {
+            ::cs2rust_core::commands::register_command_ex(
+                #command_name,
+                #command_desc,
+                #permission_arg,
+                #fn_name,
+            )
+        },
+    };
+
     quote! {
         // Static storage for the command key
         static #key_static_name: ::std::sync::OnceLock<::cs2rust_core::commands::CommandKey> =
@@ -89,12 +129,7 @@ pub fn generate_console_command(args: ConsoleCommandArgs, func: ItemFn) -> Token
 
         /// Register this command with the command system
         #fn_vis fn #register_fn_name() -> Option<::cs2rust_core::commands::CommandKey> {
-            let key = ::cs2rust_core::commands::register_command_ex(
-                #command_name,
-                #command_desc,
-                #permission_arg,
-                #fn_name,
-            )?;
+            let key = #register_call?;
             let _ = #key_static_name.set(key);
             Some(key)
         }
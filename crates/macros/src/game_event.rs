@@ -0,0 +1,264 @@
+//! GameEvent derive macro implementation
+//!
+//! Generates a `from_raw` that reads each field through a compile-time
+//! `GameEventKey`, so decoding an event builds no key strings at runtime,
+//! a `FIELDS` list of the keys it reads, and a `<Struct>View` that reads
+//! fields lazily.
+
+use proc_macro2::TokenStream;
+use quote::{format_ident, quote};
+use syn::ext::IdentExt;
+use syn::{Data, DeriveInput, Expr, Fields, LitByteStr, LitStr};
+
+/// Parsed `#[game_event(...)]` attributes on a field
+struct EventFieldArgs {
+    /// Event key (defaults to the field name)
+    key: Option<LitStr>,
+    /// Value used when the key is missing
+    default: Option<Expr>,
+}
+
+/// Generate the GameEvent implementation
+pub fn derive_game_event(input: DeriveInput) -> TokenStream {
+    match generate_impl(&input) {
+        Ok(tokens) => tokens,
+        Err(e) => e.to_compile_error(),
+    }
+}
+
+fn parse_event_name(input: &DeriveInput) -> syn::Result<LitStr> {
+    let mut name = None;
+    for attr in input
+        .attrs
+        .iter()
+        .filter(|a| a.path().is_ident("game_event"))
+    {
+        attr.parse_nested_meta(|meta| {
+            if meta.path.is_ident("name") {
+                name = Some(meta.value()?.parse::<LitStr>()?);
+                Ok(())
+            } else {
+                Err(meta.error("expected `name`"))
+            }
+        })?;
+    }
+
+    name.ok_or_else(|| {
+        syn::Error::new_spanned(
+            &input.ident,
+            "missing #[game_event(name = \"...\")] attribute",
+        )
+    })
+}
+
+fn parse_field_args(field: &syn::Field) -> syn::Result<EventFieldArgs> {
+    let mut args = EventFieldArgs {
+        key: None,
+        default: None,
+    };
+    for attr in field
+        .attrs
+        .iter()
+        .filter(|a| a.path().is_ident("game_event"))
+    {
+        attr.parse_nested_meta(|meta| {
+            if meta.path.is_ident("key") {
+                args.key = Some(meta.value()?.parse::<LitStr>()?);
+                Ok(())
+            } else if meta.path.is_ident("default") {
+                args.default = Some(meta.value()?.parse::<Expr>()?);
+                Ok(())
+            } else {
+                Err(meta.error("expected `key` or `default`"))
+            }
+        })?;
+    }
+    Ok(args)
+}
+
+fn generate_impl(input: &DeriveInput) -> syn::Result<TokenStream> {
+    let struct_name = &input.ident;
+    let event_name = parse_event_name(input)?;
+
+    let fields: Vec<&syn::Field> = match &input.data {
+        Data::Struct(data) => match &data.fields {
+            Fields::Unit => Vec::new(),
+            Fields::Named(named) => named.named.iter().collect(),
+            Fields::Unnamed(_) => {
+                return Err(syn::Error::new_spanned(
+                    struct_name,
+                    "GameEvent requires named fields",
+                ))
+            }
+        },
+        _ => {
+            return Err(syn::Error::new_spanned(
+                struct_name,
+                "GameEvent can only be derived for structs",
+            ))
+        }
+    };
+
+    // `Self {}` also constructs unit structs
+    let readers = fields
+        .iter()
+        .map(|field| {
+            let field_ident = &field.ident;
+            let read = generate_field_read(field, quote! { event })?;
+            Ok(quote! { #field_ident: #read, })
+        })
+        .collect::<syn::Result<Vec<_>>>()?;
+
+    let descriptors = fields
+        .iter()
+        .map(|field| {
+            let field_ty = &field.ty;
+            let key = field_key(field, &parse_field_args(field)?)?;
+            Ok(quote! {
+                ::cs2rust_core::events::EventField {
+                    name: #key,
+                    kind: <#field_ty as ::cs2rust_core::events::EventValue>::KIND,
+                },
+            })
+        })
+        .collect::<syn::Result<Vec<_>>>()?;
+
+    let (impl_generics, ty_generics, where_clause) = input.generics.split_for_impl();
+
+    // Lazy views are only generated for non-generic events
+    let view = if input.generics.params.is_empty() {
+        generate_view(input, &fields)?
+    } else {
+        TokenStream::new()
+    };
+
+    Ok(quote! {
+        impl #impl_generics ::cs2rust_core::events::GameEvent for #struct_name #ty_generics #where_clause {
+            const NAME: &'static str = #event_name;
+
+            const FIELDS: &'static [::cs2rust_core::events::EventField] = &[#(#descriptors)*];
+
+            #[allow(unused_variables)]
+            fn from_raw(event: &::cs2rust_core::events::GameEventRef) -> Self {
+                Self { #(#readers)* }
+            }
+        }
+
+        #view
+    })
+}
+
+/// Generate `<Struct>View`, a lazy view that reads and memoizes one field
+/// per accessor call
+fn generate_view(input: &DeriveInput, fields: &[&syn::Field]) -> syn::Result<TokenStream> {
+    let struct_name = &input.ident;
+    let vis = &input.vis;
+    let view_name = format_ident!("{}View", struct_name);
+    let view_doc = format!(
+        "Lazy view of [`{}`] that reads each field on first access",
+        struct_name
+    );
+
+    let cells = fields.iter().map(|field| {
+        let field_ident = &field.ident;
+        let field_ty = &field.ty;
+        quote! { #field_ident: ::std::cell::OnceCell<#field_ty>, }
+    });
+
+    let inits = fields.iter().map(|field| {
+        let field_ident = &field.ident;
+        quote! { #field_ident: ::std::cell::OnceCell::new(), }
+    });
+
+    let accessors = fields
+        .iter()
+        .map(|field| {
+            let field_ident = &field.ident;
+            let field_ty = &field.ty;
+            let docs = field.attrs.iter().filter(|a| a.path().is_ident("doc"));
+            let read = generate_field_read(field, quote! { self.event })?;
+            Ok(quote! {
+                #(#docs)*
+                pub fn #field_ident(&self) -> <#field_ty as ::cs2rust_core::events::EventValue>::Output<'_> {
+                    ::cs2rust_core::events::EventValue::as_output(
+                        self.#field_ident.get_or_init(|| #read),
+                    )
+                }
+            })
+        })
+        .collect::<syn::Result<Vec<_>>>()?;
+
+    Ok(quote! {
+        #[doc = #view_doc]
+        #vis struct #view_name<'a> {
+            event: &'a ::cs2rust_core::events::GameEventRef,
+            #(#cells)*
+        }
+
+        impl<'a> #view_name<'a> {
+            /// Create a view over a raw event
+            pub fn new(event: &'a ::cs2rust_core::events::GameEventRef) -> Self {
+                Self {
+                    event,
+                    #(#inits)*
+                }
+            }
+
+            /// The underlying raw event
+            pub fn event(&self) -> &'a ::cs2rust_core::events::GameEventRef {
+                self.event
+            }
+
+            #(#accessors)*
+        }
+
+        impl ::cs2rust_core::events::LazyGameEvent for #struct_name {
+            type View<'a> = #view_name<'a>;
+
+            fn view(event: &::cs2rust_core::events::GameEventRef) -> Self::View<'_> {
+                #view_name::new(event)
+            }
+        }
+    })
+}
+
+/// Event key of a field (its `key` attribute or its name)
+fn field_key(field: &syn::Field, args: &EventFieldArgs) -> syn::Result<String> {
+    let field_ident = field.ident.as_ref().unwrap();
+    let key = args
+        .key
+        .as_ref()
+        .map(|k| k.value())
+        .unwrap_or_else(|| field_ident.unraw().to_string());
+    if key.contains('\0') {
+        return Err(syn::Error::new_spanned(
+            field_ident,
+            "event key contains a NUL byte",
+        ));
+    }
+    Ok(key)
+}
+
+/// Generate an expression reading one field from `event`
+fn generate_field_read(field: &syn::Field, event: TokenStream) -> syn::Result<TokenStream> {
+    let args = parse_field_args(field)?;
+    let field_ident = field.ident.as_ref().unwrap();
+    let field_ty = &field.ty;
+
+    let mut key_bytes = field_key(field, &args)?.into_bytes();
+    key_bytes.push(0);
+    let key_lit = LitByteStr::new(&key_bytes, field_ident.span());
+
+    let default = match args.default {
+        Some(expr) => quote! { #expr },
+        None => quote! { <#field_ty as ::cs2rust_core::events::EventValue>::DEFAULT },
+    };
+
+    Ok(quote! {
+        {
+            const KEY: ::cs2rust_core::events::GameEventKey =
+                ::cs2rust_core::events::GameEventKey::from_bytes_with_nul(#key_lit);
+            <#field_ty as ::cs2rust_core::events::EventValue>::read(#event, &KEY, #default)
+        }
+    })
+}
@@ -4,6 +4,7 @@
 //!
 //! - `#[derive(SchemaClass)]` - Generate type-safe schema field accessors
 //! - `#[console_command]` - Register console/chat commands
+//! - `#[derive(GameEvent)]` - Decode typed game events without allocating keys
 //!
 //! # SchemaClass Example
 //!
@@ -69,6 +70,7 @@
 //! - `#[schema(entity)]` - Field is an entity handle (future use).
 
 mod console_command;
+mod game_event;
 mod parse;
 mod schema_class;
 
@@ -132,6 +134,7 @@ pub fn derive_schema_class(input: TokenStream) -> TokenStream {
 /// - First argument: Command name (e.g., `"csr_ping"`)
 /// - Second argument: Command description (e.g., `"Respond with pong"`)
 /// - Optional: `permission = "@domain/flag"` - Required permission to run the command
+/// - Optional: `cooldown = 2.5` - Seconds a player must wait between uses
 ///
 /// # Example
 ///
@@ -153,6 +156,12 @@ pub fn derive_schema_class(input: TokenStream) -> TokenStream {
 ///     CommandResult::Handled
 /// }
 ///
+/// // With a per-player cooldown:
+/// #[console_command("csr_rtv", "Rock the vote", cooldown = 5)]
+/// fn cmd_rtv(player: Option<&PlayerController>, info: &CommandInfo) -> CommandResult {
+///     CommandResult::Handled
+/// }
+///
 /// // Later, register the command:
 /// cmd_ping_register();
 ///
@@ -174,3 +183,38 @@ pub fn console_command(attr: TokenStream, item: TokenStream) -> TokenStream {
     let func = parse_macro_input!(item as ItemFn);
     console_command::generate_console_command(args, func).into()
 }
+
+/// Derive macro for typed game events
+///
+/// Implements `GameEvent` with a `from_raw` that reads every field through a
+/// `GameEventKey` built at compile time, so decoding allocates no key
+/// strings, and lists those keys in `GameEvent::FIELDS`. Field types must
+/// implement `EventValue` (`bool`, `i32`, `u64`, `f32` or `String`).
+///
+/// # Example
+///
+/// ```ignore
+/// use cs2rust_core::events::GameEvent;
+///
+/// #[derive(Debug, Clone, GameEvent)]
+/// #[game_event(name = "player_hurt")]
+/// pub struct EventPlayerHurt {
+///     #[game_event(default = -1)]
+///     pub userid: i32,
+///     pub weapon: String,
+///     #[game_event(key = "dmg_health")]
+///     pub damage: i32,
+/// }
+/// ```
+///
+/// # Attributes
+///
+/// - `#[game_event(name = "event_name")]` - **Required.** The engine event name.
+/// - `#[game_event(key = "key")]` - Event key for a field (default: the field name).
+/// - `#[game_event(default = expr)]` - Value when the key is missing
+///   (default: `0`, `false`, `0.0` or `""`).
+#[proc_macro_derive(GameEvent, attributes(game_event))]
+pub fn derive_game_event(input: TokenStream) -> TokenStream {
+    let input = parse_macro_input!(input as DeriveInput);
+    game_event::derive_game_event(input).into()
+}
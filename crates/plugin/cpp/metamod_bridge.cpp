@@ -14,6 +14,7 @@ PLUGIN_EXPOSE(CS2RustPlugin, g_CS2RustPlugin);
 
 // SourceHook declarations for IServerGameDLL
 SH_DECL_HOOK3_void(IServerGameDLL, GameFrame, SH_NOATTRIB, 0, bool, bool, bool);
+SH_DECL_HOOK1_void(IServerGameDLL, PreWorldUpdate, SH_NOATTRIB, 0, bool);
 SH_DECL_HOOK3_void(IServerGameDLL, ServerActivate, SH_NOATTRIB, 0, void*, int, int);
 SH_DECL_HOOK0_void(IServerGameDLL, GameShutdown, SH_NOATTRIB, 0);
 
@@ -74,7 +75,9 @@ bool CS2RustPlugin::Load(PluginId id, ISmmAPI* ismm, char* error, size_t maxlen,
     }
 
     // Install IServerGameDLL hooks
+    SH_ADD_HOOK_MEMFUNC(IServerGameDLL, GameFrame, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_GameFramePre, false);
     SH_ADD_HOOK_MEMFUNC(IServerGameDLL, GameFrame, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_GameFrame, true);
+    SH_ADD_HOOK_MEMFUNC(IServerGameDLL, PreWorldUpdate, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_PreWorldUpdate, false);
     SH_ADD_HOOK_MEMFUNC(IServerGameDLL, ServerActivate, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_ServerActivate, true);
     SH_ADD_HOOK_MEMFUNC(IServerGameDLL, GameShutdown, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_GameShutdown, false);
 
@@ -95,7 +98,9 @@ bool CS2RustPlugin::Load(PluginId id, ISmmAPI* ismm, char* error, size_t maxlen,
 bool CS2RustPlugin::Unload(char* error, size_t maxlen)
 {
     // Remove IServerGameDLL hooks
+    SH_REMOVE_HOOK_MEMFUNC(IServerGameDLL, GameFrame, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_GameFramePre, false);
     SH_REMOVE_HOOK_MEMFUNC(IServerGameDLL, GameFrame, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_GameFrame, true);
+    SH_REMOVE_HOOK_MEMFUNC(IServerGameDLL, PreWorldUpdate, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_PreWorldUpdate, false);
     SH_REMOVE_HOOK_MEMFUNC(IServerGameDLL, ServerActivate, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_ServerActivate, true);
     SH_REMOVE_HOOK_MEMFUNC(IServerGameDLL, GameShutdown, g_pServerGameDLL, &g_CS2RustPlugin, &CS2RustPlugin::Hook_GameShutdown, false);
 
@@ -166,12 +171,24 @@ const char* CS2RustPlugin::GetLogTag()
 
 // === Hook callback implementations ===
 
+void CS2RustPlugin::Hook_GameFramePre(bool simulating, bool bFirstTick, bool bLastTick)
+{
+    rust_on_game_frame_pre(simulating, bFirstTick, bLastTick);
+    RETURN_META(MRES_IGNORED);
+}
+
 void CS2RustPlugin::Hook_GameFrame(bool simulating, bool bFirstTick, bool bLastTick)
 {
     rust_on_game_frame(simulating, bFirstTick, bLastTick);
     RETURN_META(MRES_IGNORED);
 }
 
+void CS2RustPlugin::Hook_PreWorldUpdate(bool simulating)
+{
+    rust_on_pre_world_update(simulating);
+    RETURN_META(MRES_IGNORED);
+}
+
 void CS2RustPlugin::Hook_ServerActivate(void* pEdictList, int edictCount, int clientMax)
 {
     // Get map name from globals or use a placeholder
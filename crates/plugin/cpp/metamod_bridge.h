@@ -39,12 +39,12 @@ public:
     virtual void SetGlobals(void*) = 0;                  // 12
     virtual void GameCreateNetworkStringTables() = 0;    // 13
     virtual void WriteSignonMessages(void*) = 0;         // 14
-    virtual void PreWorldUpdate(bool) = 0;               // 15
+    virtual void PreWorldUpdate(bool simulating) = 0;    // 15
     virtual void* GetEntity2Networkables() = 0;          // 16
     virtual void* GetEntityInfo() = 0;                   // 17
     virtual void ApplyGameSettings(void*) = 0;           // 18
 
-    // The method we're hooking - must be at vtable index 19
+    // GameFrame is hooked pre and post - must be at vtable index 19
     virtual void GameFrame(bool simulating, bool bFirstTick, bool bLastTick) = 0;  // 19
 
     // Additional methods for ServerActivate hook
@@ -129,7 +129,9 @@ bool rust_plugin_load(
 );
 bool rust_plugin_unload(char* error, size_t maxlen);
 
-// GameFrame callback
+// Frame phase callbacks
+void rust_on_game_frame_pre(bool simulating, bool first_tick, bool last_tick);
+void rust_on_pre_world_update(bool simulating);
 void rust_on_game_frame(bool simulating, bool first_tick, bool last_tick);
 
 // Listener callbacks
@@ -176,7 +178,9 @@ public:
 
 public:
     // Hook callbacks (called by SourceHook)
+    void Hook_GameFramePre(bool simulating, bool bFirstTick, bool bLastTick);
     void Hook_GameFrame(bool simulating, bool bFirstTick, bool bLastTick);
+    void Hook_PreWorldUpdate(bool simulating);
     void Hook_ServerActivate(void* pEdictList, int edictCount, int clientMax);
     void Hook_GameShutdown();
     bool Hook_ClientConnect(CPlayerSlot slot, const char* pszName, uint64_t xuid,
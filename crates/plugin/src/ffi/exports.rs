@@ -4,7 +4,7 @@ use std::ffi::{c_char, c_int, c_void};
 
 use tracing::instrument;
 
-use cs2rust_core::hooks;
+use cs2rust_core::{hooks, CoreConfig};
 use cs2rust_engine::{init_engine, load_interfaces};
 use cs2rust_sdk::{CreateInterfaceFn, ISmmAPI};
 
@@ -35,10 +35,13 @@ pub unsafe extern "C" fn rust_plugin_load(
     maxlen: usize,
     _late: bool,
 ) -> bool {
-    // Initialize tracing subscriber
-    let _ = tracing_subscriber::fmt()
-        .with_max_level(tracing::Level::DEBUG)
-        .try_init();
+    // Install logging with the default filter first so problems reading
+    // core.toml are logged, then switch to the configured filter
+    cs2rust_core::logging::init(&CoreConfig::default());
+    match CoreConfig::load() {
+        Ok(config) => cs2rust_core::logging::apply_config(&config),
+        Err(e) => tracing::warn!("Failed to load core config, using defaults: {}", e),
+    }
 
     tracing::info!("CS2Rust loading...");
 
@@ -139,9 +142,20 @@ pub extern "C" fn rust_get_log_tag() -> *const c_char {
     LOG_TAG.as_ptr() as *const c_char
 }
 
-/// Called from C++ SourceHook every server tick
+/// Called from C++ SourceHook every server tick before simulation (GameFrame pre-hook)
+#[no_mangle]
+pub extern "C" fn rust_on_game_frame_pre(simulating: bool, first_tick: bool, last_tick: bool) {
+    hooks::on_game_frame_pre(simulating, first_tick, last_tick);
+}
+
+/// Called from C++ SourceHook every server tick before the world update (PreWorldUpdate hook)
+#[no_mangle]
+pub extern "C" fn rust_on_pre_world_update(simulating: bool) {
+    hooks::on_pre_world_update(simulating);
+}
+
+/// Called from C++ SourceHook every server tick after simulation (GameFrame post-hook)
 #[no_mangle]
-#[instrument(skip_all)]
 pub extern "C" fn rust_on_game_frame(simulating: bool, first_tick: bool, last_tick: bool) {
     hooks::on_game_frame(simulating, first_tick, last_tick);
     // Also fire OnTick listeners
@@ -8,6 +8,7 @@
 //! - `on_client_disconnect` - Called when a client disconnects
 //! - `get_player_controller` - Access player information by slot
 //! - `PlayerController` properties (name, steam_id)
+//! - `intern_template` - Compile a colored chat message once, print it many times
 //!
 //! ## Usage
 //! ```ignore
@@ -18,12 +19,20 @@ use cs2rust_core::{
     on_client_connect, on_client_disconnect, on_client_put_in_server,
     ListenerKey,
 };
+use cs2rust_core::commands::{intern_template, HudDestination};
 use cs2rust_core::entities::get_player_controller;
 
 /// Initialize the Player Greeter plugin.
 ///
 /// Registers listeners for all client lifecycle events.
 pub fn init() {
+    // Parsed once here; printing only fills in the name
+    let welcome = intern_template(
+        "{green}[Server]{default} Welcome, {gold}{name}{default}!",
+        &["name"],
+    )
+    .expect("welcome template is valid");
+
     // Called when a client initiates a connection
     // Parameters: slot (0-63), name, ip address
     let _connect_key: ListenerKey = on_client_connect(|slot, name, ip| {
@@ -37,7 +46,7 @@ pub fn init() {
 
     // Called when a client fully enters the game
     // At this point, the PlayerController is fully initialized
-    let _put_in_server_key: ListenerKey = on_client_put_in_server(|slot| {
+    let _put_in_server_key: ListenerKey = on_client_put_in_server(move |slot| {
         // Get the player controller to access detailed information
         if let Some(controller) = get_player_controller(slot) {
             let name = controller.name_string();
@@ -47,8 +56,8 @@ pub fn init() {
             tracing::info!("  SteamID64: {}", steam_id);
             tracing::info!("  Slot: {}", slot);
 
-            // You could broadcast a welcome message to all players here
-            // using the game's chat system (if implemented)
+            // Broadcast the welcome, sent with other prints at the end of the frame
+            welcome.queue_all(HudDestination::Talk, &[&name]);
         } else {
             tracing::warn!("Player entered server at slot {} but controller not found", slot);
         }
@@ -9,6 +9,7 @@
 //! - `TimerFlags` - Control timer behavior (REPEAT, STOP_ON_MAPCHANGE)
 //! - `remove_timer` - Cancel a timer
 //! - `on_map_start` - Initialize timers when map loads
+//! - `intern_template` / `queue_print_all` - Colored, batched broadcasts
 //!
 //! ## Timer Types
 //! - One-shot: Fires once after delay
@@ -24,13 +25,27 @@
 //! ```
 
 use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, LazyLock};
 use std::time::Duration;
 
+use cs2rust_core::commands::{intern_template, HudDestination, MessageTemplate};
 use cs2rust_core::{
     add_timer, add_timer_with_flags, remove_timer,
     on_map_start, TimerFlags, TimerKey,
 };
 
+/// Chat prefix for every announcement, compiled once
+static ANNOUNCEMENT: LazyLock<Arc<MessageTemplate>> = LazyLock::new(|| {
+    intern_template("{green}[Announcement]{default} {message}", &["message"])
+        .expect("announcement template is valid")
+});
+
+/// Broadcast an announcement to every player's chat
+fn announce(message: &str) {
+    tracing::info!("[Announcement] {}", message);
+    ANNOUNCEMENT.queue_all(HudDestination::Talk, &[&message]);
+}
+
 /// Default announcement messages
 const DEFAULT_MESSAGES: &[&str] = &[
     "Welcome to our server! Type !help for commands.",
@@ -55,7 +70,7 @@ pub fn init() {
 
         // One-shot welcome timer (5 seconds after map start)
         let _welcome_timer: TimerKey = add_timer(Duration::from_secs(5), || {
-            tracing::info!("[Announcement] Map is now ready! Have fun!");
+            announce("Map is now ready! Have fun!");
         });
 
         // Repeating announcement timer with auto-cleanup on map change
@@ -68,12 +83,7 @@ pub fn init() {
                 let index = MESSAGE_INDEX.fetch_add(1, Ordering::Relaxed);
                 let message = DEFAULT_MESSAGES[index % DEFAULT_MESSAGES.len()];
 
-                tracing::info!("[Announcement] {}", message);
-
-                // In a real plugin, you would broadcast to all players:
-                // for player in get_players() {
-                //     client_print(player, HudDestination::Talk, message);
-                // }
+                announce(message);
             },
         );
 
@@ -93,7 +103,7 @@ pub fn init() {
 /// A `TimerKey` that can be used to cancel the announcement.
 pub fn schedule_announcement(message: String, delay: Duration) -> TimerKey {
     add_timer(delay, move || {
-        tracing::info!("[Announcement] {}", message);
+        announce(&message);
     })
 }
 
@@ -110,7 +120,7 @@ pub fn schedule_repeating(message: String, interval: Duration) -> TimerKey {
         interval,
         TimerFlags::REPEAT | TimerFlags::STOP_ON_MAPCHANGE,
         move || {
-            tracing::info!("[Announcement] {}", message);
+            announce(&message);
         },
     )
 }
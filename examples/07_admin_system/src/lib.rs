@@ -153,7 +153,7 @@ fn register_kick_command() {
 
             // Get kick reason (all args after player name)
             let reason = if info.arg_count() > 2 {
-                info.args()[2..].join(" ")
+                info.args().skip(2).collect::<Vec<_>>().join(" ")
             } else {
                 "Kicked by admin".to_string()
             };
@@ -8,10 +8,11 @@
 //! - `CHandle<T>` - Safe entity handle resolution
 //! - Entity properties (health, armor, team, name, etc.)
 //! - `get_player_controller` - Access player by slot
+//! - `reply_stream()` - Long command output sent across several frames
 //!
 //! ## Commands
 //!
-//! - `!entities` - List entity counts by class
+//! - `!entities [all]` - List entity counts by class
 //! - `!inspect <slot>` - Inspect a player by slot number
 //! - `!weapons` - List all weapons on the server
 //! - `!myinfo` - Show your own player info
@@ -67,13 +68,24 @@ fn register_entities_command() {
             let mut sorted: Vec<_> = counts.into_iter().collect();
             sorted.sort_by(|a, b| b.1.cmp(&a.1));
 
+            // `!entities all` lists every class; the stream sends it a few
+            // lines per frame instead of all at once
+            if info.arg(1) == "all" {
+                let stream = info.reply_stream();
+                stream.line("All entity classes:");
+                for (classname, count) in &sorted {
+                    stream.line_fmt(format_args!("  {:4} x {}", count, classname));
+                }
+                return CommandResult::Handled;
+            }
+
             info.reply("Top entity classes:");
             for (classname, count) in sorted.iter().take(15) {
                 info.reply(&format!("  {:4} x {}", count, classname));
             }
 
             if sorted.len() > 15 {
-                info.reply(&format!("  ... and {} more types", sorted.len() - 15));
+                info.reply(&format!("  ... and {} more types (!entities all)", sorted.len() - 15));
             }
 
             CommandResult::Handled